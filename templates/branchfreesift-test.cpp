@@ -0,0 +1,147 @@
+/**
+ * \file branchfreesift-test.cpp
+ * \copyright Matthew Calligaro
+ * \date January 2020
+ * \brief An assortment of ad hoc tests for MinHeap built with
+ * MINHEAP_BRANCH_FREE_SIFT
+ * \note These tests are not comprehensive and are NOT a good example of unit
+ * testing
+ * \note The Makefile compiles this file with -DMINHEAP_BRANCH_FREE_SIFT, so
+ * that heap-test can keep testing the default configuration
+ */
+
+#ifndef MINHEAP_BRANCH_FREE_SIFT
+#error "branchfreesift-test must be compiled with -DMINHEAP_BRANCH_FREE_SIFT"
+#endif
+
+#include <algorithm>
+#include <cassert>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include "minheap.hpp"
+
+/**
+ * \struct BranchingInt
+ * \brief An int wrapped in a struct, which MinHeap does not know to be cheap
+ * to compare, so that MinHeap bubbles it down with branches
+ */
+struct BranchingInt {
+  int value;
+
+  BranchingInt(int val) : value{val} {}  // NOLINT(runtime/explicit)
+  bool operator<(const BranchingInt& rhs) const { return value < rhs.value; }
+  bool operator==(const BranchingInt& rhs) const { return value == rhs.value; }
+};
+
+/**
+ * \struct BranchingString
+ * \brief A std::string wrapped in a struct, which has no MinHeapKeyPrefix, so
+ * that MinHeap bubbles it down with branches
+ */
+struct BranchingString {
+  std::string value;
+
+  BranchingString(const std::string& val)  // NOLINT(runtime/explicit)
+      : value{val} {}
+  bool operator<(const BranchingString& rhs) const {
+    return value < rhs.value;
+  }
+  bool operator==(const BranchingString& rhs) const {
+    return value == rhs.value;
+  }
+};
+
+/**
+ * \brief Checks that every element of a MinHeap is no smaller than its parent
+ * \param heap    The heap to check
+ * \return True if heap satisfies the heap property
+ */
+template <typename T, size_t INLINE_CAPACITY>
+bool isValidHeap(const MinHeap<T, INLINE_CAPACITY>& heap) {
+  // The iterator visits array_ in order, so heap.begin()[i - 1] is array_[i]
+  for (size_t i = 2; i <= heap.size(); ++i) {
+    if (heap.begin()[i - 1] < heap.begin()[i / 2 - 1]) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/**
+ * \brief Applies the same random operations to a MinHeap which bubbles down
+ * without branches and one which branches, and checks after each that their
+ * arrays hold the same values in the same order
+ * \param makeValue   Turns a small random number into a value
+ */
+template <typename BranchFree, typename Branching, typename MakeValue>
+void compareSifts(MakeValue makeValue) {
+  // Small values make many ties, which is where the two could disagree
+  std::default_random_engine engine(50);
+  std::vector<BranchFree> values;
+  for (size_t i = 0; i < 500; ++i) {
+    values.push_back(makeValue(engine() % 20));
+  }
+  MinHeap<BranchFree> branchFree(values.begin(), values.end());
+  MinHeap<Branching> branching(values.begin(), values.end());
+
+  for (size_t i = 0; i < 5000; ++i) {
+    if (engine() % 3 == 0 && !branchFree.empty()) {
+      branchFree.deleteMin();
+      branching.deleteMin();
+    } else {
+      BranchFree value = makeValue(engine() % 20);
+      branchFree.insert(value);
+      branching.insert(value);
+    }
+    assert(branchFree.size() == branching.size());
+    assert(std::equal(branchFree.begin(), branchFree.end(), branching.begin(),
+                      [](const BranchFree& lhs, const Branching& rhs) {
+                        return lhs == rhs.value;
+                      }));
+  }
+  assert(isValidHeap(branchFree));
+}
+
+/**
+ * \brief Checks that the branch-free bubbleDown leaves every element exactly
+ * where the usual one does, for numbers and for strings with key prefixes
+ */
+void branchFreeTest() {
+  compareSifts<int, BranchingInt>([](int i) { return i; });
+
+  // Short strings differ in their prefixes, while long ones with the same
+  // first characters make the prefixes tie and fall back to the strings
+  compareSifts<std::string, BranchingString>(
+      [](int i) { return std::to_string(i); });
+  compareSifts<std::string, BranchingString>([](int i) {
+    return std::string("https://example.com/") + std::to_string(i);
+  });
+}
+
+/**
+ * \brief Checks that bubbling down within the inline buffer and after
+ * spilling out of it still works with the flag defined
+ */
+void inlineTest() {
+  MinHeap<int, 4> small;
+  for (int value : {7, 3, 9, 1, 5, 8, 2}) {
+    small.insert(value);
+    assert(isValidHeap(small));
+  }
+  for (int expected : {1, 2, 3, 5, 7, 8, 9}) {
+    assert(small.peakMin() == expected);
+    small.deleteMin();
+    assert(isValidHeap(small));
+  }
+  assert(small.empty());
+}
+
+int main() {
+  branchFreeTest();
+  inlineTest();
+
+  std::cout << "All tests passed" << std::endl;
+  return 0;
+}
@@ -0,0 +1,128 @@
+/**
+ * \file csrgraph-private.hpp
+ * \copyright Matthew Calligaro
+ * \date January 2020
+ * \brief Provides the template implementation for the CsrGraph class
+ */
+
+// NOLINT(build/header_guard)
+
+#include <random>
+#include <type_traits>
+#include <vector>
+
+template <typename Weight>
+CsrGraph<Weight>::CsrGraph() : offsets_(1, 0) {
+  // Nothing else to do
+}
+
+template <typename Weight>
+CsrGraph<Weight>::CsrGraph(size_t nodes, const std::vector<Edge>& edges)
+    : offsets_(nodes + 1, 0),
+      targets_(edges.size()),
+      weights_(edges.size()) {
+  // This is a counting sort by the node each edge leaves.  First we count the
+  // edges of each node, then turn the counts into starting offsets.
+  for (const Edge& edge : edges) {
+    ++offsets_[edge.from + 1];
+  }
+  for (size_t node = 0; node < nodes; ++node) {
+    offsets_[node + 1] += offsets_[node];
+  }
+
+  // Then we drop each edge into the next free place for its node, using a
+  // copy of the offsets to keep track of the next free place
+  std::vector<size_t> next(offsets_.begin(), offsets_.end() - 1);
+  for (const Edge& edge : edges) {
+    size_t index = next[edge.from]++;
+    targets_[index] = static_cast<uint32_t>(edge.to);
+    weights_[index] = edge.weight;
+  }
+}
+
+template <typename Weight>
+CsrGraph<Weight> CsrGraph<Weight>::random(size_t nodes, size_t degree,
+                                          Weight maxWeight, uint32_t seed) {
+  // Every node has the same number of edges, so we can fill in the arrays
+  // directly rather than sort a list of edges
+  std::mt19937 engine(seed);
+  std::uniform_int_distribution<size_t> pickNode(0, nodes - 1);
+  CsrGraph graph;
+  graph.offsets_.resize(nodes + 1);
+  graph.targets_.resize(nodes * degree);
+  graph.weights_.resize(nodes * degree);
+  for (size_t node = 0; node <= nodes; ++node) {
+    graph.offsets_[node] = node * degree;
+  }
+  for (size_t edge = 0; edge < nodes * degree; ++edge) {
+    graph.targets_[edge] = static_cast<uint32_t>(pickNode(engine));
+    graph.weights_[edge] = randomWeight(engine, maxWeight);
+  }
+  return graph;
+}
+
+template <typename Weight>
+CsrGraph<Weight> CsrGraph<Weight>::grid(size_t width, size_t height,
+                                        Weight maxWeight, uint32_t seed) {
+  std::mt19937 engine(seed);
+  std::vector<Edge> edges;
+  edges.reserve(4 * width * height);
+  for (size_t y = 0; y < height; ++y) {
+    for (size_t x = 0; x < width; ++x) {
+      size_t node = y * width + x;
+      if (x > 0) {
+        edges.push_back({node, node - 1, randomWeight(engine, maxWeight)});
+      }
+      if (x + 1 < width) {
+        edges.push_back({node, node + 1, randomWeight(engine, maxWeight)});
+      }
+      if (y > 0) {
+        edges.push_back({node, node - width, randomWeight(engine, maxWeight)});
+      }
+      if (y + 1 < height) {
+        edges.push_back({node, node + width, randomWeight(engine, maxWeight)});
+      }
+    }
+  }
+  return CsrGraph(width * height, edges);
+}
+
+template <typename Weight>
+size_t CsrGraph<Weight>::nodes() const {
+  return offsets_.size() - 1;
+}
+
+template <typename Weight>
+size_t CsrGraph<Weight>::edges() const {
+  return targets_.size();
+}
+
+template <typename Weight>
+size_t CsrGraph<Weight>::firstEdge(size_t node) const {
+  return offsets_[node];
+}
+
+template <typename Weight>
+size_t CsrGraph<Weight>::lastEdge(size_t node) const {
+  return offsets_[node + 1];
+}
+
+template <typename Weight>
+size_t CsrGraph<Weight>::target(size_t edge) const {
+  return targets_[edge];
+}
+
+template <typename Weight>
+Weight CsrGraph<Weight>::weight(size_t edge) const {
+  return weights_[edge];
+}
+
+template <typename Weight>
+template <typename Engine>
+Weight CsrGraph<Weight>::randomWeight(Engine& engine, Weight maxWeight) {
+  if constexpr (std::is_integral_v<Weight>) {
+    return std::uniform_int_distribution<Weight>(1, maxWeight)(engine);
+  } else {
+    return std::uniform_real_distribution<Weight>(1, maxWeight)(engine);
+  }
+}
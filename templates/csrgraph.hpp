@@ -0,0 +1,164 @@
+/**
+ * \file csrgraph.hpp
+ * \copyright Matthew Calligaro
+ * \date January 2020
+ * \brief Declares the CsrGraph class
+ */
+
+#ifndef TEMPLATES_CSRGRAPH_HPP_
+#define TEMPLATES_CSRGRAPH_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * \class CsrGraph
+ * \brief A directed graph with weighted edges, stored in compressed sparse
+ * row (CSR) form
+ * \details Rather than a list of edges for each node, a CsrGraph keeps every
+ * edge in two flat arrays, sorted by the node they leave, and a third array
+ * which says where each node's edges start.  The edges leaving node n are
+ * then the indices firstEdge(n) up to (but not including) lastEdge(n).  A
+ * graph search walks each node's edges in order, so it reads memory
+ * sequentially instead of chasing a pointer per edge.
+ *
+ * Targets are stored as 32-bit indices, which halves the size of the largest
+ * array, so a CsrGraph holds at most 2^32 - 1 nodes.
+ * \note The template type Weight must be an arithmetic type
+ */
+template <typename Weight>
+class CsrGraph {
+ public:
+  // STL container type definitions
+  using size_type = size_t;
+  using weight_type = Weight;
+
+  /**
+   * \struct Edge
+   * \brief One edge of a graph, as passed to the constructor
+   */
+  struct Edge {
+    size_t from;
+    size_t to;
+    Weight weight;
+  };
+
+  /**
+   * \brief Creates a graph with no nodes
+   * \note Run time: constant
+   */
+  CsrGraph();
+
+  /**
+   * \brief Creates a graph from a list of edges
+   * \param nodes   The number of nodes, which are numbered 0 to nodes - 1
+   * \param edges   The edges, in any order
+   * \note Run time: linear in nodes + edges.size()
+   * \warning Behavior is undefined if an edge refers to a node which does not
+   * exist
+   */
+  CsrGraph(size_t nodes, const std::vector<Edge>& edges);
+
+  /**
+   * \brief Creates a graph whose edges go to random nodes
+   * \param nodes       The number of nodes
+   * \param degree      The number of edges leaving each node
+   * \param maxWeight   The largest weight, where weights are chosen
+   * uniformly from 1 to maxWeight
+   * \param seed        The seed for the random number generator
+   * \return The new graph
+   * \note Run time: linear in nodes * degree
+   */
+  static CsrGraph random(size_t nodes, size_t degree, Weight maxWeight,
+                         uint32_t seed);
+
+  /**
+   * \brief Creates a grid graph, in which each node has an edge to each of
+   * its neighbors above, below, left, and right
+   * \param width       The number of columns
+   * \param height      The number of rows
+   * \param maxWeight   The largest weight, where weights are chosen
+   * uniformly from 1 to maxWeight
+   * \param seed        The seed for the random number generator
+   * \return The new graph, in which the node in column x of row y is
+   * y * width + x
+   * \note Run time: linear in width * height
+   */
+  static CsrGraph grid(size_t width, size_t height, Weight maxWeight,
+                       uint32_t seed);
+
+  /**
+   * \brief Returns the number of nodes
+   * \return The number of nodes
+   * \note Run time: constant
+   */
+  size_type nodes() const;
+
+  /**
+   * \brief Returns the number of edges
+   * \return The number of edges
+   * \note Run time: constant
+   */
+  size_type edges() const;
+
+  /**
+   * \brief Returns the index of the first edge leaving a node
+   * \param node  The node
+   * \return The index of the first edge leaving node
+   * \note Run time: constant
+   */
+  size_type firstEdge(size_t node) const;
+
+  /**
+   * \brief Returns the index just past the last edge leaving a node
+   * \param node  The node
+   * \return The index just past the last edge leaving node, which equals
+   * firstEdge(node) if no edges leave node
+   * \note Run time: constant
+   */
+  size_type lastEdge(size_t node) const;
+
+  /**
+   * \brief Returns the node an edge leads to
+   * \param edge  The index of the edge
+   * \return The node at the end of edge
+   * \note Run time: constant
+   */
+  size_type target(size_t edge) const;
+
+  /**
+   * \brief Returns the weight of an edge
+   * \param edge  The index of the edge
+   * \return The weight of edge
+   * \note Run time: constant
+   */
+  Weight weight(size_t edge) const;
+
+ private:
+  /**
+   * \brief Where the edges of each node start, with one extra entry at the
+   * end which holds the total number of edges
+   */
+  std::vector<size_t> offsets_;
+
+  /** \brief The node each edge leads to */
+  std::vector<uint32_t> targets_;
+
+  /** \brief The weight of each edge */
+  std::vector<Weight> weights_;
+
+  /**
+   * \brief Chooses a random weight from 1 to maxWeight
+   * \param engine      The random number generator to use
+   * \param maxWeight   The largest weight
+   * \return The weight
+   * \note Run time: constant
+   */
+  template <typename Engine>
+  static Weight randomWeight(Engine& engine, Weight maxWeight);
+};
+
+#include "csrgraph-private.hpp"
+
+#endif  // TEMPLATES_CSRGRAPH_HPP_
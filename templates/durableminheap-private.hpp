@@ -0,0 +1,349 @@
+/**
+ * \file durableminheap-private.hpp
+ * \copyright Matthew Calligaro
+ * \date January 2020
+ * \brief Provides the template implementation for the DurableMinHeap class
+ */
+
+// NOLINT(build/header_guard)
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <future>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+template <typename T>
+DurableMinHeap<T>::DurableMinHeap(const std::string& directory,
+                                  size_t batchSize, size_t compactAfter)
+    : directory_{directory},
+      batchSize_{batchSize > 0 ? batchSize : 1},
+      compactAfter_{compactAfter},
+      log_{-1},
+      generation_{0},
+      logRecords_{0} {
+  std::filesystem::create_directories(directory_);
+  recover();
+  openLog();
+}
+
+template <typename T>
+DurableMinHeap<T>::~DurableMinHeap() {
+  try {
+    flush();
+  } catch (...) {
+    // Nothing we can do about it here
+  }
+  if (snapshot_.valid()) {
+    try {
+      snapshot_.get();
+    } catch (...) {
+      // The old snapshot and logs are still in place
+    }
+  }
+  close(log_);
+}
+
+template <typename T>
+size_t DurableMinHeap<T>::size() const {
+  return heap_.size();
+}
+
+template <typename T>
+bool DurableMinHeap<T>::empty() const {
+  return heap_.empty();
+}
+
+template <typename T>
+const T& DurableMinHeap<T>::peakMin() const {
+  return heap_.peakMin();
+}
+
+template <typename T>
+void DurableMinHeap<T>::insert(const T& val) {
+  heap_.insert(val);
+  append(INSERT, &val);
+}
+
+template <typename T>
+void DurableMinHeap<T>::deleteMin() {
+  heap_.deleteMin();
+  append(DELETE_MIN, nullptr);
+}
+
+template <typename T>
+void DurableMinHeap<T>::sync() {
+  flush();
+  if (snapshot_.valid() && snapshot_.wait_for(std::chrono::seconds(0)) ==
+                               std::future_status::ready) {
+    snapshot_.get();
+  }
+}
+
+template <typename T>
+uint64_t DurableMinHeap<T>::generation() const {
+  return generation_;
+}
+
+template <typename T>
+std::string DurableMinHeap<T>::logPath(const std::string& directory,
+                                       uint64_t generation) {
+  return directory + "/log." + std::to_string(generation);
+}
+
+template <typename T>
+std::string DurableMinHeap<T>::snapshotPath(const std::string& directory) {
+  return directory + "/snapshot";
+}
+
+template <typename T>
+void DurableMinHeap<T>::recover() {
+  // Load the snapshot, if there is one.  Since it was renamed into place
+  // only once it was complete, any damage means something else went wrong.
+  std::vector<T> elements;
+  std::ifstream snapshot(snapshotPath(directory_), std::ios::binary);
+  if (snapshot.is_open()) {
+    std::vector<unsigned char> bytes(std::istreambuf_iterator<char>(snapshot),
+                                     {});
+    const size_t HEADER_SIZE = 3 * sizeof(uint64_t);
+    uint64_t header[3] = {};
+    uint32_t expected = 0;
+    if (bytes.size() >= HEADER_SIZE + sizeof(uint32_t)) {
+      std::memcpy(header, bytes.data(), HEADER_SIZE);
+      std::memcpy(&expected, bytes.data() + bytes.size() - sizeof(uint32_t),
+                  sizeof(uint32_t));
+    }
+    if (header[0] != SNAPSHOT_MAGIC ||
+        bytes.size() != HEADER_SIZE + header[2] * sizeof(T) +
+                            sizeof(uint32_t) ||
+        checksum(bytes.data(), bytes.size() - sizeof(uint32_t)) != expected) {
+      throw std::runtime_error("The snapshot in " + directory_ +
+                               " is damaged");
+    }
+    generation_ = header[1];
+    elements.resize(header[2]);
+    std::memcpy(static_cast<void*>(elements.data()),
+                bytes.data() + HEADER_SIZE, header[2] * sizeof(T));
+  }
+  heap_ = MinHeap<T>(elements.begin(), elements.end());
+
+  // Clean up after a crash while a snapshot was being written, or just after
+  // one was renamed into place
+  std::filesystem::remove(snapshotPath(directory_) + ".tmp");
+  for (uint64_t old = generation_;
+       old > 0 && std::filesystem::remove(logPath(directory_, old - 1));
+       --old) {
+    // Nothing else to do
+  }
+
+  // A crash while a snapshot was being written leaves the log it was meant
+  // to replace, followed by the new log, so we replay every log in turn
+  logRecords_ = replay(logPath(directory_, generation_));
+  while (std::filesystem::exists(logPath(directory_, generation_ + 1))) {
+    ++generation_;
+    logRecords_ = replay(logPath(directory_, generation_));
+  }
+}
+
+template <typename T>
+size_t DurableMinHeap<T>::replay(const std::string& path) {
+  std::ifstream log(path, std::ios::binary);
+  if (!log.is_open()) {
+    return 0;
+  }
+  std::vector<unsigned char> bytes(std::istreambuf_iterator<char>(log), {});
+
+  size_t records = 0;
+  size_t offset = 0;
+  for (; offset + RECORD_SIZE <= bytes.size(); offset += RECORD_SIZE) {
+    const unsigned char* record = bytes.data() + offset;
+    uint32_t expected;
+    std::memcpy(&expected, record + 1 + sizeof(T), sizeof(uint32_t));
+    if (checksum(record, 1 + sizeof(T)) != expected) {
+      break;
+    }
+    if (record[0] == INSERT) {
+      T val;
+      std::memcpy(static_cast<void*>(&val), record + 1, sizeof(T));
+      heap_.insert(val);
+    } else if (record[0] == DELETE_MIN && !heap_.empty()) {
+      heap_.deleteMin();
+    } else {
+      break;
+    }
+    ++records;
+  }
+
+  // Anything after the last good record was cut off by a crash, and new
+  // records must not be appended after it
+  if (offset != bytes.size()) {
+    log.close();
+    std::filesystem::resize_file(path, offset);
+  }
+  return records;
+}
+
+template <typename T>
+void DurableMinHeap<T>::openLog() {
+  std::string path = logPath(directory_, generation_);
+  log_ = open(path.c_str(), O_WRONLY | O_CREAT | O_APPEND, 0644);
+  if (log_ == -1) {
+    throw std::system_error(errno, std::generic_category(), path);
+  }
+  syncDirectory(directory_);
+}
+
+template <typename T>
+void DurableMinHeap<T>::append(Operation operation, const T* val) {
+  size_t offset = pending_.size();
+  pending_.resize(offset + RECORD_SIZE);
+  unsigned char* record = pending_.data() + offset;
+  record[0] = operation;
+  if (val != nullptr) {
+    std::memcpy(record + 1, static_cast<const void*>(val), sizeof(T));
+  } else {
+    std::memset(record + 1, 0, sizeof(T));
+  }
+  uint32_t sum = checksum(record, 1 + sizeof(T));
+  std::memcpy(record + 1 + sizeof(T), &sum, sizeof(uint32_t));
+  ++logRecords_;
+
+  if (pending_.size() >= batchSize_ * RECORD_SIZE) {
+    flush();
+  }
+  compactIfNeeded();
+}
+
+template <typename T>
+void DurableMinHeap<T>::flush() {
+  // One write and one fsync for the whole batch is what makes group commit
+  // pay off: fsync takes about as long for one record as for thousands
+  if (pending_.empty()) {
+    return;
+  }
+  writeAll(log_, pending_.data(), pending_.size());
+  if (fdatasync(log_) != 0) {
+    throw std::system_error(errno, std::generic_category(), "fdatasync");
+  }
+  pending_.clear();
+}
+
+template <typename T>
+void DurableMinHeap<T>::compactIfNeeded() {
+  if (logRecords_ < compactAfter_) {
+    return;
+  }
+  if (snapshot_.valid()) {
+    // Let the current log grow until the last snapshot is done
+    if (snapshot_.wait_for(std::chrono::seconds(0)) !=
+        std::future_status::ready) {
+      return;
+    }
+    snapshot_.get();
+  }
+
+  // Everything up to here must be in the old log before the new one starts,
+  // since recovery replays the old log if the snapshot never finishes
+  flush();
+  std::vector<T> elements(heap_.begin(), heap_.end());
+  close(log_);
+  ++generation_;
+  logRecords_ = 0;
+  openLog();
+  snapshot_ = std::async(std::launch::async, writeSnapshot, directory_,
+                         generation_, std::move(elements));
+}
+
+template <typename T>
+void DurableMinHeap<T>::writeSnapshot(std::string directory,
+                                      uint64_t generation,
+                                      std::vector<T> elements) {
+  const size_t HEADER_SIZE = 3 * sizeof(uint64_t);
+  std::vector<unsigned char> bytes(HEADER_SIZE + elements.size() * sizeof(T) +
+                                   sizeof(uint32_t));
+  uint64_t header[3] = {SNAPSHOT_MAGIC, generation, elements.size()};
+  std::memcpy(bytes.data(), header, HEADER_SIZE);
+  std::memcpy(bytes.data() + HEADER_SIZE,
+              static_cast<const void*>(elements.data()),
+              elements.size() * sizeof(T));
+  uint32_t sum = checksum(bytes.data(), bytes.size() - sizeof(uint32_t));
+  std::memcpy(bytes.data() + bytes.size() - sizeof(uint32_t), &sum,
+              sizeof(uint32_t));
+
+  // Write and sync a temporary file, then rename it over the old snapshot.
+  // Once the rename reaches the disk, the old logs are no longer needed.
+  std::string path = snapshotPath(directory);
+  std::string temporary = path + ".tmp";
+  int descriptor = open(temporary.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  if (descriptor == -1) {
+    throw std::system_error(errno, std::generic_category(), temporary);
+  }
+  try {
+    writeAll(descriptor, bytes.data(), bytes.size());
+    if (fsync(descriptor) != 0) {
+      throw std::system_error(errno, std::generic_category(), "fsync");
+    }
+  } catch (...) {
+    close(descriptor);
+    throw;
+  }
+  close(descriptor);
+  std::filesystem::rename(temporary, path);
+  syncDirectory(directory);
+
+  for (uint64_t old = generation;
+       old > 0 && std::filesystem::remove(logPath(directory, old - 1));
+       --old) {
+    // Nothing else to do
+  }
+}
+
+template <typename T>
+uint32_t DurableMinHeap<T>::checksum(const unsigned char* bytes,
+                                     size_t count) {
+  uint32_t hash = 2166136261u;
+  for (size_t i = 0; i < count; ++i) {
+    hash = (hash ^ bytes[i]) * 16777619u;
+  }
+  return hash;
+}
+
+template <typename T>
+void DurableMinHeap<T>::writeAll(int descriptor, const unsigned char* bytes,
+                                 size_t count) {
+  while (count > 0) {
+    ssize_t written = write(descriptor, bytes, count);
+    if (written < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      throw std::system_error(errno, std::generic_category(), "write");
+    }
+    bytes += written;
+    count -= written;
+  }
+}
+
+template <typename T>
+void DurableMinHeap<T>::syncDirectory(const std::string& directory) {
+  int descriptor = open(directory.c_str(), O_RDONLY | O_DIRECTORY);
+  if (descriptor == -1) {
+    throw std::system_error(errno, std::generic_category(), directory);
+  }
+  int result = fsync(descriptor);
+  int error = errno;
+  close(descriptor);
+  if (result != 0) {
+    throw std::system_error(error, std::generic_category(), "fsync");
+  }
+}
@@ -0,0 +1,226 @@
+/**
+ * \file durableminheap-test.cpp
+ * \copyright Matthew Calligaro
+ * \date January 2020
+ * \brief An assortment of ad hoc tests for the DurableMinHeap class
+ * \note These tests are not comprehensive and are NOT a good example of unit
+ * testing
+ */
+
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <queue>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#include "durableminheap.hpp"
+
+/**
+ * \brief Creates an empty directory for one test
+ * \param name  Tells apart the directories of one run
+ * \return The path of the directory
+ */
+std::string freshDirectory(const std::string& name) {
+  std::filesystem::path path = std::filesystem::temp_directory_path() /
+                               ("cs70-durableminheap-test-" +
+                                std::to_string(getpid()) + "-" + name);
+  std::filesystem::remove_all(path);
+  return path.string();
+}
+
+/**
+ * \brief Removes every element of a heap
+ * \param heap  The heap to empty
+ * \return The elements, in the order they were removed
+ */
+template <typename Heap>
+std::vector<uint64_t> drain(Heap& heap) {
+  std::vector<uint64_t> values;
+  while (!heap.empty()) {
+    values.push_back(heap.top());
+    heap.pop();
+  }
+  return values;
+}
+
+/**
+ * \brief Reopens the heap in a directory and removes every element
+ * \param directory   The directory of the heap
+ * \return The elements, in the order they were removed
+ */
+std::vector<uint64_t> reopenAndDrain(const std::string& directory) {
+  DurableMinHeap<uint64_t> heap(directory);
+  std::vector<uint64_t> values;
+  while (!heap.empty()) {
+    values.push_back(heap.peakMin());
+    heap.deleteMin();
+  }
+  return values;
+}
+
+/**
+ * \brief Runs the i-th step of a fixed workload, on a DurableMinHeap or on
+ * a std::priority_queue which checks it
+ * \param i       The number of the step
+ * \param size    The size of the heap
+ * \param insert  Inserts a value into the heap
+ * \param remove  Removes the smallest value from the heap
+ */
+void step(uint64_t i, size_t size, const std::function<void(uint64_t)>& insert,
+          const std::function<void()>& remove) {
+  if (i % 3 == 2 && size > 0) {
+    remove();
+  } else {
+    insert(i * 0x9E3779B97F4A7C15 % 1000003);
+  }
+}
+
+/** \brief A std::priority_queue which puts the smallest value on top */
+using Reference = std::priority_queue<uint64_t, std::vector<uint64_t>,
+                                      std::greater<uint64_t>>;
+
+/**
+ * \brief Checks that a heap has the same elements after reopening it, with
+ * and without compaction
+ */
+void reopenTest() {
+  for (size_t compactAfter : {size_t{1} << 20, size_t{50}}) {
+    std::string directory = freshDirectory("reopen");
+    Reference reference;
+    {
+      DurableMinHeap<uint64_t> heap(directory, 8, compactAfter);
+      for (uint64_t i = 0; i < 1000; ++i) {
+        step(
+            i, heap.size(), [&](uint64_t val) { heap.insert(val); },
+            [&] { heap.deleteMin(); });
+        step(
+            i, reference.size(), [&](uint64_t val) { reference.push(val); },
+            [&] { reference.pop(); });
+      }
+      assert(heap.size() == reference.size());
+      assert(heap.peakMin() == reference.top());
+      heap.sync();
+      assert((heap.generation() > 0) == (compactAfter == 50));
+    }
+    assert(reopenAndDrain(directory) == drain(reference));
+
+    // Draining was logged too, and compaction leaves at most the snapshot
+    // and two logs behind
+    assert(reopenAndDrain(directory).empty());
+    size_t files = 0;
+    for (const auto& entry : std::filesystem::directory_iterator(directory)) {
+      assert(entry.path().filename() != "snapshot.tmp");
+      ++files;
+    }
+    assert(files <= 3);
+    std::filesystem::remove_all(directory);
+  }
+}
+
+/**
+ * \brief Checks that a partial record at the end of the log is discarded
+ */
+void tornTailTest() {
+  std::string directory = freshDirectory("torn");
+  {
+    DurableMinHeap<uint64_t> heap(directory);
+    heap.insert(5);
+    heap.insert(3);
+  }
+  {
+    std::ofstream log(directory + "/log.0",
+                      std::ios::binary | std::ios::app);
+    log << "\x01\x02\x03";
+  }
+  {
+    DurableMinHeap<uint64_t> heap(directory);
+    assert(heap.size() == 2);
+    heap.insert(4);
+  }
+  assert(reopenAndDrain(directory) == std::vector<uint64_t>({3, 4, 5}));
+  std::filesystem::remove_all(directory);
+}
+
+/**
+ * \brief Kills a process while it uses a heap, and checks that reopening
+ * the heap keeps every operation which was synced
+ * \details The child records in shared memory how many steps it has issued
+ * and how many it has synced.  The reopened heap must match the workload
+ * after some number of steps between the two, or one more if the step in
+ * progress had already reached the log.
+ */
+void killTest() {
+  const size_t KILLS = 20;
+  const uint64_t SYNC_EVERY = 16;
+
+  auto* progress = static_cast<std::atomic<uint64_t>*>(
+      mmap(nullptr, 2 * sizeof(std::atomic<uint64_t>), PROT_READ | PROT_WRITE,
+           MAP_SHARED | MAP_ANONYMOUS, -1, 0));
+  assert(progress != MAP_FAILED);
+  std::atomic<uint64_t>& issued = progress[0];
+  std::atomic<uint64_t>& synced = progress[1];
+
+  std::default_random_engine engine(47);
+  std::uniform_int_distribution<int> delay(1, 30);
+  for (size_t kill = 0; kill < KILLS; ++kill) {
+    std::string directory = freshDirectory("kill");
+    issued.store(0);
+    synced.store(0);
+    pid_t child = fork();
+    assert(child != -1);
+    if (child == 0) {
+      // A small compactAfter makes the child write snapshots as it goes
+      DurableMinHeap<uint64_t> heap(directory, 1000, 200);
+      for (uint64_t i = 0;; ++i) {
+        step(
+            i, heap.size(), [&](uint64_t val) { heap.insert(val); },
+            [&] { heap.deleteMin(); });
+        issued.store(i + 1);
+        if ((i + 1) % SYNC_EVERY == 0) {
+          heap.sync();
+          synced.store(i + 1);
+        }
+      }
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(delay(engine)));
+    ::kill(child, SIGKILL);
+    waitpid(child, nullptr, 0);
+
+    std::vector<uint64_t> recovered = reopenAndDrain(directory);
+    Reference reference;
+    bool matched = false;
+    for (uint64_t i = 0; i <= issued.load() + 1 && !matched; ++i) {
+      if (i >= synced.load()) {
+        Reference copy = reference;
+        matched = drain(copy) == recovered;
+      }
+      step(
+          i, reference.size(), [&](uint64_t val) { reference.push(val); },
+          [&] { reference.pop(); });
+    }
+    assert(matched);
+    std::filesystem::remove_all(directory);
+  }
+  munmap(progress, 2 * sizeof(std::atomic<uint64_t>));
+}
+
+int main() {
+  reopenTest();
+  tornTailTest();
+  killTest();
+
+  std::cout << "All tests passed" << std::endl;
+  return 0;
+}
@@ -0,0 +1,266 @@
+/**
+ * \file durableminheap.hpp
+ * \copyright Matthew Calligaro
+ * \date January 2020
+ * \brief Declares the DurableMinHeap class
+ */
+
+#ifndef TEMPLATES_DURABLEMINHEAP_HPP_
+#define TEMPLATES_DURABLEMINHEAP_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <future>
+#include <string>
+#include <type_traits>
+#include <vector>
+#include "minheap.hpp"
+
+/**
+ * \class DurableMinHeap
+ * \brief A MinHeap which is kept in a directory on disk, and survives the
+ * program crashing
+ * \details Writing out every element after every change would be far too
+ * slow.  Instead, each insert and deleteMin appends a small record to a
+ * write-ahead log, and starting up again replays the log.
+ *
+ * Records are only certain to be on disk once fsync returns, which takes
+ * much longer than the operation itself, so the records of batchSize
+ * operations are collected and written with one call to fsync ("group
+ * commit").  A crash loses at most the operations since the last fsync, and
+ * sync forces one at any time.
+ *
+ * Replaying a long log would be slow, so once compactAfter records have
+ * been logged, the heap starts a new log and writes a snapshot of its
+ * elements on a background thread.  Each log and snapshot has a generation
+ * number: snapshot N holds the elements at the start of log N.  Starting up
+ * reads the newest complete snapshot and replays its log and any newer ones.
+ * A snapshot is written to a temporary file and renamed into place, so a
+ * crash while writing one leaves the old snapshot and logs untouched.
+ *
+ * Every record has a checksum.  A crash while writing the log can leave a
+ * partial record at its end, which is discarded on startup.
+ * \note DurableMinHeap is no safer to share between threads than MinHeap,
+ * and only one DurableMinHeap may use a directory at a time
+ * \note The template type T must be trivially copyable (since it is written
+ * to disk as raw bytes) and support the default constructor, operator<, and
+ * operator==
+ */
+template <typename T>
+class DurableMinHeap {
+  static_assert(std::is_trivially_copyable_v<T>,
+                "Elements are written to disk as raw bytes");
+
+ public:
+  // STL container type definitions
+  using value_type = T;
+  using size_type = size_t;
+  using const_reference = const value_type&;
+
+  /**
+   * \brief Opens the heap stored in a directory, creating the directory if
+   * it does not exist
+   * \param directory     The directory which holds the snapshot and logs
+   * \param batchSize     The number of operations which share one fsync
+   * \param compactAfter  The number of records after which to start a new
+   * log and write a snapshot
+   * \note Run time: linear in the size of the snapshot plus logarithmic in
+   * the size of the heap for each record replayed
+   * \throw std::system_error if the files cannot be read or written
+   * \throw std::runtime_error if the snapshot is damaged
+   */
+  explicit DurableMinHeap(const std::string& directory, size_t batchSize = 64,
+                          size_t compactAfter = 1 << 16);
+
+  DurableMinHeap(const DurableMinHeap& other) = delete;
+  DurableMinHeap& operator=(const DurableMinHeap& other) = delete;
+
+  /**
+   * \brief Writes any records still waiting for fsync, waits for any
+   * snapshot in progress, and closes the log
+   * \note Errors are ignored, since a destructor cannot report them.  Call
+   * sync first to find out about them.
+   */
+  ~DurableMinHeap();
+
+  /**
+   * \brief Returns the number of elements in the heap
+   * \return The number of elements in the heap
+   * \note Run time: constant
+   */
+  size_type size() const;
+
+  /**
+   * \brief Returns whether the heap is empty
+   * \return True if the size of the heap is 0
+   * \note Run time: constant
+   */
+  bool empty() const;
+
+  /**
+   * \brief Returns a reference to the smallest element of the heap
+   * \return A reference to the smallest element of the heap
+   * \note Run time: constant
+   * \warning Behavior is undefined if the heap is empty
+   */
+  const_reference peakMin() const;
+
+  /**
+   * \brief Adds a new value to the heap and logs it
+   * \param val   The value to insert
+   * \note Run time: amortized logarithmic in the size of the heap, plus a
+   * write and an fsync every batchSize operations
+   * \throw std::system_error if the log cannot be written
+   */
+  void insert(const_reference val);
+
+  /**
+   * \brief Removes the smallest value from the heap and logs it
+   * \note Run time: amortized logarithmic in the size of the heap, plus a
+   * write and an fsync every batchSize operations
+   * \throw std::system_error if the log cannot be written
+   * \warning Behavior is undefined if the heap is empty
+   */
+  void deleteMin();
+
+  /**
+   * \brief Makes every operation so far durable
+   * \note Run time: one write and one fsync, if any operations are waiting
+   * \throw std::system_error if the log cannot be written, or if a snapshot
+   * written in the background failed
+   */
+  void sync();
+
+  /**
+   * \brief Returns the generation of the current log
+   * \return The generation, which grows by one each time a snapshot starts
+   * \note Run time: constant
+   */
+  uint64_t generation() const;
+
+ private:
+  /** \brief The operations which can appear in the log */
+  enum Operation : uint8_t { INSERT = 1, DELETE_MIN = 2 };
+
+  /** \brief The bytes in a record: the operation, a value, and a checksum */
+  static constexpr size_t RECORD_SIZE = 1 + sizeof(T) + sizeof(uint32_t);
+
+  /** \brief The first bytes of every snapshot */
+  static constexpr uint64_t SNAPSHOT_MAGIC = 0x43533730536e6170;
+
+  MinHeap<T> heap_;
+
+  std::string directory_;
+  size_t batchSize_;
+  size_t compactAfter_;
+
+  /** \brief The file descriptor of the current log */
+  int log_;
+
+  /** \brief The generation of the current log */
+  uint64_t generation_;
+
+  /** \brief The number of records in the current log, including pending_ */
+  size_t logRecords_;
+
+  /** \brief Records which have not been written to the log yet */
+  std::vector<unsigned char> pending_;
+
+  /** \brief The snapshot being written in the background, if any */
+  std::future<void> snapshot_;
+
+  /**
+   * \brief Returns the path of the log of a generation
+   * \param directory   The directory of the heap
+   * \param generation  The generation
+   * \return The path of the log
+   */
+  static std::string logPath(const std::string& directory,
+                             uint64_t generation);
+
+  /**
+   * \brief Returns the path of the snapshot
+   * \param directory   The directory of the heap
+   * \return The path of the snapshot
+   */
+  static std::string snapshotPath(const std::string& directory);
+
+  /**
+   * \brief Loads the snapshot and replays the logs after it
+   * \throw std::system_error if the files cannot be read
+   * \throw std::runtime_error if the snapshot is damaged
+   */
+  void recover();
+
+  /**
+   * \brief Applies every complete record of a log to heap_, and cuts off a
+   * partial record at its end
+   * \param path  The path of the log
+   * \return The number of records applied
+   */
+  size_t replay(const std::string& path);
+
+  /**
+   * \brief Opens the log of generation_ for appending
+   */
+  void openLog();
+
+  /**
+   * \brief Adds a record to pending_, writing pending_ out if it is full
+   * \param operation   The operation
+   * \param val         The value inserted, or nullptr for DELETE_MIN
+   */
+  void append(Operation operation, const T* val);
+
+  /**
+   * \brief Writes pending_ to the log and waits for fsync
+   */
+  void flush();
+
+  /**
+   * \brief Starts a new log and writes a snapshot in the background, once
+   * the current log is long enough and no snapshot is in progress
+   */
+  void compactIfNeeded();
+
+  /**
+   * \brief Writes a snapshot and removes the logs it replaces
+   * \param directory   The directory of the heap
+   * \param generation  The generation of the snapshot
+   * \param elements    The elements of the heap
+   * \note Runs on a background thread, so it must not touch the
+   * DurableMinHeap
+   */
+  static void writeSnapshot(std::string directory, uint64_t generation,
+                            std::vector<T> elements);
+
+  /**
+   * \brief Computes the FNV-1a hash of some bytes
+   * \param bytes   The bytes
+   * \param count   The number of bytes
+   * \return The hash
+   */
+  static uint32_t checksum(const unsigned char* bytes, size_t count);
+
+  /**
+   * \brief Writes every byte of a buffer to a file
+   * \param descriptor  The file descriptor
+   * \param bytes       The bytes to write
+   * \param count       The number of bytes
+   * \throw std::system_error if the file cannot be written
+   */
+  static void writeAll(int descriptor, const unsigned char* bytes,
+                       size_t count);
+
+  /**
+   * \brief Waits for the names of a directory's files to reach the disk, so
+   * that a file created or renamed in it survives a crash
+   * \param directory   The directory
+   * \throw std::system_error if the directory cannot be synced
+   */
+  static void syncDirectory(const std::string& directory);
+};
+
+#include "durableminheap-private.hpp"
+
+#endif  // TEMPLATES_DURABLEMINHEAP_HPP_
@@ -0,0 +1,68 @@
+/**
+ * \file fixedminheap-private.hpp
+ * \copyright Matthew Calligaro
+ * \date January 2020
+ * \brief Provides the template implementation for the FixedMinHeap class
+ */
+
+// NOLINT(build/header_guard)
+
+#include <ostream>
+
+/*******************************************************************************
+ * FixedMinHeap implementation
+ ******************************************************************************/
+
+template <typename T, size_t CAPACITY>
+typename FixedMinHeap<T, CAPACITY>::size_type
+FixedMinHeap<T, CAPACITY>::capacity() const {
+  return CAPACITY;
+}
+
+template <typename T, size_t CAPACITY>
+bool FixedMinHeap<T, CAPACITY>::full() const {
+  return size() == CAPACITY;
+}
+
+template <typename T, size_t CAPACITY>
+bool FixedMinHeap<T, CAPACITY>::insert(const_reference val) {
+  // As long as we never hold more than CAPACITY elements, MinHeap keeps every
+  // element in its inline pool and never grows array_ past its inline slots
+  if (full()) {
+    return false;
+  }
+  MinHeap<T, CAPACITY>::insert(val);
+  return true;
+}
+
+template <typename T, size_t CAPACITY>
+void FixedMinHeap<T, CAPACITY>::swap(FixedMinHeap& other) {
+  MinHeap<T, CAPACITY>::swap(other);
+}
+
+template <typename T, size_t CAPACITY>
+bool FixedMinHeap<T, CAPACITY>::operator==(const FixedMinHeap& rhs) const {
+  // Inside FixedMinHeap, we are allowed to convert to our private base class
+  return MinHeap<T, CAPACITY>::operator==(rhs);
+}
+
+template <typename T, size_t CAPACITY>
+bool FixedMinHeap<T, CAPACITY>::operator!=(const FixedMinHeap& rhs) const {
+  return !(*this == rhs);
+}
+
+/*******************************************************************************
+ * Overloading global functions
+ ******************************************************************************/
+
+template <typename T, size_t CAPACITY>
+std::ostream& operator<<(std::ostream& os,
+                         const FixedMinHeap<T, CAPACITY>& heap) {
+  return heap.print(os);
+}
+
+template <typename T, size_t CAPACITY>
+void swap(FixedMinHeap<T, CAPACITY>& first,
+          FixedMinHeap<T, CAPACITY>& second) {
+  first.swap(second);
+}
@@ -0,0 +1,107 @@
+/**
+ * \file fixedminheap.hpp
+ * \copyright Matthew Calligaro
+ * \date January 2020
+ * \brief Declares the FixedMinHeap class
+ */
+
+#ifndef TEMPLATES_FIXEDMINHEAP_HPP_
+#define TEMPLATES_FIXEDMINHEAP_HPP_
+
+#include <cstddef>
+#include <ostream>
+
+#include "minheap.hpp"
+
+/**
+ * \class FixedMinHeap
+ * \brief A binary min heap which holds at most CAPACITY elements and never
+ * allocates memory
+ * \details FixedMinHeap is a MinHeap whose elements all fit in its inline
+ * storage.  Rather than spilling onto the heap, insert refuses new elements
+ * once the FixedMinHeap is full, which makes every operation free of memory
+ * allocation (useful, for example, in a real-time thread).
+ *
+ * \note FixedMinHeap privately inherits from MinHeap<T, CAPACITY>: it reuses
+ * the MinHeap implementation, but users cannot treat it as a MinHeap, since
+ * that would let them call MinHeap::insert on a full FixedMinHeap.  The
+ * using-declarations below make the safe MinHeap methods public again.
+ * \note The template type T must support the copy constructor, operator<, and
+ * operator==
+ */
+template <typename T, size_t CAPACITY>
+class FixedMinHeap : private MinHeap<T, CAPACITY> {
+  static_assert(CAPACITY > 0, "A FixedMinHeap must hold at least one element");
+
+ public:
+  // STL container type definitions
+  using typename MinHeap<T, CAPACITY>::value_type;
+  using typename MinHeap<T, CAPACITY>::size_type;
+  using typename MinHeap<T, CAPACITY>::difference_type;
+  using typename MinHeap<T, CAPACITY>::reference;
+  using typename MinHeap<T, CAPACITY>::const_reference;
+  using typename MinHeap<T, CAPACITY>::iterator;
+  using typename MinHeap<T, CAPACITY>::const_iterator;
+
+  // These methods behave exactly as they do in MinHeap
+  using MinHeap<T, CAPACITY>::begin;
+  using MinHeap<T, CAPACITY>::end;
+  using MinHeap<T, CAPACITY>::cbegin;
+  using MinHeap<T, CAPACITY>::cend;
+  using MinHeap<T, CAPACITY>::size;
+  using MinHeap<T, CAPACITY>::empty;
+  using MinHeap<T, CAPACITY>::print;
+  using MinHeap<T, CAPACITY>::peakMin;
+  using MinHeap<T, CAPACITY>::exists;
+  using MinHeap<T, CAPACITY>::deleteMin;
+
+  /**
+   * \brief Returns the maximum number of elements the FixedMinHeap can hold
+   * \return CAPACITY
+   * \note Run time: constant
+   */
+  size_type capacity() const;
+
+  /**
+   * \brief Returns whether the FixedMinHeap is full
+   * \return True if the size of the FixedMinHeap is CAPACITY
+   * \note Run time: constant
+   */
+  bool full() const;
+
+  /**
+   * \brief Adds a new value to the FixedMinHeap if there is room for it
+   * \param val   The value to insert into the FixedMinHeap
+   * \return True if val was inserted, false if the FixedMinHeap was full
+   * \note Run time: logarithmic in the size of the FixedMinHeap
+   * \warning Invalidates all iterators pointing to this FixedMinHeap
+   */
+  bool insert(const_reference val);
+
+  /**
+   * \brief Exchanges the contents of the FixedMinHeap with other
+   * \param other   The FixedMinHeap with which to exchange contents
+   * \note Run time: linear in the size of both FixedMinHeaps
+   */
+  void swap(FixedMinHeap& other);
+
+  /**
+   * \brief Compares if two FixedMinHeaps contain the same elements
+   * \param rhs   The FixedMinHeap with which to compare
+   * \return True if this FixedMinHeap and rhs contain the exact same elements
+   * \note Run time: O(nlog(n)), where n is the size of the FixedMinHeap
+   */
+  bool operator==(const FixedMinHeap& rhs) const;
+
+  /**
+   * \brief Compares if two FixedMinHeaps contain the same elements
+   * \param rhs   The FixedMinHeap with which to compare
+   * \return False if this FixedMinHeap and rhs contain the exact same elements
+   * \note Run time: O(nlog(n)), where n is the size of the FixedMinHeap
+   */
+  bool operator!=(const FixedMinHeap& rhs) const;
+};
+
+#include "fixedminheap-private.hpp"
+
+#endif  // TEMPLATES_FIXEDMINHEAP_HPP_
@@ -0,0 +1,1696 @@
+/**
+ * \file heap-bench.cpp
+ * \copyright Matthew Calligaro
+ * \date January 2020
+ * \brief A collection of ad hoc benchmarks for the MinHeap class
+ * \note Run with no arguments to run every benchmark, or pass the names of
+ * the benchmarks to run (e.g. "./heap-bench reduce").  Build with
+ * "make heap-bench", which turns on optimizations.
+ */
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <execution>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <iterator>
+#include <latch>
+#include <mutex>
+#include <numeric>
+#include <optional>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "durableminheap.hpp"
+#include "fixedminheap.hpp"
+#include "huffmancodec.hpp"
+#include "keyedminheap.hpp"
+#include "latencyhistogram.hpp"
+#include "losertree.hpp"
+#include "minheap.hpp"
+#include "minheapview.hpp"
+#include "minmaxheap.hpp"
+#include "multiqueue.hpp"
+#include "pagedminheap.hpp"
+#include "persistentheap.hpp"
+#include "prioritychannel.hpp"
+#include "prioritythreadpool.hpp"
+#include "quantiletracker.hpp"
+#include "sharedminheap.hpp"
+#include "shortestpath.hpp"
+#include "slotallocator.hpp"
+#include "timerqueue.hpp"
+
+/**
+ * \brief Measures the fastest of several runs of a function
+ * \param trials    The number of times to run f
+ * \param f         The function to time
+ * \return The fastest run time of f, in milliseconds
+ */
+double bestOf(size_t trials, const std::function<void()>& f) {
+  double best = 0.0;
+  for (size_t i = 0; i < trials; ++i) {
+    auto start = std::chrono::steady_clock::now();
+    f();
+    std::chrono::duration<double, std::milli> elapsed =
+        std::chrono::steady_clock::now() - start;
+    if (i == 0 || elapsed.count() < best) {
+      best = elapsed.count();
+    }
+  }
+  return best;
+}
+
+/**
+ * \brief Prints one line of a benchmark report
+ * \param label   A description of what was measured
+ * \param ms      The measured time in milliseconds
+ */
+void report(const std::string& label, double ms) {
+  std::cout << "  " << label << ": " << ms << " ms" << std::endl;
+}
+
+/**
+ * \brief Compares sequential and parallel reductions over a large MinHeap
+ * \details Since the MinHeap iterators are random-access, std::reduce with
+ * std::execution::par_unseq can split the heap into chunks and sum them on
+ * every core, instead of walking it one element at a time.
+ */
+void reduceBench() {
+  const size_t HEAP_SIZE = 1 << 22;
+  const size_t TRIALS = 5;
+
+  // Inserting in ascending order never bubbles up, so building is cheap
+  MinHeap<size_t> heap;
+  for (size_t i = 0; i < HEAP_SIZE; ++i) {
+    heap.insert(i);
+  }
+
+  // Printing the results keeps the compiler from optimizing the work away
+  size_t sum = 0;
+  std::cout << "reduce (" << HEAP_SIZE << " elements)" << std::endl;
+  report("std::distance",
+         bestOf(TRIALS, [&] { sum += std::distance(heap.begin(), heap.end()); }));
+  report("std::accumulate", bestOf(TRIALS, [&] {
+           sum += std::accumulate(heap.begin(), heap.end(), size_t{0});
+         }));
+  report("std::reduce(seq)", bestOf(TRIALS, [&] {
+           sum += std::reduce(std::execution::seq, heap.begin(), heap.end());
+         }));
+  report("std::reduce(par_unseq)", bestOf(TRIALS, [&] {
+           sum +=
+               std::reduce(std::execution::par_unseq, heap.begin(), heap.end());
+         }));
+  report("std::count_if(par_unseq)", bestOf(TRIALS, [&] {
+           sum += std::count_if(std::execution::par_unseq, heap.begin(),
+                                heap.end(), [](size_t x) { return x % 3 == 0; });
+         }));
+  std::cout << "  (checksum " << sum << ")" << std::endl;
+}
+
+/**
+ * \brief Fills a short-lived heap with a few elements and then empties it
+ * \param elements    The number of elements to insert
+ * \return The sum of the elements, in the order they were removed
+ */
+template <typename Heap>
+size_t smallHeapRound(size_t elements) {
+  Heap heap;
+  for (size_t i = 0; i < elements; ++i) {
+    heap.insert((i * 7) % elements);
+  }
+
+  size_t sum = 0;
+  while (!heap.empty()) {
+    sum = sum * 3 + heap.peakMin();
+    heap.deleteMin();
+  }
+  return sum;
+}
+
+/**
+ * \brief Compares creating and destroying many small heaps with and without
+ * inline storage
+ */
+void smallHeapBench() {
+  const size_t ROUNDS = 1 << 18;
+  const size_t TRIALS = 5;
+
+  size_t sum = 0;
+  for (size_t elements : {0, 4, 8, 16}) {
+    std::cout << "small heaps (" << ROUNDS << " heaps of " << elements
+              << " elements)" << std::endl;
+    report("MinHeap<size_t>", bestOf(TRIALS, [&] {
+             for (size_t i = 0; i < ROUNDS; ++i) {
+               sum += smallHeapRound<MinHeap<size_t>>(elements);
+             }
+           }));
+    report("MinHeap<size_t, 16>", bestOf(TRIALS, [&] {
+             for (size_t i = 0; i < ROUNDS; ++i) {
+               sum += smallHeapRound<MinHeap<size_t, 16>>(elements);
+             }
+           }));
+    report("FixedMinHeap<size_t, 16>", bestOf(TRIALS, [&] {
+             for (size_t i = 0; i < ROUNDS; ++i) {
+               sum += smallHeapRound<FixedMinHeap<size_t, 16>>(elements);
+             }
+           }));
+  }
+  std::cout << "  (checksum " << sum << ")" << std::endl;
+}
+
+/**
+ * \brief Measures how building a large MinHeap scales with the thread count
+ */
+void buildBench() {
+  const size_t HEAP_SIZE = 1 << 22;
+  const size_t TRIALS = 3;
+
+  std::vector<size_t> numbers(HEAP_SIZE);
+  for (size_t i = 0; i < HEAP_SIZE; ++i) {
+    numbers[i] = i;
+  }
+  std::shuffle(numbers.begin(), numbers.end(), std::default_random_engine(7));
+
+  size_t sum = 0;
+  std::cout << "build (" << HEAP_SIZE << " elements, "
+            << std::thread::hardware_concurrency() << " hardware threads)"
+            << std::endl;
+  report("repeated insert", bestOf(TRIALS, [&] {
+           MinHeap<size_t> heap;
+           for (size_t number : numbers) {
+             heap.insert(number);
+           }
+           sum += heap.peakMin();
+         }));
+  for (size_t threads = 1; threads <= 32; threads *= 2) {
+    report("bulk build, " + std::to_string(threads) + " threads",
+           bestOf(TRIALS, [&] {
+             MinHeap<size_t> heap(numbers.begin(), numbers.end(), threads);
+             sum += heap.peakMin();
+           }));
+  }
+  std::cout << "  (checksum " << sum << ")" << std::endl;
+}
+
+/**
+ * \brief Compares cancelling queued elements with erase against rebuilding
+ * the MinHeap without them
+ */
+void cancelBench() {
+  const size_t HEAP_SIZE = 1 << 13;
+  const size_t TRIALS = 3;
+
+  std::vector<size_t> numbers(HEAP_SIZE);
+  for (size_t i = 0; i < HEAP_SIZE; ++i) {
+    numbers[i] = i;
+  }
+  std::shuffle(numbers.begin(), numbers.end(), std::default_random_engine(3));
+
+  size_t sum = 0;
+  for (size_t percent : {1, 10, 50}) {
+    // Cancel a random percent of the elements, then drain the heap
+    size_t cancellations = HEAP_SIZE * percent / 100;
+    std::vector<size_t> cancelled(numbers.begin(),
+                                  numbers.begin() + cancellations);
+    std::cout << "cancel (" << HEAP_SIZE << " elements, " << percent
+              << "% cancelled)" << std::endl;
+
+    report("exists + rebuild", bestOf(TRIALS, [&] {
+             MinHeap<size_t> heap(numbers.begin(), numbers.end());
+             for (size_t number : cancelled) {
+               if (heap.exists(number)) {
+                 std::vector<size_t> kept;
+                 for (size_t element : heap) {
+                   if (element != number) {
+                     kept.push_back(element);
+                   }
+                 }
+                 heap = MinHeap<size_t>(kept.begin(), kept.end());
+               }
+             }
+             for (; !heap.empty(); heap.deleteMin()) {
+               sum += heap.peakMin();
+             }
+           }));
+    report("erase", bestOf(TRIALS, [&] {
+             MinHeap<size_t> heap(numbers.begin(), numbers.end());
+             for (size_t number : cancelled) {
+               heap.erase(number);
+             }
+             for (; !heap.empty(); heap.deleteMin()) {
+               sum += heap.peakMin();
+             }
+           }));
+  }
+  std::cout << "  (checksum " << sum << ")" << std::endl;
+}
+
+/**
+ * \struct Descending
+ * \brief A size_t whose operator< is reversed, so a MinHeap of Descending
+ * acts as a max heap
+ */
+struct Descending {
+  size_t value;
+  bool operator<(const Descending& rhs) const { return rhs.value < value; }
+  bool operator==(const Descending& rhs) const { return value == rhs.value; }
+};
+
+/**
+ * \brief Compares a MinMaxHeap against a MinHeap and a max heap kept in sync
+ * \details The queue is filled and then alternately serves its smallest
+ * element and evicts its largest element, inserting a new element each time.
+ */
+void minMaxBench() {
+  const size_t QUEUE_SIZE = 1 << 14;
+  const size_t OPERATIONS = 1 << 15;
+  const size_t TRIALS = 3;
+
+  std::vector<size_t> numbers(QUEUE_SIZE + OPERATIONS);
+  std::default_random_engine engine(31);
+  for (size_t& number : numbers) {
+    number = engine();
+  }
+
+  size_t sum = 0;
+  std::cout << "min-max (" << QUEUE_SIZE << " elements, " << OPERATIONS
+            << " operations)" << std::endl;
+  report("two MinHeaps", bestOf(TRIALS, [&] {
+           MinHeap<size_t> minHeap;
+           MinHeap<Descending> maxHeap;
+           for (size_t i = 0; i < QUEUE_SIZE; ++i) {
+             minHeap.insert(numbers[i]);
+             maxHeap.insert({numbers[i]});
+           }
+           for (size_t i = 0; i < OPERATIONS; ++i) {
+             size_t removed = 0;
+             if (i % 2 == 0) {
+               removed = minHeap.peakMin();
+               minHeap.deleteMin();
+               maxHeap.erase({removed});
+             } else {
+               removed = maxHeap.peakMin().value;
+               maxHeap.deleteMin();
+               minHeap.erase(removed);
+             }
+             sum += removed;
+             minHeap.insert(numbers[QUEUE_SIZE + i]);
+             maxHeap.insert({numbers[QUEUE_SIZE + i]});
+           }
+         }));
+  report("MinMaxHeap", bestOf(TRIALS, [&] {
+           MinMaxHeap<size_t> heap;
+           for (size_t i = 0; i < QUEUE_SIZE; ++i) {
+             heap.insert(numbers[i]);
+           }
+           for (size_t i = 0; i < OPERATIONS; ++i) {
+             if (i % 2 == 0) {
+               sum += heap.peakMin();
+               heap.deleteMin();
+             } else {
+               sum += heap.peakMax();
+               heap.deleteMax();
+             }
+             heap.insert(numbers[QUEUE_SIZE + i]);
+           }
+         }));
+  std::cout << "  (checksum " << sum << ")" << std::endl;
+}
+
+/**
+ * \brief Times steady-state deleteMin and insert pairs on a large heap
+ * \param heapSize    The number of elements in the heap
+ * \param operations  The number of deleteMin and insert pairs to time
+ * \param sum         Accumulates the removed elements
+ * \return The run time of the deleteMin and insert pairs, in milliseconds
+ */
+template <typename Heap>
+double holdRound(size_t heapSize, size_t operations, size_t& sum) {
+  // Building the heap is not timed, since only the layout of the finished
+  // heap is being measured
+  std::default_random_engine engine(32);
+  Heap heap;
+  for (size_t i = 0; i < heapSize; ++i) {
+    heap.insert(engine());
+  }
+  return bestOf(1, [&] {
+    for (size_t i = 0; i < operations; ++i) {
+      sum += heap.peakMin();
+      heap.deleteMin();
+      heap.insert(engine());
+    }
+  });
+}
+
+/**
+ * \brief Compares the layouts of PagedMinHeap against MinHeap on large heaps
+ * \details Each deleteMin follows a root-to-leaf path, which is where the
+ * layout of the array matters.  A heap of 10^9 8-byte elements needs more
+ * than 8 GB for each layout, so the sizes stop at 10^8 by default, and
+ * MinHeap, which also allocates each element separately, stops at 10^7.
+ */
+void pagedBench() {
+  const size_t SIZES[] = {1000000, 10000000, 100000000};
+  const size_t MAX_MINHEAP_SIZE = 10000000;
+  const size_t OPERATIONS = 1 << 20;
+
+  size_t sum = 0;
+  for (size_t heapSize : SIZES) {
+    std::cout << "paged (" << heapSize << " elements, " << OPERATIONS
+              << " deleteMin + insert)" << std::endl;
+    if (heapSize <= MAX_MINHEAP_SIZE) {
+      report("MinHeap", holdRound<MinHeap<size_t>>(heapSize, OPERATIONS, sum));
+    }
+    report("ImplicitLayout",
+           holdRound<PagedMinHeap<size_t, ImplicitLayout>>(heapSize,
+                                                            OPERATIONS, sum));
+    report("BlockLayout<3> (cache line)",
+           holdRound<PagedMinHeap<size_t, BlockLayout<3>>>(heapSize,
+                                                            OPERATIONS, sum));
+    report("BlockLayout<9> (page)",
+           holdRound<PagedMinHeap<size_t, BlockLayout<9>>>(heapSize,
+                                                            OPERATIONS, sum));
+  }
+  std::cout << "  (checksum " << sum << ")" << std::endl;
+}
+
+/**
+ * \brief Compares TimerQueue against a MinHeap of deadlines for RPC timeouts
+ * \details Each tick schedules a batch of timeouts, and 90% of them are
+ * cancelled a few ticks later, when their response arrives.  The MinHeap
+ * cancels by marking a timer as cancelled and skipping it once it reaches
+ * the top.  Cancelling with exists and a rebuild, or with erase, searches
+ * the heap for each timer, which is far too slow for a million timers.
+ */
+void timerBench() {
+  const size_t TICKS = 10000;
+  const size_t TIMERS_PER_TICK = 100;
+  const size_t TIMEOUT = 1000;
+  const size_t CANCEL_PERCENT = 90;
+  const size_t TRIALS = 3;
+  const size_t TIMERS = TICKS * TIMERS_PER_TICK;
+
+  // Decide ahead of time when each timer is due and whether (and when) it
+  // is cancelled
+  std::default_random_engine engine(33);
+  std::vector<uint64_t> deadlines(TIMERS);
+  std::vector<std::vector<size_t>> cancelsAt(TICKS + 2 * TIMEOUT);
+  for (size_t timer = 0; timer < TIMERS; ++timer) {
+    size_t tick = timer / TIMERS_PER_TICK;
+    deadlines[timer] = tick + TIMEOUT + engine() % TIMEOUT;
+    if (engine() % 100 < CANCEL_PERCENT) {
+      cancelsAt[tick + 1 + engine() % 50].push_back(timer);
+    }
+  }
+
+  size_t fired = 0;
+  std::cout << "timer (" << TIMERS << " timers, " << CANCEL_PERCENT
+            << "% cancelled)" << std::endl;
+  report("MinHeap + cancelled flags", bestOf(TRIALS, [&] {
+           MinHeap<std::pair<uint64_t, size_t>> heap;
+           std::vector<bool> cancelled(TIMERS, false);
+           for (size_t tick = 0; tick < cancelsAt.size(); ++tick) {
+             for (size_t timer : cancelsAt[tick]) {
+               cancelled[timer] = true;
+             }
+             for (size_t i = 0; i < TIMERS_PER_TICK && tick < TICKS; ++i) {
+               size_t timer = tick * TIMERS_PER_TICK + i;
+               heap.insert({deadlines[timer], timer});
+             }
+             while (!heap.empty() && heap.peakMin().first <= tick) {
+               fired += !cancelled[heap.peakMin().second];
+               heap.deleteMin();
+             }
+           }
+         }));
+  report("TimerQueue", bestOf(TRIALS, [&] {
+           TimerQueue<> timers;
+           std::vector<TimerQueue<>::Handle> handles(TIMERS);
+           for (size_t tick = 0; tick < cancelsAt.size(); ++tick) {
+             for (size_t timer : cancelsAt[tick]) {
+               timers.cancel(handles[timer]);
+             }
+             for (size_t i = 0; i < TIMERS_PER_TICK && tick < TICKS; ++i) {
+               size_t timer = tick * TIMERS_PER_TICK + i;
+               handles[timer] =
+                   timers.schedule(deadlines[timer], [&fired] { ++fired; });
+             }
+             timers.advanceTo(tick);
+           }
+         }));
+  std::cout << "  (fired " << fired << ")" << std::endl;
+}
+
+/**
+ * \struct MergeHead
+ * \brief The next element of one range in a MinHeap-based k-way merge
+ */
+struct MergeHead {
+  size_t value;
+  size_t range;
+  bool operator<(const MergeHead& rhs) const {
+    return value < rhs.value || (value == rhs.value && range < rhs.range);
+  }
+  bool operator==(const MergeHead& rhs) const {
+    return value == rhs.value && range == rhs.range;
+  }
+};
+
+/**
+ * \brief Compares a k-way merge with LoserTree against one with MinHeap
+ */
+void mergeBench() {
+  const size_t ELEMENTS = 1 << 21;
+  const size_t TRIALS = 3;
+
+  size_t sum = 0;
+  for (size_t k : {2, 8, 32, 128, 512, 4096}) {
+    // Split random numbers into k sorted ranges
+    std::default_random_engine engine(34);
+    std::vector<std::vector<size_t>> inputs(k);
+    for (size_t i = 0; i < ELEMENTS; ++i) {
+      inputs[i % k].push_back(engine());
+    }
+    std::vector<std::pair<const size_t*, const size_t*>> ranges;
+    for (std::vector<size_t>& input : inputs) {
+      std::sort(input.begin(), input.end());
+      ranges.push_back({input.data(), input.data() + input.size()});
+    }
+    std::vector<size_t> merged(ELEMENTS);
+
+    std::cout << "merge (" << ELEMENTS << " elements, k = " << k << ")"
+              << std::endl;
+    report("MinHeap", bestOf(TRIALS, [&] {
+             MinHeap<MergeHead> heap;
+             std::vector<const size_t*> next;
+             for (size_t r = 0; r < k; ++r) {
+               next.push_back(ranges[r].first);
+               heap.insert({*next[r]++, r});
+             }
+             for (size_t i = 0; !heap.empty(); ++i) {
+               MergeHead head = heap.peakMin();
+               heap.deleteMin();
+               merged[i] = head.value;
+               if (next[head.range] != ranges[head.range].second) {
+                 heap.insert({*next[head.range]++, head.range});
+               }
+             }
+             sum += merged[ELEMENTS / 2];
+           }));
+    report("LoserTree", bestOf(TRIALS, [&] {
+             kWayMerge(ranges, merged.begin());
+             sum += merged[ELEMENTS / 2];
+           }));
+  }
+  std::cout << "  (checksum " << sum << ")" << std::endl;
+}
+
+/**
+ * \brief Measures how long MinHeap stalls while it resizes its slot array
+ * \details Each row doubles an array of n full slots, once by allocating a
+ * new array and copying the slots one at a time, as MinHeap used to, and
+ * once with SlotAllocator, which remaps large arrays with mremap.  The last
+ * row is the slowest single insert while growing a MinHeap, which is the
+ * stall a caller actually sees.
+ */
+void resizeBench() {
+  const size_t TRIALS = 3;
+  using Slots = SlotAllocator<size_t*>;
+
+  // Times one doubling of a full array of n slots, leaving out the time to
+  // fill the array beforehand
+  auto timeResize = [](size_t n, bool remap) {
+    double best = 0.0;
+    for (size_t trial = 0; trial < TRIALS; ++trial) {
+      size_t** array = remap ? Slots::allocate(n) : new size_t*[n];
+      for (size_t i = 0; i < n; ++i) {
+        array[i] = nullptr;
+      }
+      auto start = std::chrono::steady_clock::now();
+      if (remap) {
+        array = Slots::reallocate(array, n, 2 * n, n);
+      } else {
+        size_t** bigger = new size_t*[2 * n];
+        for (size_t i = 0; i < n; ++i) {
+          bigger[i] = array[i];
+        }
+        delete[] array;
+        array = bigger;
+      }
+      std::chrono::duration<double, std::milli> elapsed =
+          std::chrono::steady_clock::now() - start;
+      if (trial == 0 || elapsed.count() < best) {
+        best = elapsed.count();
+      }
+      if (remap) {
+        Slots::deallocate(array, 2 * n);
+      } else {
+        delete[] array;
+      }
+    }
+    return best;
+  };
+
+  for (size_t n : {1 << 16, 1 << 19, 1 << 22, 1 << 25}) {
+    std::cout << "resize (" << n << " slots to " << 2 * n << ")" << std::endl;
+    report("new[] and copy", timeResize(n, false));
+    report("SlotAllocator", timeResize(n, true));
+  }
+
+  const size_t HEAP_SIZE = 1 << 25;
+  MinHeap<size_t> heap;
+  double worst = 0.0;
+  for (size_t i = 0; i < HEAP_SIZE; ++i) {
+    auto start = std::chrono::steady_clock::now();
+    heap.insert(i);
+    std::chrono::duration<double, std::milli> elapsed =
+        std::chrono::steady_clock::now() - start;
+    worst = std::max(worst, elapsed.count());
+  }
+  std::cout << "resize (" << HEAP_SIZE << " inserts)" << std::endl;
+  report("slowest insert", worst);
+}
+
+/**
+ * \brief Times heapify and deleteMin on a MinHeap with a given prefetch policy
+ * \param label     The name of the policy
+ * \param numbers   The elements of the heap
+ * \param sum       A running total which keeps the work from being optimized
+ * away
+ */
+template <typename Prefetch>
+void prefetchRound(const std::string& label, const std::vector<size_t>& numbers,
+                   size_t& sum) {
+  const size_t TRIALS = 3;
+  const size_t DELETIONS = std::min(numbers.size() / 2, size_t{1} << 16);
+  MinHeap<size_t, 0, Prefetch> heap(numbers.begin(), numbers.end());
+
+  // Erasing a few elements with eraseIf compacts array_ and heapifies the
+  // rest, without allocating any elements along the way
+  size_t modulus = 1 << 20;
+  report(label + " eraseIf", bestOf(TRIALS, [&] {
+           sum += heap.eraseIf(
+               [modulus](size_t value) { return value % modulus == 0; });
+           heap.compact();
+           modulus /= 2;
+         }));
+
+  // Only the deleteMins are timed, not putting the elements back afterwards
+  std::vector<size_t> removed(DELETIONS);
+  double best = 0.0;
+  for (size_t trial = 0; trial < TRIALS; ++trial) {
+    auto start = std::chrono::steady_clock::now();
+    for (size_t& value : removed) {
+      value = heap.peakMin();
+      heap.deleteMin();
+    }
+    std::chrono::duration<double, std::milli> elapsed =
+        std::chrono::steady_clock::now() - start;
+    if (trial == 0 || elapsed.count() < best) {
+      best = elapsed.count();
+    }
+    for (size_t value : removed) {
+      heap.insert(value);
+    }
+  }
+  report(label + " deleteMin", best);
+  sum += heap.peakMin();
+}
+
+/**
+ * \brief Compares MinHeaps with and without software prefetching
+ * \details The elements of a large MinHeap are scattered around memory, so
+ * every level of a bubbleDown waits on a cache miss unless the memory was
+ * prefetched.  The eraseIf rows time heapify over the whole heap, and the
+ * deleteMin rows time up to 2^16 deleteMins.
+ */
+void prefetchBench() {
+  size_t sum = 0;
+  for (size_t heapSize : {1 << 12, 1 << 16, 1 << 20, 1 << 23}) {
+    std::vector<size_t> numbers(heapSize);
+    std::default_random_engine engine(36);
+    for (size_t& number : numbers) {
+      number = engine();
+    }
+
+    // A MinHeap frees its elements in heap order, so the next one built
+    // reuses their memory in a scrambled order.  Building and freeing one
+    // heap first means that every policy sees equally scattered elements,
+    // as they would be in a long-lived heap.
+    { MinHeap<size_t> warmUp(numbers.begin(), numbers.end()); }
+
+    std::cout << "prefetch (" << heapSize << " elements)" << std::endl;
+    prefetchRound<NoPrefetch>("NoPrefetch", numbers, sum);
+    prefetchRound<PrefetchAhead<2>>("PrefetchAhead<2>", numbers, sum);
+    prefetchRound<PrefetchAhead<3>>("PrefetchAhead<3>", numbers, sum);
+  }
+  std::cout << "  (checksum " << sum << ")" << std::endl;
+}
+
+/**
+ * \struct Record
+ * \brief A 256-byte payload ordered by an 8-byte key
+ */
+struct Record {
+  size_t key;
+  std::array<char, 256> payload;
+  bool operator<(const Record& rhs) const { return key < rhs.key; }
+  bool operator==(const Record& rhs) const { return key == rhs.key; }
+};
+
+/**
+ * \brief Compares heaps of large records ordered by a small key
+ * \details The queue is filled and then repeatedly reads the payload of its
+ * smallest record, deletes it, and inserts a new one.  MinHeap compares
+ * through a pointer to each record, PagedMinHeap moves whole records, and
+ * KeyedMinHeap only touches its array of keys.
+ */
+void keyedBench() {
+  const size_t OPERATIONS = 1 << 18;
+  const size_t TRIALS = 3;
+  using Payload = std::array<char, 256>;
+
+  size_t sum = 0;
+  for (size_t heapSize : {1 << 12, 1 << 16, 1 << 20}) {
+    std::vector<Record> records(heapSize + OPERATIONS);
+    std::default_random_engine engine(37);
+    for (Record& record : records) {
+      record.key = engine();
+      record.payload.fill(static_cast<char>(record.key));
+    }
+
+    std::cout << "keyed (" << heapSize << " records, " << OPERATIONS
+              << " operations)" << std::endl;
+    report("MinHeap", bestOf(TRIALS, [&] {
+             MinHeap<Record> heap;
+             for (size_t i = 0; i < heapSize; ++i) {
+               heap.insert(records[i]);
+             }
+             for (size_t i = heapSize; i < records.size(); ++i) {
+               sum += heap.peakMin().payload[0];
+               heap.deleteMin();
+               heap.insert(records[i]);
+             }
+           }));
+    report("PagedMinHeap", bestOf(TRIALS, [&] {
+             PagedMinHeap<Record> heap;
+             for (size_t i = 0; i < heapSize; ++i) {
+               heap.insert(records[i]);
+             }
+             for (size_t i = heapSize; i < records.size(); ++i) {
+               sum += heap.peakMin().payload[0];
+               heap.deleteMin();
+               heap.insert(records[i]);
+             }
+           }));
+    report("KeyedMinHeap", bestOf(TRIALS, [&] {
+             KeyedMinHeap<size_t, Payload> heap;
+             for (size_t i = 0; i < heapSize; ++i) {
+               heap.insert(records[i].key, records[i].payload);
+             }
+             for (size_t i = heapSize; i < records.size(); ++i) {
+               sum += heap.peakMinValue()[0];
+               heap.deleteMin();
+               heap.insert(records[i].key, records[i].payload);
+             }
+           }));
+  }
+  std::cout << "  (checksum " << sum << ")" << std::endl;
+}
+
+/**
+ * \brief Does a small, fixed amount of work for a benchmark task
+ * \param seed   The starting value
+ * \return A value which depends on every step, so the work is not skipped
+ */
+size_t spin(size_t seed) {
+  for (size_t i = 0; i < 256; ++i) {
+    seed = seed * 6364136223846793005u + 1442695040888963407u;
+  }
+  return seed;
+}
+
+/**
+ * \brief Measures the throughput of PriorityThreadPool and the latency of
+ * urgent tasks submitted behind a backlog, for several numbers of workers
+ * \details The latency rows time each urgent task from submit until it
+ * starts, while 2^15 background tasks keep every worker busy.
+ */
+void poolBench() {
+  const size_t TASKS = 1 << 17;
+  const size_t BACKGROUND = 1 << 15;
+  const size_t URGENT_EVERY = 64;
+  const size_t TRIALS = 3;
+  using Clock = std::chrono::steady_clock;
+
+  std::atomic<size_t> sum = 0;
+  for (size_t threads : {1, 2, 4, 8}) {
+    std::cout << "pool (" << threads << " workers)" << std::endl;
+    report(std::to_string(TASKS) + " tasks", bestOf(TRIALS, [&] {
+             PriorityThreadPool<> pool(threads);
+             for (size_t i = 0; i < TASKS; ++i) {
+               pool.submit(static_cast<int>(i % 16),
+                           [&sum, i] { sum += spin(i); });
+             }
+             pool.shutdown();
+           }));
+
+    std::vector<double> latencies;
+    std::vector<Clock::time_point> submitted(BACKGROUND / URGENT_EVERY);
+    std::vector<Clock::time_point> started(BACKGROUND / URGENT_EVERY);
+    {
+      PriorityThreadPool<> pool(threads);
+      for (size_t i = 0; i < BACKGROUND; ++i) {
+        pool.submit(1, [&sum, i] { sum += spin(i); });
+        if (i % URGENT_EVERY == 0) {
+          size_t urgent = i / URGENT_EVERY;
+          submitted[urgent] = Clock::now();
+          pool.submit(0,
+                      [&started, urgent] { started[urgent] = Clock::now(); });
+        }
+      }
+      pool.shutdown();
+    }
+    for (size_t i = 0; i < submitted.size(); ++i) {
+      std::chrono::duration<double, std::milli> wait =
+          started[i] - submitted[i];
+      latencies.push_back(wait.count());
+    }
+    std::sort(latencies.begin(), latencies.end());
+    report("urgent p50", latencies[latencies.size() / 2]);
+    report("urgent p99", latencies[latencies.size() * 99 / 100]);
+    report("urgent max", latencies.back());
+  }
+  std::cout << "  (checksum " << sum << ")" << std::endl;
+}
+
+/**
+ * \brief Compares the throughput and rank error of a MultiQueue against a
+ * single MinHeap behind a lock, for several numbers of threads
+ * \details In the throughput rows, each thread alternates insert and
+ * deleteMin on a queue which starts with 2^16 elements.  The rank error of a
+ * deleteMin is the number of smaller elements it left behind, measured on one
+ * thread by removing every element of a shuffled 0 to 2^16 - 1, using a
+ * Fenwick tree to count the smaller elements still present.  A locked
+ * MinHeap always has a rank error of 0.
+ */
+void multiQueueBench() {
+  const size_t INITIAL = 1 << 16;
+  const size_t OPERATIONS = 1 << 20;
+  const size_t TRIALS = 3;
+
+  // Runs threads threads, each doing its share of OPERATIONS on a queue
+  // through insert and remove
+  auto run = [](size_t threads, const std::function<void(size_t)>& insert,
+                const std::function<void()>& remove) {
+    std::vector<std::thread> workers;
+    for (size_t t = 0; t < threads; ++t) {
+      workers.emplace_back([&, t] {
+        std::default_random_engine engine(39 + t);
+        for (size_t i = 0; i < OPERATIONS / threads; ++i) {
+          if (i % 2 == 0) {
+            insert(engine());
+          } else {
+            remove();
+          }
+        }
+      });
+    }
+    for (std::thread& worker : workers) {
+      worker.join();
+    }
+  };
+
+  for (size_t threads : {1, 2, 4, 8}) {
+    std::cout << "multiqueue (" << threads << " threads, " << OPERATIONS
+              << " operations)" << std::endl;
+    report("locked MinHeap", bestOf(TRIALS, [&] {
+             std::mutex mutex;
+             MinHeap<size_t> heap;
+             for (size_t i = 0; i < INITIAL; ++i) {
+               heap.insert(i);
+             }
+             run(threads,
+                 [&](size_t val) {
+                   std::lock_guard<std::mutex> lock(mutex);
+                   heap.insert(val);
+                 },
+                 [&] {
+                   std::lock_guard<std::mutex> lock(mutex);
+                   heap.deleteMin();
+                 });
+           }));
+    report("MultiQueue", bestOf(TRIALS, [&] {
+             MultiQueue<size_t> queue(threads);
+             for (size_t i = 0; i < INITIAL; ++i) {
+               queue.insert(i);
+             }
+             run(threads, [&](size_t val) { queue.insert(val); },
+                 [&] {
+                   size_t min = 0;
+                   queue.deleteMin(min);
+                 });
+           }));
+
+    // present is a Fenwick tree over the keys, where the prefix sum up to a
+    // key counts the keys up to it which have not been removed yet
+    std::vector<size_t> keys(INITIAL);
+    std::iota(keys.begin(), keys.end(), 0);
+    std::shuffle(keys.begin(), keys.end(), std::default_random_engine(39));
+    std::vector<size_t> present(INITIAL + 1, 0);
+    auto add = [&present](size_t key, size_t delta) {
+      for (size_t i = key + 1; i < present.size(); i += i & -i) {
+        present[i] += delta;
+      }
+    };
+    MultiQueue<size_t> queue(threads);
+    for (size_t key : keys) {
+      queue.insert(key);
+      add(key, 1);
+    }
+    double totalError = 0.0;
+    size_t maxError = 0;
+    for (size_t key = 0; queue.deleteMin(key);) {
+      size_t error = 0;
+      for (size_t i = key; i > 0; i -= i & -i) {
+        error += present[i];
+      }
+      add(key, -1);
+      totalError += error;
+      maxError = std::max(maxError, error);
+    }
+    std::cout << "  MultiQueue rank error: mean " << totalError / INITIAL
+              << ", max " << maxError << std::endl;
+  }
+}
+
+/**
+ * \brief Compares a QuantileTracker with sorting the window after every
+ * update, for the median and the 99th percentile over sliding windows
+ * \details Sorting takes so long that it only runs for a small number of
+ * updates, and its time is scaled up to the same number of updates as the
+ * QuantileTracker.
+ */
+void quantileBench() {
+  const size_t UPDATES = 1000000;
+  const size_t SORTED_UPDATES = 2000;
+  const size_t TRIALS = 3;
+
+  std::vector<int> stream(UPDATES);
+  std::default_random_engine engine(40);
+  std::uniform_int_distribution<int> distribution(0, 1 << 20);
+  for (int& value : stream) {
+    value = distribution(engine);
+  }
+
+  size_t sum = 0;
+  for (size_t window : {1001, 10001}) {
+    for (double fraction : {0.5, 0.99}) {
+      std::cout << "quantile (p" << fraction * 100 << ", window of " << window
+                << ", " << UPDATES << " updates)" << std::endl;
+      double trackerMs = bestOf(TRIALS, [&] {
+        QuantileTracker<int> tracker(fraction, window);
+        for (int value : stream) {
+          tracker.add(value);
+          sum += tracker.quantile();
+        }
+      });
+      report("QuantileTracker", trackerMs);
+      std::cout << "  QuantileTracker updates per second: "
+                << UPDATES / trackerMs * 1000 << std::endl;
+
+      double sortedMs = bestOf(TRIALS, [&] {
+        std::deque<int> recent;
+        std::vector<int> sorted;
+        for (size_t i = 0; i < SORTED_UPDATES; ++i) {
+          recent.push_back(stream[i]);
+          if (recent.size() > window) {
+            recent.pop_front();
+          }
+          sorted.assign(recent.begin(), recent.end());
+          std::sort(sorted.begin(), sorted.end());
+          size_t rank = static_cast<size_t>(fraction * sorted.size() + 0.999);
+          sum += sorted[std::max(rank, size_t{1}) - 1];
+        }
+      });
+      report("sort every update (scaled)", sortedMs * UPDATES / SORTED_UPDATES);
+    }
+  }
+  std::cout << "  (checksum " << sum << ")" << std::endl;
+}
+
+/**
+ * \brief Compares priority queues inside Dijkstra's algorithm on graphs with
+ * a million nodes, and A* search with Dijkstra on the grid
+ * \details The random graph has 8 edges leaving each node, to random nodes,
+ * and the grid is 1000 by 1000.  MinHeap and std::priority_queue insert a
+ * node again whenever its distance shrinks and skip the stale entries, while
+ * DecreaseKeyHeap lowers the node's entry in place.
+ */
+void shortestPathBench() {
+  const size_t NODES = 1000000;
+  const size_t SIDE = 1000;
+  const size_t TRIALS = 2;
+  using Graph = CsrGraph<uint64_t>;
+
+  uint64_t sum = 0;
+  auto run = [&](const std::string& name, const Graph& graph) {
+    std::cout << "shortest path (" << name << ", " << graph.nodes()
+              << " nodes, " << graph.edges() << " edges)" << std::endl;
+    report("MinHeap", bestOf(TRIALS, [&] {
+             sum += dijkstra(graph, 0).back();
+           }));
+    report("std::priority_queue", bestOf(TRIALS, [&] {
+             sum += dijkstra<uint64_t, StdPriorityQueue<PathEntry<uint64_t>>>(
+                        graph, 0)
+                        .back();
+           }));
+    report("DecreaseKeyHeap", bestOf(TRIALS, [&] {
+             sum += dijkstraDecreaseKey(graph, 0).back();
+           }));
+  };
+  run("random", Graph::random(NODES, 8, 1000, 41));
+  Graph grid = Graph::grid(SIDE, SIDE, 1000, 41);
+  run("grid", grid);
+
+  // A* from the middle of the grid to a point a tenth of the way across,
+  // with the Manhattan distance as its heuristic
+  size_t source = SIDE / 2 * SIDE + SIDE / 2;
+  size_t target = source + SIDE / 10 * SIDE + SIDE / 10;
+  auto manhattan = [&](size_t node) {
+    size_t x = node % SIDE;
+    size_t y = node / SIDE;
+    return static_cast<uint64_t>(
+        (x > target % SIDE ? x - target % SIDE : target % SIDE - x) +
+        (y > target / SIDE ? y - target / SIDE : target / SIDE - y));
+  };
+  std::cout << "shortest path (grid, one target)" << std::endl;
+  report("MinHeap Dijkstra", bestOf(TRIALS, [&] {
+           sum += dijkstra(grid, source)[target];
+         }));
+  report("MinHeap A*", bestOf(TRIALS, [&] {
+           sum += aStar(grid, source, target, manhattan);
+         }));
+  std::cout << "  (checksum " << sum << ")" << std::endl;
+}
+
+/**
+ * \brief Measures the throughput of HuffmanCodec on the text files in ../io
+ * \details The files are tiny, so they are repeated to make 32 MiB of text,
+ * and the streams are in memory so that the disk is not measured.
+ */
+void huffmanBench() {
+  const size_t TEXT_SIZE = size_t{32} << 20;
+  const size_t TRIALS = 3;
+
+  std::string sample;
+  for (const char* path : {"../io/loremIpsum.txt", "../io/sheep.txt"}) {
+    std::ifstream file(path, std::ios::binary);
+    std::ostringstream contents;
+    contents << file.rdbuf();
+    sample += contents.str();
+  }
+  if (sample.empty()) {
+    std::cout << "huffman: run from the templates directory" << std::endl;
+    return;
+  }
+  std::string text;
+  while (text.size() < TEXT_SIZE) {
+    text += sample;
+  }
+
+  std::string compressed;
+  double compressMs = bestOf(TRIALS, [&] {
+    std::istringstream in(text);
+    std::ostringstream out;
+    HuffmanCodec<>::compress(in, out);
+    compressed = out.str();
+  });
+  size_t restoredSize = 0;
+  double decompressMs = bestOf(TRIALS, [&] {
+    std::istringstream in(compressed);
+    std::ostringstream out;
+    HuffmanCodec<>::decompress(in, out);
+    restoredSize = out.str().size();
+  });
+
+  double megabytes = static_cast<double>(text.size()) / (1 << 20);
+  std::cout << "huffman (" << text.size() << " bytes of text, compressed to "
+            << compressed.size() << ")" << std::endl;
+  report("compress", compressMs);
+  report("decompress", decompressMs);
+  std::cout << "  compress: " << megabytes / compressMs * 1000 << " MB/s"
+            << std::endl;
+  std::cout << "  decompress: " << megabytes / decompressMs * 1000 << " MB/s"
+            << std::endl;
+  std::cout << "  (checksum " << restoredSize << ")" << std::endl;
+}
+
+/**
+ * \brief Compares taking snapshots of a MinHeap, which copies every element,
+ * with taking snapshots of a PersistentHeap, which shares them
+ * \details Each operation is a deleteMin followed by an insert, and every
+ * 64th operation takes a snapshot and reads its smallest element.  The rows
+ * without snapshots show what sharing costs when nothing is copied.
+ */
+void persistentBench() {
+  const size_t OPERATIONS = 1 << 16;
+  const size_t SNAPSHOT_EVERY = 64;
+  const size_t TRIALS = 3;
+
+  size_t sum = 0;
+  for (size_t heapSize : {1 << 10, 1 << 13, 1 << 16}) {
+    std::vector<size_t> numbers(heapSize + OPERATIONS);
+    std::default_random_engine engine(43);
+    for (size_t& number : numbers) {
+      number = engine();
+    }
+
+    // Runs the workload on a heap, taking a snapshot every snapshotEvery
+    // operations, or never if snapshotEvery is 0
+    auto run = [&](auto& heap, size_t snapshotEvery) {
+      for (size_t i = 0; i < heapSize; ++i) {
+        heap.insert(numbers[i]);
+      }
+      for (size_t i = 0; i < OPERATIONS; ++i) {
+        heap.deleteMin();
+        heap.insert(numbers[heapSize + i]);
+        if (snapshotEvery != 0 && i % snapshotEvery == 0) {
+          auto snapshot = heap;
+          sum += snapshot.peakMin() + snapshot.size();
+        }
+      }
+    };
+
+    std::cout << "persistent (" << heapSize << " elements, " << OPERATIONS
+              << " operations)" << std::endl;
+    report("MinHeap, no snapshots", bestOf(TRIALS, [&] {
+             MinHeap<size_t> heap;
+             run(heap, 0);
+           }));
+    report("PersistentHeap, no snapshots", bestOf(TRIALS, [&] {
+             PersistentHeap<size_t> heap;
+             run(heap, 0);
+           }));
+    report("MinHeap, with snapshots", bestOf(TRIALS, [&] {
+             MinHeap<size_t> heap;
+             run(heap, SNAPSHOT_EVERY);
+           }));
+    report("PersistentHeap, with snapshots", bestOf(TRIALS, [&] {
+             PersistentHeap<size_t> heap;
+             run(heap, SNAPSHOT_EVERY);
+           }));
+  }
+  std::cout << "  (checksum " << sum << ")" << std::endl;
+}
+
+/**
+ * \brief Compares copying a vector into a MinHeap with arranging it into a
+ * heap in place with a MinHeapView
+ * \details The MinHeapView rows include copying the original numbers back
+ * into the vector before each trial, which is a single memcpy.
+ */
+void viewBench() {
+  const size_t HEAP_SIZE = 1 << 20;
+  const size_t TRIALS = 3;
+
+  std::vector<size_t> numbers(HEAP_SIZE);
+  std::default_random_engine engine(44);
+  for (size_t& number : numbers) {
+    number = engine();
+  }
+  std::vector<size_t> work(HEAP_SIZE);
+
+  size_t sum = 0;
+  std::cout << "view (" << HEAP_SIZE << " elements)" << std::endl;
+  report("MinHeap copy, build", bestOf(TRIALS, [&] {
+           MinHeap<size_t> heap(numbers.begin(), numbers.end());
+           sum += heap.peakMin();
+         }));
+  report("MinHeapView in place, build", bestOf(TRIALS, [&] {
+           work = numbers;
+           MinHeapView<size_t> view(work);
+           sum += view.peakMin();
+         }));
+  report("MinHeap copy, build and drain", bestOf(TRIALS, [&] {
+           MinHeap<size_t> heap(numbers.begin(), numbers.end());
+           while (!heap.empty()) {
+             sum += heap.peakMin();
+             heap.deleteMin();
+           }
+         }));
+  report("MinHeapView in place, build and drain", bestOf(TRIALS, [&] {
+           work = numbers;
+           MinHeapView<size_t> view(work);
+           while (!view.empty()) {
+             sum += view.peakMin();
+             view.deleteMin();
+           }
+         }));
+  std::cout << "  (checksum " << sum << ")" << std::endl;
+}
+
+/**
+ * \brief Measures a SharedMinHeap used by several processes at once
+ * \details Each operation removes the smallest element and inserts a new
+ * one.  The operations are split evenly between the worker processes, so on
+ * a machine with fewer cores than workers, the extra workers mostly measure
+ * contention for the lock.
+ */
+void sharedBench() {
+  const size_t HEAP_SIZE = 1 << 16;
+  const size_t OPERATIONS = 1 << 20;
+  const size_t TRIALS = 3;
+  const std::string NAME = "/cs70-heap-bench-" + std::to_string(getpid());
+
+  SharedMinHeap<uint64_t>::unlink(NAME);
+  SharedMinHeap<uint64_t> heap(NAME, HEAP_SIZE);
+  std::default_random_engine engine(45);
+  for (size_t i = 0; i < HEAP_SIZE; ++i) {
+    heap.insert(engine());
+  }
+
+  size_t sum = 0;
+  std::cout << "shared (" << HEAP_SIZE << " elements, " << OPERATIONS
+            << " operations)" << std::endl;
+  report("MinHeap, 1 thread, no lock", bestOf(TRIALS, [&] {
+           MinHeap<uint64_t> local;
+           for (size_t i = 0; i < HEAP_SIZE; ++i) {
+             local.insert(engine());
+           }
+           for (size_t i = 0; i < OPERATIONS; ++i) {
+             sum += local.peakMin();
+             local.deleteMin();
+             local.insert(engine());
+           }
+         }));
+  for (size_t processes : {1, 2, 4}) {
+    report("SharedMinHeap, " + std::to_string(processes) +
+               (processes == 1 ? " process" : " processes"),
+           bestOf(TRIALS, [&] {
+             std::vector<pid_t> children;
+             for (size_t process = 0; process < processes; ++process) {
+               pid_t child = fork();
+               if (child == 0) {
+                 // The child inherits the mapping, so it uses the same heap
+                 std::default_random_engine mine(process);
+                 uint64_t value = 0;
+                 for (size_t i = 0; i < OPERATIONS / processes; ++i) {
+                   heap.popMin(value);
+                   heap.insert(value + mine() % 1024);
+                 }
+                 _exit(0);
+               }
+               children.push_back(child);
+             }
+             for (pid_t child : children) {
+               waitpid(child, nullptr, 0);
+             }
+           }));
+  }
+  sum += heap.size() + heap.peakMin();
+  SharedMinHeap<uint64_t>::unlink(NAME);
+  std::cout << "  (checksum " << sum << ")" << std::endl;
+}
+
+/**
+ * \brief Measures how the size of a commit batch affects a DurableMinHeap
+ * \details Each operation is an insert or, every third time, a deleteMin.
+ * The log is compacted into a snapshot every COMPACT_AFTER records, so the
+ * background snapshots are included in the times.
+ */
+void durableBench() {
+  const size_t OPERATIONS = 1 << 14;
+  const size_t COMPACT_AFTER = 1 << 12;
+  const size_t TRIALS = 2;
+  const std::string DIRECTORY =
+      (std::filesystem::temp_directory_path() /
+       ("cs70-heap-bench-" + std::to_string(getpid())))
+          .string();
+
+  std::vector<uint64_t> numbers(OPERATIONS);
+  std::default_random_engine engine(46);
+  for (uint64_t& number : numbers) {
+    number = engine();
+  }
+
+  // Runs the workload on a heap
+  size_t sum = 0;
+  auto run = [&](auto& heap) {
+    for (size_t i = 0; i < OPERATIONS; ++i) {
+      if (i % 3 == 2) {
+        sum += heap.peakMin();
+        heap.deleteMin();
+      } else {
+        heap.insert(numbers[i]);
+      }
+    }
+  };
+
+  std::cout << "durable (" << OPERATIONS << " operations)" << std::endl;
+  report("MinHeap, not durable", bestOf(TRIALS, [&] {
+           MinHeap<uint64_t> heap;
+           run(heap);
+         }));
+  for (size_t batchSize : {1, 16, 256, 4096}) {
+    double ms = bestOf(TRIALS, [&] {
+      std::filesystem::remove_all(DIRECTORY);
+      DurableMinHeap<uint64_t> heap(DIRECTORY, batchSize, COMPACT_AFTER);
+      run(heap);
+      heap.sync();
+    });
+    report("DurableMinHeap, batches of " + std::to_string(batchSize), ms);
+    std::cout << "  operations per second: " << OPERATIONS / ms * 1000
+              << std::endl;
+  }
+  std::filesystem::remove_all(DIRECTORY);
+  std::cout << "  (checksum " << sum << ")" << std::endl;
+}
+
+/**
+ * \brief Shows the tail latency of insert and deleteMin, and what timing
+ * every operation costs
+ * \details The benchmarks are not built with MINHEAP_LATENCY_HISTOGRAM, so
+ * this times each operation from outside with the same clock and histogram
+ * the hooks use.  The slowest inserts and deletes are the ones which resize
+ * array_.
+ */
+void latencyBench() {
+  const size_t HEAP_SIZE = 1 << 20;
+  const size_t TRIALS = 3;
+
+  std::vector<size_t> numbers(HEAP_SIZE);
+  std::default_random_engine engine(47);
+  for (size_t& number : numbers) {
+    number = engine();
+  }
+
+  size_t sum = 0;
+  std::cout << "latency (" << HEAP_SIZE << " elements)" << std::endl;
+  report("insert and deleteMin, untimed", bestOf(TRIALS, [&] {
+           MinHeap<size_t> heap;
+           for (size_t number : numbers) {
+             heap.insert(number);
+           }
+           while (!heap.empty()) {
+             sum += heap.peakMin();
+             heap.deleteMin();
+           }
+         }));
+
+  LatencyHistogram<> inserts;
+  LatencyHistogram<> deletes;
+  auto timed = [](LatencyHistogram<>& histogram, auto operation) {
+    auto start = std::chrono::steady_clock::now();
+    operation();
+    std::chrono::nanoseconds elapsed = std::chrono::steady_clock::now() - start;
+    histogram.record(elapsed.count());
+  };
+  report("insert and deleteMin, each timed", bestOf(TRIALS, [&] {
+           inserts.reset();
+           deletes.reset();
+           MinHeap<size_t> heap;
+           for (size_t number : numbers) {
+             timed(inserts, [&] { heap.insert(number); });
+           }
+           while (!heap.empty()) {
+             sum += heap.peakMin();
+             timed(deletes, [&] { heap.deleteMin(); });
+           }
+         }));
+  std::cout << "  insert: ";
+  inserts.writeJson(std::cout) << std::endl;
+  std::cout << "  deleteMin: ";
+  deletes.writeJson(std::cout) << std::endl;
+  std::cout << "  (checksum " << sum << ")" << std::endl;
+}
+
+/**
+ * \class BlockingPriorityQueue
+ * \brief The usual way to share a bounded priority queue between threads: a
+ * MinHeap guarded by a mutex, with condition variables for waiting while it
+ * is full or empty.  channelBench compares PriorityChannel against it.
+ */
+class BlockingPriorityQueue {
+ public:
+  explicit BlockingPriorityQueue(size_t capacity) : capacity_(capacity) {}
+
+  void push(uint64_t value) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    notFull_.wait(lock, [this] { return heap_.size() < capacity_; });
+    heap_.insert(value);
+    notEmpty_.notify_one();
+  }
+
+  std::optional<uint64_t> pop() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    notEmpty_.wait(lock, [this] { return !heap_.empty() || closed_; });
+    if (heap_.empty()) {
+      return std::nullopt;
+    }
+    uint64_t value = heap_.peakMin();
+    heap_.deleteMin();
+    notFull_.notify_one();
+    return value;
+  }
+
+  void close() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    closed_ = true;
+    notEmpty_.notify_all();
+  }
+
+ private:
+  size_t capacity_;
+  std::mutex mutex_;
+  std::condition_variable notFull_;
+  std::condition_variable notEmpty_;
+  MinHeap<uint64_t> heap_;
+  bool closed_ = false;
+};
+
+/**
+ * \brief Sends a slice of numbers into a PriorityChannel for channelBench
+ * \param channel     The channel
+ * \param numbers     The numbers
+ * \param first       The index of the first number to send
+ * \param count       The number of numbers to send
+ * \param producers   Counts the producers still running; the last closes
+ * the channel
+ */
+Task channelProducer(PriorityChannel<uint64_t>& channel,
+                     const std::vector<uint64_t>& numbers, size_t first,
+                     size_t count, std::atomic<size_t>& producers) {
+  for (size_t i = first; i < first + count; ++i) {
+    co_await channel.send(numbers[i]);
+  }
+  if (--producers == 0) {
+    channel.close();
+  }
+}
+
+/**
+ * \brief Receives from a PriorityChannel until it is closed, for
+ * channelBench
+ * \param channel   The channel
+ * \param sum       Where to add the numbers
+ * \param done      Counted down once the channel is closed and empty
+ */
+Task channelConsumer(PriorityChannel<uint64_t>& channel,
+                     std::atomic<size_t>& sum, std::latch& done) {
+  size_t mine = 0;
+  while (std::optional<uint64_t> value = co_await channel.receive()) {
+    mine += *value;
+  }
+  sum += mine;
+  done.count_down();
+}
+
+/**
+ * \brief Compares PriorityChannel with a mutex and condition variable queue
+ * \details Producers send every number through a small bounded queue to
+ * consumers.  The queue is usually full, so most sends wait for room.  The
+ * BlockingPriorityQueue blocks a whole thread each time, while a
+ * PriorityChannel suspends just the coroutine and its executor runs another.
+ */
+void channelBench() {
+  const size_t ITEMS = 1 << 18;
+  const size_t CAPACITY = 64;
+  const size_t TRIALS = 3;
+
+  std::vector<uint64_t> numbers(ITEMS);
+  std::default_random_engine engine(48);
+  for (uint64_t& number : numbers) {
+    number = engine() % 1000000;
+  }
+
+  std::atomic<size_t> sum = 0;
+  std::cout << "channel (" << ITEMS << " items, capacity " << CAPACITY << ")"
+            << std::endl;
+  for (size_t pairs : {1, 4}) {
+    std::string pipes = std::to_string(pairs) + " producer" +
+                        (pairs == 1 ? "" : "s") + ", " +
+                        std::to_string(pairs) + " consumer" +
+                        (pairs == 1 ? "" : "s");
+    report("mutex/condition_variable queue, threads, " + pipes,
+           bestOf(TRIALS, [&] {
+             BlockingPriorityQueue queue(CAPACITY);
+             std::vector<std::thread> threads;
+             std::atomic<size_t> producers = pairs;
+             for (size_t thread = 0; thread < pairs; ++thread) {
+               threads.emplace_back([&, thread] {
+                 for (size_t i = thread * ITEMS / pairs;
+                      i < (thread + 1) * ITEMS / pairs; ++i) {
+                   queue.push(numbers[i]);
+                 }
+                 if (--producers == 0) {
+                   queue.close();
+                 }
+               });
+               threads.emplace_back([&] {
+                 size_t mine = 0;
+                 while (std::optional<uint64_t> value = queue.pop()) {
+                   mine += *value;
+                 }
+                 sum += mine;
+               });
+             }
+             for (std::thread& thread : threads) {
+               thread.join();
+             }
+           }));
+
+    // Spawns the coroutines on an executor and returns once they finish
+    auto runChannel = [&](Executor& executor, auto wait) {
+      PriorityChannel<uint64_t> channel(executor, CAPACITY);
+      std::atomic<size_t> producers = pairs;
+      std::latch done(pairs);
+      for (size_t pipe = 0; pipe < pairs; ++pipe) {
+        spawn(executor, channelConsumer(channel, sum, done));
+        spawn(executor,
+              channelProducer(channel, numbers, pipe * ITEMS / pairs,
+                              ITEMS / pairs, producers));
+      }
+      wait();
+      done.wait();
+    };
+    report("PriorityChannel, SingleThreadExecutor, " + pipes,
+           bestOf(TRIALS, [&] {
+             SingleThreadExecutor executor;
+             runChannel(executor, [&] { executor.run(); });
+           }));
+    for (size_t threads : {1, 2, 4}) {
+      report("PriorityChannel, ThreadPoolExecutor with " +
+                 std::to_string(threads) +
+                 (threads == 1 ? " thread, " : " threads, ") + pipes,
+             bestOf(TRIALS, [&] {
+               ThreadPoolExecutor executor(threads);
+               runChannel(executor, [] {});
+               executor.shutdown();
+             }));
+    }
+  }
+  std::cout << "  (checksum " << sum << ")" << std::endl;
+}
+
+/**
+ * \struct PlainString
+ * \brief A std::string without a MinHeapKeyPrefix, so that a MinHeap of
+ * them shows what MinHeap<std::string> costs without the prefixes
+ */
+struct PlainString {
+  std::string value;
+
+  bool operator<(const PlainString& rhs) const { return value < rhs.value; }
+  bool operator==(const PlainString& rhs) const {
+    return value == rhs.value;
+  }
+};
+
+/**
+ * \brief Measures how much the key prefixes of MinHeap<std::string> help
+ * \details Random words mostly differ within their first 8 bytes, so their
+ * prefixes settle almost every comparison.  URLs from one site share far
+ * more than 8 bytes, so every comparison ties and reads both strings anyway.
+ */
+void prefixBench() {
+  const size_t HEAP_SIZE = 1 << 18;
+  const size_t TRIALS = 3;
+
+  std::default_random_engine engine(49);
+  auto randomLetters = [&](size_t length) {
+    std::string letters;
+    for (size_t i = 0; i < length; ++i) {
+      letters += static_cast<char>('a' + engine() % 26);
+    }
+    return letters;
+  };
+  std::vector<std::string> words(HEAP_SIZE);
+  std::vector<std::string> urls(HEAP_SIZE);
+  for (size_t i = 0; i < HEAP_SIZE; ++i) {
+    words[i] = randomLetters(3 + engine() % 8);
+    urls[i] = "https://www.example.com/catalog/products/" + randomLetters(12);
+  }
+
+  // Inserts every string and then removes them all
+  size_t sum = 0;
+  auto run = [&](auto& heap, const std::vector<std::string>& strings) {
+    for (const std::string& string : strings) {
+      heap.insert({string});
+    }
+    while (!heap.empty()) {
+      sum += heap.size();
+      heap.deleteMin();
+    }
+  };
+
+  std::cout << "prefix (" << HEAP_SIZE << " strings)" << std::endl;
+  for (const auto& [name, strings] :
+       {std::pair<std::string, const std::vector<std::string>*>{"words",
+                                                                &words},
+        {"URLs", &urls}}) {
+    report(name + ", MinHeap<std::string> with prefixes", bestOf(TRIALS, [&] {
+             MinHeap<std::string> heap;
+             run(heap, *strings);
+           }));
+    report(name + ", MinHeap<PlainString> without", bestOf(TRIALS, [&] {
+             MinHeap<PlainString> heap;
+             run(heap, *strings);
+           }));
+  }
+  std::cout << "  (checksum " << sum << ")" << std::endl;
+}
+
+/**
+ * \struct BranchingKey
+ * \brief A uint64_t wrapped in a struct, which MinHeap does not know to be
+ * cheap to compare, so that a MinHeap of them bubbles down with the
+ * branching version of bubbleDown
+ */
+struct BranchingKey {
+  uint64_t value;
+
+  BranchingKey(uint64_t val) : value(val) {}  // NOLINT(runtime/explicit)
+  bool operator<(const BranchingKey& rhs) const { return value < rhs.value; }
+  bool operator==(const BranchingKey& rhs) const {
+    return value == rhs.value;
+  }
+};
+
+/**
+ * \brief Compares bubbling down with and without a branch on which child is
+ * smaller
+ * \details With random keys, each level of bubbleDown picks the left child
+ * half of the time, which the processor cannot predict.  BranchingKey always
+ * branches, while uint64_t only avoids the branch if the benchmark is built
+ * with -DMINHEAP_BRANCH_FREE_SIFT; otherwise the two should match.
+ */
+void branchFreeBench() {
+  const size_t OPERATIONS = 1 << 21;
+  const size_t TRIALS = 3;
+
+  std::default_random_engine engine(50);
+  std::vector<uint64_t> numbers(OPERATIONS);
+  for (uint64_t& number : numbers) {
+    number = engine();
+  }
+
+  // Fills a heap with size numbers, then replaces the smallest element with
+  // the next number until OPERATIONS numbers have been used
+  size_t sum = 0;
+  auto run = [&](auto& heap, size_t size) {
+    for (size_t i = 0; i < size; ++i) {
+      heap.insert(numbers[i]);
+    }
+    for (size_t i = size; i < OPERATIONS; ++i) {
+      sum += heap.size();
+      heap.deleteMin();
+      heap.insert(numbers[i]);
+    }
+  };
+
+  std::cout << "branchfree (" << OPERATIONS << " operations)" << std::endl;
+#ifdef MINHEAP_BRANCH_FREE_SIFT
+  std::string mode = "branch-free";
+#else
+  std::string mode = "not built with MINHEAP_BRANCH_FREE_SIFT";
+#endif
+  for (size_t size : {1 << 10, 1 << 16, 1 << 20}) {
+    std::string elements = std::to_string(size) + " elements";
+    double branching = bestOf(TRIALS, [&] {
+      MinHeap<BranchingKey> heap;
+      run(heap, size);
+    });
+    report(elements + ", BranchingKey", branching);
+    double branchFree = bestOf(TRIALS, [&] {
+      MinHeap<uint64_t> heap;
+      run(heap, size);
+    });
+    report(elements + ", uint64_t, " + mode, branchFree);
+    std::cout << "  operations per second: "
+              << (OPERATIONS - size) / branching * 1000 << " branching, "
+              << (OPERATIONS - size) / branchFree * 1000 << " uint64_t"
+              << std::endl;
+  }
+  std::cout << "  (checksum " << sum << ")" << std::endl;
+}
+
+int main(int argc, char** argv) {
+  struct Benchmark {
+    const char* name;
+    void (*run)();
+  };
+  const Benchmark BENCHMARKS[] = {
+      {"reduce", reduceBench},
+      {"small", smallHeapBench},
+      {"build", buildBench},
+      {"cancel", cancelBench},
+      {"minmax", minMaxBench},
+      {"paged", pagedBench},
+      {"timer", timerBench},
+      {"merge", mergeBench},
+      {"resize", resizeBench},
+      {"prefetch", prefetchBench},
+      {"keyed", keyedBench},
+      {"pool", poolBench},
+      {"multiqueue", multiQueueBench},
+      {"quantile", quantileBench},
+      {"shortestpath", shortestPathBench},
+      {"huffman", huffmanBench},
+      {"persistent", persistentBench},
+      {"view", viewBench},
+      {"shared", sharedBench},
+      {"durable", durableBench},
+      {"latency", latencyBench},
+      {"channel", channelBench},
+      {"prefix", prefixBench},
+      {"branchfree", branchFreeBench},
+  };
+
+  for (const Benchmark& benchmark : BENCHMARKS) {
+    bool selected = argc == 1;
+    for (int i = 1; i < argc; ++i) {
+      selected = selected || std::strcmp(argv[i], benchmark.name) == 0;
+    }
+    if (selected) {
+      benchmark.run();
+    }
+  }
+
+  return 0;
+}
@@ -7,21 +7,85 @@
  * testing
  */
 
+#include <algorithm>
 #include <array>
 #include <cassert>
+#include <cstdlib>
 #include <iostream>
+#include <iterator>
+#include <list>
+#include <new>
 #include <random>
 #include <sstream>
 #include <string>
+#include <vector>
+#include "fixedminheap.hpp"
 #include "minheap.hpp"
 
+/** \brief The number of calls to operator new made by the whole program */
+size_t allocationCount = 0;
+
+/** \brief How many of those calls asked for aligned memory */
+size_t alignedAllocationCount = 0;
+
+// We replace the global operator new so that tests can check whether an
+// operation allocates memory
+void* operator new(size_t size) {
+  ++allocationCount;
+  void* memory = std::malloc(size == 0 ? 1 : size);
+  if (memory == nullptr) {
+    throw std::bad_alloc();
+  }
+  return memory;
+}
+
+void operator delete(void* memory) noexcept { std::free(memory); }
+
+void operator delete(void* memory, size_t) noexcept { std::free(memory); }
+
+// SlotAllocator asks for cache-line-aligned arrays, which go through the
+// aligned forms of operator new instead, so we count those as well
+void* operator new(size_t size, std::align_val_t alignment) {
+  ++allocationCount;
+  ++alignedAllocationCount;
+  size_t align = static_cast<size_t>(alignment);
+
+  // aligned_alloc requires the size to be a multiple of the alignment
+  size_t rounded = (size + align - 1) / align * align;
+  void* memory = std::aligned_alloc(align, rounded == 0 ? align : rounded);
+  if (memory == nullptr) {
+    throw std::bad_alloc();
+  }
+  return memory;
+}
+
+void* operator new[](size_t size, std::align_val_t alignment) {
+  return operator new(size, alignment);
+}
+
+void operator delete(void* memory, std::align_val_t) noexcept {
+  std::free(memory);
+}
+
+void operator delete(void* memory, size_t, std::align_val_t) noexcept {
+  std::free(memory);
+}
+
+void operator delete[](void* memory, std::align_val_t) noexcept {
+  std::free(memory);
+}
+
+void operator delete[](void* memory, size_t, std::align_val_t) noexcept {
+  std::free(memory);
+}
+
 /**
  * \brief Performs a MinHeap::insert and checks for consistency
  * \param heap    The heap upon which insert is called
  * \param val     The value to insert into heap
  */
-template <typename T>
-void insertTestHelper(MinHeap<T>& heap, const T& val) {
+template <typename T, size_t INLINE_CAPACITY>
+void insertTestHelper(MinHeap<T, INLINE_CAPACITY>& heap, const T& val) {
   size_t size = heap.size();
   assert(!heap.exists(val));
 
@@ -34,8 +98,8 @@ void insertTestHelper(MinHeap<T>& heap, const T& val) {
  * \brief Performs a MinHeap::deleteMin and checks for consistency
  * \param heap    The heap upon which deleteMin is called
  */
-template <typename T>
-void deleteTestHelper(MinHeap<T>& heap) {
+template <typename T, size_t INLINE_CAPACITY>
+void deleteTestHelper(MinHeap<T, INLINE_CAPACITY>& heap) {
   size_t size = heap.size();
   assert(size > 0);
   T min = heap.peakMin();
@@ -253,6 +317,30 @@ void iteratorTest() {
     assert(i == j);
     --c;
   }
+
+  // Random access
+  MinHeap<std::string>::const_iterator first = heap.begin();
+  MinHeap<std::string>::const_iterator last = heap.end();
+  assert(last - first == 26);
+  assert(std::distance(first, last) == 26);
+  assert(first[3] == "d");
+  assert(*(first + 25) == "z");
+  assert(*(25 + first) == "z");
+  assert(*(last - 1) == "z");
+  assert(first < last && last > first);
+  assert(first <= first && first >= first);
+  assert(!(last < first) && !(first > last));
+
+  MinHeap<std::string>::const_iterator k = first;
+  k += 10;
+  assert(*k == "k");
+  k -= 4;
+  assert(*k == "g");
+  assert(*k++ == "g");
+  assert(*k-- == "h");
+  assert(*k == "g");
+  std::advance(k, -6);
+  assert(k == first);
 }
 
 /**
@@ -286,10 +374,424 @@ void heapSortTest() {
   }
 }
 
+/**
+ * \brief Checks that every element of a MinHeap is no smaller than its parent
+ * \param heap    The heap to check
+ * \return True if heap satisfies the heap property
+ */
+template <typename T, size_t INLINE_CAPACITY>
+bool isValidHeap(const MinHeap<T, INLINE_CAPACITY>& heap) {
+  // The iterator visits array_ in order, so heap.begin()[i - 1] is array_[i]
+  for (size_t i = 2; i <= heap.size(); ++i) {
+    if (heap.begin()[i - 1] < heap.begin()[i / 2 - 1]) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/**
+ * \brief Runs several ad hoc tests of the MinHeap bulk-build constructor
+ */
+void bulkBuildTest() {
+  const size_t SEED = 1770;
+  std::stringstream ss;
+
+  // Build a heap out of a std::list, whose iterators are not random-access
+  std::list<std::string> fruits = {"pear", "fig", "kiwi", "date", "lime"};
+  MinHeap<std::string> h1(fruits.begin(), fruits.end());
+  assert(h1.size() == 5 && h1.peakMin() == "date");
+  h1.print(ss, true);
+  assert(ss.str() == "[x,date,fig,kiwi,pear,lime,_,_]");
+  insertTestHelper(h1, std::string("apple"));
+  assert(h1.peakMin() == "apple");
+
+  MinHeap<std::string> empty(fruits.end(), fruits.end(), 4);
+  assert(empty.empty());
+
+  // Every number of threads must produce a valid heap with the same elements
+  for (size_t size : {1, 2, 7, 100, 1000, 4097}) {
+    std::vector<size_t> numbers(size);
+    for (size_t i = 0; i < size; ++i) {
+      numbers[i] = i;
+    }
+    std::shuffle(numbers.begin(), numbers.end(),
+                 std::default_random_engine(SEED + size));
+
+    MinHeap<size_t> serial(numbers.begin(), numbers.end());
+    assert(isValidHeap(serial));
+    for (size_t threads : {2, 3, 8, 32}) {
+      MinHeap<size_t> parallel(numbers.begin(), numbers.end(), threads);
+      assert(isValidHeap(parallel));
+      assert(parallel == serial);
+    }
+
+    // Inline elements are copied serially before the threads start
+    MinHeap<size_t, 16> inlined(numbers.begin(), numbers.end(), 3);
+    assert(isValidHeap(inlined));
+    for (size_t i = 0; i < size; ++i) {
+      assert(inlined.peakMin() == i);
+      inlined.deleteMin();
+    }
+
+    // Prefetching must never change the result, only the speed
+    MinHeap<size_t, 0, PrefetchAhead<3>> prefetched(numbers.begin(),
+                                                    numbers.end(), 2);
+    for (size_t i = 0; i < size; ++i) {
+      assert(prefetched.peakMin() == i);
+      prefetched.deleteMin();
+    }
+  }
+}
+
+/**
+ * \brief Runs several ad hoc tests of a MinHeap whose slot array is large
+ * enough to be mapped with mmap and grown with mremap
+ */
+void largeArrayTest() {
+  const size_t SIZE = 3 * (SlotAllocator<size_t*>::LARGE_ARRAY_BYTES /
+                           sizeof(size_t*));
+
+  // Inserting in descending order bubbles every element to the root, so the
+  // slots move around as the array grows through several remaps
+  MinHeap<size_t> heap;
+  for (size_t i = SIZE; i > 0; --i) {
+    heap.insert(i);
+  }
+  assert(heap.size() == SIZE && isValidHeap(heap));
+
+  // Shrinking crosses back from mapped arrays to ordinary ones
+  for (size_t i = 1; i <= SIZE; ++i) {
+    assert(heap.peakMin() == i);
+    heap.deleteMin();
+  }
+  assert(heap.empty());
+}
+
+/**
+ * \brief Runs several ad hoc tests of MinHeap::erase and MinHeap::eraseIf
+ */
+void eraseTest() {
+  std::stringstream ss;
+
+  // Erasing leaves a placeholder in array_ until it reaches the top
+  MinHeap<std::string> h1;
+  for (std::string color : {"blue", "green", "orange", "red", "yellow"}) {
+    h1.insert(color);
+  }
+  assert(h1.erase("orange"));
+  assert(!h1.erase("orange"));
+  assert(!h1.erase("purple"));
+  assert(h1.size() == 4 && !h1.exists("orange"));
+  h1.print(ss);
+  assert(ss.str() == "[blue,green,red,yellow]");
+  ss.str(std::string());
+  h1.print(ss, true);
+  assert(ss.str() == "[x,blue,green,-,red,yellow,_,_]");
+
+  // Copies leave erased elements out
+  MinHeap<std::string> h2 = h1;
+  MinHeap<std::string> h3;
+  swap(h2, h3);
+  assert(h2.empty() && h3 == h1);
+  ss.str(std::string());
+  h3.print(ss, true);
+  assert(ss.str() == "[x,blue,green,red,yellow,_,_,_]");
+
+  // Iterators never visit erased elements, even through a const MinHeap, so
+  // random-access algorithms see exactly size() elements.  One erased
+  // element out of four is too few to compact array_ by itself.
+  assert(h3.erase("red"));
+  const MinHeap<std::string>& constH3 = h3;
+  assert(std::distance(constH3.begin(), constH3.end()) == 3);
+  assert(std::find(constH3.begin(), constH3.end(), "red") == constH3.end());
+  assert(h3.erase("yellow"));
+  assert(static_cast<size_t>(h3.end() - h3.begin()) == h3.size());
+  assert(h3.size() == 2 && h3.peakMin() == "blue");
+
+  // Erasing the smallest element removes it immediately
+  assert(h1.erase("blue"));
+  assert(h1.peakMin() == "green" && h1.size() == 3);
+  ss.str(std::string());
+  h1.print(ss, true);
+  assert(ss.str() == "[x,green,red,-,yellow,_,_,_]");
+  for (std::string color : {"green", "red", "yellow"}) {
+    assert(h1.peakMin() == color);
+    deleteTestHelper(h1);
+  }
+  assert(h1.empty());
+
+  // Only one copy of a duplicate value is erased
+  MinHeap<int, 4> h4;
+  for (int i : {5, 1, 5, 3}) {
+    h4.insert(i);
+  }
+  assert(h4.erase(5));
+  assert(h4.exists(5) && h4.size() == 3);
+  assert(h4.erase(5));
+  assert(!h4.exists(5) && h4.size() == 2);
+
+  // Erasing many elements compacts array_, after which iterators only visit
+  // the remaining elements
+  MinHeap<size_t> h5;
+  for (size_t i = 0; i < 100; ++i) {
+    h5.insert(i);
+  }
+  assert(h5.eraseIf([](size_t i) { return i % 10 == 7; }) == 10);
+  assert(h5.size() == 90);
+  assert(h5.eraseIf([](size_t i) { return i % 2 == 1; }) == 40);
+  assert(h5.size() == 50);
+  assert(h5.end() - h5.begin() == 50);
+  assert(isValidHeap(h5));
+  insertTestHelper(h5, size_t{7});
+  for (size_t i = 0; i < 100; i += 2) {
+    assert(h5.peakMin() == i);
+    h5.deleteMin();
+    if (i == 6) {
+      assert(h5.peakMin() == 7);
+      h5.deleteMin();
+    }
+  }
+  assert(h5.empty());
+
+  // compact can also be called directly
+  MinHeap<size_t> h6;
+  for (size_t i = 0; i < 10; ++i) {
+    h6.insert(i);
+  }
+  h6.erase(9);
+  ss.str(std::string());
+  h6.print(ss, true);
+  assert(ss.str() == "[x,0,1,2,3,4,5,6,7,8,-,_,_,_,_,_]");
+  h6.compact();
+  ss.str(std::string());
+  h6.print(ss, true);
+  assert(ss.str() == "[x,0,1,2,3,4,5,6,7,8,_,_,_,_,_,_]");
+  assert(h6.end() - h6.begin() == 9 && h6.size() == 9);
+  assert(isValidHeap(h6));
+}
+
+/**
+ * \brief Runs several ad hoc tests of MinHeap's inline storage and FixedMinHeap
+ */
+void inlineStorageTest() {
+  const std::array<std::string, 6> WORDS = {"pear", "fig",  "kiwi",
+                                            "date", "lime", "plum"};
+  std::stringstream ss;
+
+  // Up to INLINE_CAPACITY elements never allocate
+  size_t allocations = allocationCount;
+  MinHeap<int, 4> small;
+  for (int i = 4; i > 0; --i) {
+    small.insert(i);
+  }
+  assert(allocationCount == allocations);
+  assert(small.peakMin() == 1);
+  ss.str(std::string());
+  small.print(ss, true);
+  assert(ss.str() == "[x,1,2,3,4]");
+
+  // The fifth element spills onto the heap, and so does array_, which
+  // SlotAllocator allocates with the aligned operator new
+  size_t alignedAllocations = alignedAllocationCount;
+  small.insert(0);
+  assert(allocationCount > allocations);
+  assert(alignedAllocationCount == alignedAllocations + 1);
+  assert(small.size() == 5);
+  for (int i = 0; i <= 4; ++i) {
+    assert(small.peakMin() == i);
+    small.deleteMin();
+  }
+  assert(small.empty());
+  ss.str(std::string());
+  small.print(ss, true);
+  assert(ss.str() == "[x,_,_,_,_]");
+
+  // Freed inline slots are reused
+  allocations = allocationCount;
+  small.insert(7);
+  small.insert(3);
+  assert(allocationCount == allocations);
+
+  // Copy, assignment, and swap between inline and spilled MinHeaps
+  MinHeap<std::string, 2> h1;
+  MinHeap<std::string, 2> h2;
+  for (std::string word : WORDS) {
+    insertTestHelper(h1, word);
+  }
+  insertTestHelper(h2, std::string("yam"));
+  MinHeap<std::string, 2> h3 = h1;
+  assert(h1 == h3);
+  swap(h1, h2);
+  assert(h1.size() == 1 && h1.peakMin() == "yam");
+  assert(h2 == h3);
+  h3 = h1;
+  assert(h3.size() == 1 && h3.peakMin() == "yam");
+  h1 = h2;
+  for (std::string word : {"date", "fig", "kiwi", "lime", "pear", "plum"}) {
+    assert(h1.peakMin() == word);
+    deleteTestHelper(h1);
+  }
+
+  // The default MinHeap does not allocate until its first insert
+  allocations = allocationCount;
+  MinHeap<double> empty;
+  assert(allocationCount == allocations);
+
+  // FixedMinHeap never allocates and refuses elements once full
+  allocations = allocationCount;
+  FixedMinHeap<std::string, 3> fixed;
+  assert(fixed.capacity() == 3);
+  assert(fixed.insert("s") && fixed.insert("m") && fixed.insert("l"));
+  assert(fixed.full());
+  assert(!fixed.insert("xl"));
+  assert(fixed.size() == 3 && !fixed.exists("xl"));
+  FixedMinHeap<std::string, 3> fixedCopy = fixed;
+  assert(fixedCopy == fixed);
+  fixed.deleteMin();
+  assert(fixedCopy != fixed);
+  assert(fixed.peakMin() == "m");
+  assert(allocationCount == allocations);
+  ss.str(std::string());
+  ss << fixedCopy;
+  assert(ss.str() == "[l,s,m]");
+}
+
+/**
+ * \brief Sorts an array by inserting it into a MinHeap and removing the min
+ * \param values    The values to sort
+ * \return A sorted copy of values
+ * \note This function is constexpr, so it can run at compile time
+ */
+template <typename Heap, size_t N>
+constexpr std::array<int, N> heapSort(const std::array<int, N>& values) {
+  Heap heap;
+  for (int value : values) {
+    heap.insert(value);
+  }
+
+  std::array<int, N> sorted = {};
+  for (size_t i = 0; i < N; ++i) {
+    sorted[i] = heap.peakMin();
+    heap.deleteMin();
+  }
+  return sorted;
+}
+
+/**
+ * \brief Exercises the rest of the MinHeap interface in a constexpr function
+ * \return True if every check passed
+ */
+constexpr bool constexprChecks() {
+  MinHeap<int, 2> h1;
+  for (int i : {4, 8, 15, 16, 23, 42}) {
+    h1.insert(i);
+  }
+
+  // Iteration, including random access
+  int sum = 0;
+  for (int i : h1) {
+    sum += i;
+  }
+  bool passed = sum == 108 && h1.end() - h1.begin() == 6 && h1.begin()[0] == 4;
+
+  // Copying, swapping, and searching
+  MinHeap<int, 2> h2 = h1;
+  MinHeap<int, 2> h3;
+  h3.insert(7);
+  swap(h2, h3);
+  passed = passed && h2.size() == 1 && h3 == h1 && h3.exists(23);
+  h2 = h3;
+  h3.deleteMin();
+  return passed && h2 == h1 && h3 != h1 && !h3.exists(4);
+}
+
+/**
+ * \brief Runs several ad hoc tests of the key prefixes MinHeap keeps for
+ * std::string
+ */
+void keyPrefixTest() {
+  using Prefix = MinHeapKeyPrefix<std::string>;
+  static_assert(Prefix::ENABLED && !MinHeapKeyPrefix<int>::ENABLED);
+  static_assert(Prefix::of("") == 0);
+  static_assert(Prefix::of("a") == 0x6100000000000000);
+  static_assert(Prefix::of("abcdefgh") == 0x6162636465666768);
+
+  // The fast path for long strings must agree with the byte-by-byte one
+  assert(Prefix::of("abcdefghXYZ") == Prefix::of("abcdefgh"));
+  assert(Prefix::of(std::string("a\0b", 3)) == 0x6100620000000000);
+
+  // Strings which tie on their first 8 bytes, strings which differ only in
+  // trailing zero bytes, and bytes above 127 (which std::string compares
+  // as unsigned)
+  std::vector<std::string> words = {
+      "https://example.com/b", "https://example.com/a", "https://example.com",
+      "https://", "https:/", std::string("a\0", 2), "a", std::string(1, '\0'),
+      "", "\xff", "\x80z", "zzzzzzzzz", "zzzzzzzz", "zzzzzzz"};
+  std::default_random_engine engine(49);
+  for (size_t i = 0; i < 1000; ++i) {
+    std::string word;
+    for (size_t length = engine() % 12; length > 0; --length) {
+      word += "ab\0\xff"[engine() % 4];
+    }
+    words.push_back(word);
+  }
+
+  MinHeap<std::string> heap(words.begin(), words.end());
+  assert(isValidHeap(heap));
+  for (const std::string& word : words) {
+    assert(heap.exists(word));
+  }
+  assert(!heap.exists("https://example.com/c"));
+  assert(heap.erase("https://example.com/a"));
+  assert(!heap.exists("https://example.com/a"));
+  heap.insert("https://example.com/a");
+
+  // Prefetching steps through array_ one cache line at a time, and a
+  // PrefixedSlot is twice the size of a pointer
+  MinHeap<std::string, 0, PrefetchAhead<2>> prefetched(words.begin(),
+                                                       words.end());
+
+  std::sort(words.begin(), words.end());
+  for (const std::string& word : words) {
+    assert(heap.peakMin() == word);
+    heap.deleteMin();
+    assert(prefetched.peakMin() == word);
+    prefetched.deleteMin();
+  }
+  assert(heap.empty() && prefetched.empty());
+}
+
+/**
+ * \brief Runs several ad hoc tests of MinHeap in constant expressions
+ */
+void constexprTest() {
+  // Because SORTED is constexpr, the heap sort runs entirely at compile time
+  // and SORTED is embedded in the program as a constant
+  constexpr std::array<int, 8> SORTED =
+      heapSort<MinHeap<int>>(std::array<int, 8>{9, 2, 7, 4, 5, 0, 3, 1});
+  static_assert(SORTED == std::array<int, 8>{0, 1, 2, 3, 4, 5, 7, 9});
+  static_assert(heapSort<MinHeap<int, 4>>(std::array<int, 3>{3, 1, 2}) ==
+                std::array<int, 3>{1, 2, 3});
+  static_assert(constexprChecks());
+
+  // The same code must also work at run time
+  assert(constexprChecks());
+  std::array<int, 6> sorted =
+      heapSort<MinHeap<int, 4>>(std::array<int, 6>{6, 5, 4, 3, 2, 1});
+  assert((sorted == std::array<int, 6>{1, 2, 3, 4, 5, 6}));
+}
+
 int main() {
   coreTest();
   iteratorTest();
   heapSortTest();
+  bulkBuildTest();
+  largeArrayTest();
+  eraseTest();
+  inlineStorageTest();
+  keyPrefixTest();
+  constexprTest();
 
   std::cout << "All tests passed" << std::endl;
   return 0;
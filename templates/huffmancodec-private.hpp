@@ -0,0 +1,408 @@
+/**
+ * \file huffmancodec-private.hpp
+ * \copyright Matthew Calligaro
+ * \date January 2020
+ * \brief Provides the template implementation for the HuffmanCodec class
+ */
+
+// NOLINT(build/header_guard)
+
+#include <algorithm>
+#include <stdexcept>
+#include <vector>
+
+/*******************************************************************************
+ * HuffmanCodec implementation
+ ******************************************************************************/
+
+template <size_t BUFFER_SIZE>
+HuffmanCodec<BUFFER_SIZE>::HuffmanCodec()
+    : lengths_{},
+      codes_{},
+      firstCode_{},
+      lengthCount_{},
+      symbolStart_{},
+      sortedSymbols_{},
+      table_(size_t{1} << LOOKUP_BITS) {
+  // Nothing else to do
+}
+
+template <size_t BUFFER_SIZE>
+HuffmanCodec<BUFFER_SIZE>::HuffmanCodec(
+    const std::array<uint64_t, SYMBOLS>& counts)
+    : HuffmanCodec() {
+  // A very lopsided set of counts can make codes longer than we allow.
+  // Halving every count (but keeping it above 0) evens them out, and
+  // eventually every count is 1 and every code has length 8.
+  std::array<uint64_t, SYMBOLS> scaled = counts;
+  lengths_ = buildLengths(scaled);
+  while (*std::max_element(lengths_.begin(), lengths_.end()) >
+         MAX_CODE_LENGTH) {
+    for (uint64_t& count : scaled) {
+      if (count > 0) {
+        count = (count >> 1) | 1;
+      }
+    }
+    lengths_ = buildLengths(scaled);
+  }
+  assignCodes();
+}
+
+template <size_t BUFFER_SIZE>
+HuffmanCodec<BUFFER_SIZE> HuffmanCodec<BUFFER_SIZE>::fromLengths(
+    const std::array<uint8_t, SYMBOLS>& lengths) {
+  HuffmanCodec codec;
+  codec.lengths_ = lengths;
+  codec.assignCodes();
+  return codec;
+}
+
+template <size_t BUFFER_SIZE>
+const std::array<uint8_t, HuffmanCodec<BUFFER_SIZE>::SYMBOLS>&
+HuffmanCodec<BUFFER_SIZE>::lengths() const {
+  return lengths_;
+}
+
+template <size_t BUFFER_SIZE>
+uint64_t HuffmanCodec<BUFFER_SIZE>::encode(std::istream& in,
+                                           std::ostream& out) const {
+  BitWriter writer(out);
+  std::vector<char> buffer(BUFFER_SIZE);
+  uint64_t total = 0;
+  while (in.read(buffer.data(), BUFFER_SIZE) || in.gcount() > 0) {
+    size_t got = static_cast<size_t>(in.gcount());
+    for (size_t i = 0; i < got; ++i) {
+      uint8_t byte = static_cast<uint8_t>(buffer[i]);
+      writer.write(codes_[byte], lengths_[byte]);
+    }
+    total += got;
+  }
+  writer.flush();
+  return total;
+}
+
+template <size_t BUFFER_SIZE>
+void HuffmanCodec<BUFFER_SIZE>::decode(std::istream& in, std::ostream& out,
+                                       uint64_t count) const {
+  BitReader reader(in);
+  std::vector<char> buffer(BUFFER_SIZE);
+  size_t used = 0;
+  auto emit = [&](uint8_t byte) {
+    buffer[used++] = static_cast<char>(byte);
+    if (used == BUFFER_SIZE) {
+      out.write(buffer.data(), used);
+      used = 0;
+    }
+  };
+
+  uint64_t remaining = count;
+  while (remaining > 0) {
+    const DecodeEntry& entry = table_[reader.peek(LOOKUP_BITS)];
+    if (entry.count > 0 && entry.count <= remaining) {
+      for (size_t i = 0; i < entry.count; ++i) {
+        emit(entry.symbols[i]);
+      }
+      reader.skip(entry.bits);
+      remaining -= entry.count;
+    } else {
+      // Either the code is longer than LOOKUP_BITS, or we are at the end and
+      // need fewer bytes than the entry holds.  Either way, we decode a
+      // single byte the slow way.
+      size_t length = 0;
+      size_t symbol = decodeSlowly(reader.peek(MAX_CODE_LENGTH),
+                                   MAX_CODE_LENGTH, length);
+      if (symbol == SYMBOLS) {
+        throw std::runtime_error("HuffmanCodec: invalid code");
+      }
+      emit(static_cast<uint8_t>(symbol));
+      reader.skip(length);
+      --remaining;
+    }
+  }
+  out.write(buffer.data(), used);
+
+  if (reader.overran()) {
+    throw std::runtime_error("HuffmanCodec: encoded stream is too short");
+  }
+}
+
+template <size_t BUFFER_SIZE>
+void HuffmanCodec<BUFFER_SIZE>::compress(std::istream& in, std::ostream& out) {
+  // The first pass only counts the bytes
+  std::istream::pos_type start = in.tellg();
+  std::array<uint64_t, SYMBOLS> counts{};
+  std::vector<char> buffer(BUFFER_SIZE);
+  while (in.read(buffer.data(), BUFFER_SIZE) || in.gcount() > 0) {
+    for (std::streamsize i = 0; i < in.gcount(); ++i) {
+      ++counts[static_cast<uint8_t>(buffer[i])];
+    }
+  }
+  in.clear();
+  in.seekg(start);
+
+  // The length is written a byte at a time, lowest first, so that the
+  // format does not depend on the platform
+  uint64_t total = 0;
+  for (uint64_t count : counts) {
+    total += count;
+  }
+  char header[8];
+  for (size_t i = 0; i < 8; ++i) {
+    header[i] = static_cast<char>(total >> (8 * i));
+  }
+  out.write(header, 8);
+
+  HuffmanCodec codec(counts);
+  out.write(reinterpret_cast<const char*>(codec.lengths_.data()), SYMBOLS);
+  codec.encode(in, out);
+}
+
+template <size_t BUFFER_SIZE>
+void HuffmanCodec<BUFFER_SIZE>::decompress(std::istream& in,
+                                           std::ostream& out) {
+  char header[8];
+  std::array<uint8_t, SYMBOLS> lengths;
+  in.read(header, 8);
+  in.read(reinterpret_cast<char*>(lengths.data()), SYMBOLS);
+  if (!in) {
+    throw std::runtime_error("HuffmanCodec: missing header");
+  }
+
+  uint64_t total = 0;
+  for (size_t i = 0; i < 8; ++i) {
+    total |= uint64_t{static_cast<uint8_t>(header[i])} << (8 * i);
+  }
+  fromLengths(lengths).decode(in, out, total);
+}
+
+template <size_t BUFFER_SIZE>
+std::array<uint8_t, HuffmanCodec<BUFFER_SIZE>::SYMBOLS>
+HuffmanCodec<BUFFER_SIZE>::buildLengths(
+    const std::array<uint64_t, SYMBOLS>& counts) {
+  MinHeap<TreeNode> heap;
+  for (size_t symbol = 0; symbol < SYMBOLS; ++symbol) {
+    if (counts[symbol] > 0) {
+      heap.insert({counts[symbol], symbol});
+    }
+  }
+
+  std::array<uint8_t, SYMBOLS> lengths{};
+  if (heap.size() == 1) {
+    // A code needs at least one bit, even if there is only one byte
+    lengths[heap.peakMin().index] = 1;
+    return lengths;
+  }
+
+  // Join the two lightest subtrees until only one is left, remembering the
+  // parent of each.  A join always gets a larger index than its children.
+  const size_t NONE = 2 * SYMBOLS;
+  std::vector<size_t> parents(2 * SYMBOLS, NONE);
+  size_t next = SYMBOLS;
+  while (heap.size() > 1) {
+    TreeNode first = heap.peakMin();
+    heap.deleteMin();
+    TreeNode second = heap.peakMin();
+    heap.deleteMin();
+    parents[first.index] = next;
+    parents[second.index] = next;
+    heap.insert({first.weight + second.weight, next});
+    ++next;
+  }
+
+  // Since parents come after their children, walking backwards finds each
+  // node's depth after its parent's
+  std::vector<size_t> depths(2 * SYMBOLS, 0);
+  for (size_t node = next; node-- > 0;) {
+    if (parents[node] != NONE) {
+      depths[node] = depths[parents[node]] + 1;
+    }
+  }
+  for (size_t symbol = 0; symbol < SYMBOLS; ++symbol) {
+    lengths[symbol] = static_cast<uint8_t>(std::min<size_t>(depths[symbol],
+                                                            UINT8_MAX));
+  }
+  return lengths;
+}
+
+template <size_t BUFFER_SIZE>
+void HuffmanCodec<BUFFER_SIZE>::assignCodes() {
+  lengthCount_.fill(0);
+  for (uint8_t length : lengths_) {
+    if (length > MAX_CODE_LENGTH) {
+      throw std::runtime_error("HuffmanCodec: code is too long");
+    }
+    if (length > 0) {
+      ++lengthCount_[length];
+    }
+  }
+
+  // The codes of each length follow on from the codes of the length before,
+  // with a 0 added to the end.  If there are more codes of a length than it
+  // has room for, the lengths cannot belong to a prefix code.
+  uint32_t code = 0;
+  uint32_t start = 0;
+  for (size_t length = 1; length <= MAX_CODE_LENGTH; ++length) {
+    firstCode_[length] = code;
+    symbolStart_[length] = start;
+    code += lengthCount_[length];
+    start += lengthCount_[length];
+    if (code > (uint32_t{1} << length)) {
+      throw std::runtime_error("HuffmanCodec: too many short codes");
+    }
+    code <<= 1;
+  }
+
+  std::array<uint32_t, MAX_CODE_LENGTH + 1> nextIndex = symbolStart_;
+  for (size_t symbol = 0; symbol < SYMBOLS; ++symbol) {
+    size_t length = lengths_[symbol];
+    if (length > 0) {
+      uint32_t index = nextIndex[length]++;
+      sortedSymbols_[index] = static_cast<uint8_t>(symbol);
+      codes_[symbol] = firstCode_[length] + (index - symbolStart_[length]);
+    }
+  }
+
+  // For each pattern of LOOKUP_BITS bits, decode as many whole codes as fit
+  for (size_t pattern = 0; pattern < table_.size(); ++pattern) {
+    DecodeEntry entry{};
+    size_t used = 0;
+    while (entry.count < MAX_SYMBOLS_PER_LOOKUP && used < LOOKUP_BITS) {
+      size_t left = LOOKUP_BITS - used;
+      size_t length = 0;
+      size_t symbol = decodeSlowly(pattern & ((size_t{1} << left) - 1), left,
+                                   length);
+      if (symbol == SYMBOLS) {
+        break;
+      }
+      entry.symbols[entry.count++] = static_cast<uint8_t>(symbol);
+      used += length;
+    }
+    entry.bits = static_cast<uint8_t>(used);
+    table_[pattern] = entry;
+  }
+}
+
+template <size_t BUFFER_SIZE>
+size_t HuffmanCodec<BUFFER_SIZE>::decodeSlowly(uint64_t bits, size_t bitCount,
+                                               size_t& length) const {
+  // Read one more bit at a time until the bits so far are one of the codes
+  // of that length.  Unsigned subtraction turns a code below firstCode_ into
+  // a huge number, so one comparison checks both ends.
+  uint32_t code = 0;
+  for (size_t i = 1; i <= std::min(bitCount, MAX_CODE_LENGTH); ++i) {
+    code = (code << 1) | ((bits >> (bitCount - i)) & 1);
+    if (code - firstCode_[i] < lengthCount_[i]) {
+      length = i;
+      return sortedSymbols_[symbolStart_[i] + code - firstCode_[i]];
+    }
+  }
+  return SYMBOLS;
+}
+
+/*******************************************************************************
+ * HuffmanCodec::TreeNode implementation
+ ******************************************************************************/
+
+template <size_t BUFFER_SIZE>
+bool HuffmanCodec<BUFFER_SIZE>::TreeNode::operator<(
+    const TreeNode& rhs) const {
+  return weight < rhs.weight || (weight == rhs.weight && index < rhs.index);
+}
+
+template <size_t BUFFER_SIZE>
+bool HuffmanCodec<BUFFER_SIZE>::TreeNode::operator==(
+    const TreeNode& rhs) const {
+  return weight == rhs.weight && index == rhs.index;
+}
+
+/*******************************************************************************
+ * HuffmanCodec::BitWriter implementation
+ ******************************************************************************/
+
+template <size_t BUFFER_SIZE>
+HuffmanCodec<BUFFER_SIZE>::BitWriter::BitWriter(std::ostream& out)
+    : out_{out}, buffer_(BUFFER_SIZE) {
+  // Nothing else to do
+}
+
+template <size_t BUFFER_SIZE>
+void HuffmanCodec<BUFFER_SIZE>::BitWriter::write(uint32_t code,
+                                                 size_t length) {
+  // Moving 32 bits at a time keeps the work per code small.  Codes are at
+  // most 24 bits, so pending_ never holds more than 55.
+  pending_ = (pending_ << length) | code;
+  pendingBits_ += length;
+  if (pendingBits_ >= 32) {
+    pendingBits_ -= 32;
+    uint32_t word = static_cast<uint32_t>(pending_ >> pendingBits_);
+    put(static_cast<uint8_t>(word >> 24));
+    put(static_cast<uint8_t>(word >> 16));
+    put(static_cast<uint8_t>(word >> 8));
+    put(static_cast<uint8_t>(word));
+  }
+}
+
+template <size_t BUFFER_SIZE>
+void HuffmanCodec<BUFFER_SIZE>::BitWriter::flush() {
+  while (pendingBits_ >= 8) {
+    pendingBits_ -= 8;
+    put(static_cast<uint8_t>(pending_ >> pendingBits_));
+  }
+  if (pendingBits_ > 0) {
+    put(static_cast<uint8_t>(pending_ << (8 - pendingBits_)));
+    pendingBits_ = 0;
+  }
+  out_.write(buffer_.data(), used_);
+  used_ = 0;
+}
+
+template <size_t BUFFER_SIZE>
+void HuffmanCodec<BUFFER_SIZE>::BitWriter::put(uint8_t byte) {
+  buffer_[used_++] = static_cast<char>(byte);
+  if (used_ == BUFFER_SIZE) {
+    out_.write(buffer_.data(), used_);
+    used_ = 0;
+  }
+}
+
+/*******************************************************************************
+ * HuffmanCodec::BitReader implementation
+ ******************************************************************************/
+
+template <size_t BUFFER_SIZE>
+HuffmanCodec<BUFFER_SIZE>::BitReader::BitReader(std::istream& in)
+    : in_{in}, buffer_(BUFFER_SIZE) {
+  // Nothing else to do
+}
+
+template <size_t BUFFER_SIZE>
+uint64_t HuffmanCodec<BUFFER_SIZE>::BitReader::peek(size_t count) {
+  // Top up the window a byte at a time until it holds at least 57 bits
+  while (available_ <= 56) {
+    if (used_ == filled_) {
+      in_.read(buffer_.data(), BUFFER_SIZE);
+      filled_ = static_cast<size_t>(in_.gcount());
+      used_ = 0;
+    }
+    uint64_t byte = 0;
+    if (used_ < filled_) {
+      byte = static_cast<uint8_t>(buffer_[used_++]);
+    } else {
+      padding_ += 8;
+    }
+    window_ |= byte << (56 - available_);
+    available_ += 8;
+  }
+  return window_ >> (64 - count);
+}
+
+template <size_t BUFFER_SIZE>
+void HuffmanCodec<BUFFER_SIZE>::BitReader::skip(size_t count) {
+  window_ <<= count;
+  available_ -= count;
+}
+
+template <size_t BUFFER_SIZE>
+bool HuffmanCodec<BUFFER_SIZE>::BitReader::overran() const {
+  return available_ < padding_;
+}
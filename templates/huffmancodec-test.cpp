@@ -0,0 +1,144 @@
+/**
+ * \file huffmancodec-test.cpp
+ * \copyright Matthew Calligaro
+ * \date January 2020
+ * \brief An assortment of ad hoc tests for the HuffmanCodec class
+ * \note These tests are not comprehensive and are NOT a good example of unit
+ * testing
+ * \note Run from the templates directory, since roundTripFileTest reads the
+ * text files in ../io
+ */
+
+#include <array>
+#include <cassert>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include "huffmancodec.hpp"
+
+/**
+ * \brief Compresses and decompresses a string
+ * \param text  The string to compress
+ * \return The string after compressing and decompressing it
+ */
+template <size_t BUFFER_SIZE>
+std::string roundTrip(const std::string& text) {
+  std::istringstream in(text);
+  std::stringstream compressed;
+  HuffmanCodec<BUFFER_SIZE>::compress(in, compressed);
+  std::ostringstream out;
+  HuffmanCodec<BUFFER_SIZE>::decompress(compressed, out);
+  return out.str();
+}
+
+/**
+ * \brief Checks round trips of a few unusual inputs
+ */
+void edgeCaseTest() {
+  std::string allBytes;
+  for (int i = 0; i < 256 * 3; ++i) {
+    allBytes.push_back(static_cast<char>(i));
+  }
+
+  // A buffer of 7 bytes makes every buffer boundary come up often
+  for (const std::string& text :
+       {std::string(), std::string("a"), std::string(1000, 'z'),
+        std::string("abracadabra"), allBytes}) {
+    assert(roundTrip<7>(text) == text);
+    assert(roundTrip<1 << 16>(text) == text);
+  }
+
+  // Counts which grow like the Fibonacci numbers give a code as long as the
+  // number of bytes, which must be cut down to MAX_CODE_LENGTH
+  std::array<uint64_t, 256> counts{};
+  uint64_t previous = 1;
+  uint64_t current = 1;
+  for (size_t symbol = 0; symbol < 40; ++symbol) {
+    counts[symbol] = current;
+    uint64_t next = previous + current;
+    previous = current;
+    current = next;
+  }
+  HuffmanCodec<> skewed(counts);
+  for (size_t symbol = 0; symbol < 40; ++symbol) {
+    assert(skewed.lengths()[symbol] > 0);
+    assert(skewed.lengths()[symbol] <= HuffmanCodec<>::MAX_CODE_LENGTH);
+  }
+
+  std::string rare;
+  for (size_t symbol = 0; symbol < 40; ++symbol) {
+    rare += std::string(symbol + 1, static_cast<char>(symbol));
+  }
+  std::istringstream in(rare);
+  std::stringstream encoded;
+  assert(skewed.encode(in, encoded) == rare.size());
+  std::ostringstream decoded;
+  skewed.decode(encoded, decoded, rare.size());
+  assert(decoded.str() == rare);
+}
+
+/**
+ * \brief Checks that bad input is reported
+ */
+void errorTest() {
+  // Three codes of length 1 cannot all be different
+  std::array<uint8_t, 256> lengths{};
+  lengths['a'] = lengths['b'] = lengths['c'] = 1;
+  bool caught = false;
+  try {
+    HuffmanCodec<>::fromLengths(lengths);
+  } catch (const std::runtime_error&) {
+    caught = true;
+  }
+  assert(caught);
+
+  // Cut off the end of a compressed stream
+  std::istringstream in("the quick brown fox jumps over the lazy dog");
+  std::ostringstream compressed;
+  HuffmanCodec<>::compress(in, compressed);
+  std::string truncated = compressed.str();
+  truncated.resize(truncated.size() - 4);
+  std::istringstream damaged(truncated);
+  std::ostringstream out;
+  caught = false;
+  try {
+    HuffmanCodec<>::decompress(damaged, out);
+  } catch (const std::runtime_error&) {
+    caught = true;
+  }
+  assert(caught);
+}
+
+/**
+ * \brief Compresses and decompresses each of the text files in ../io
+ */
+void roundTripFileTest() {
+  for (const char* name : {"hello.txt", "lamb.txt", "loremIpsum.txt",
+                           "numbers.txt", "sheep.txt"}) {
+    std::string path = std::string("../io/") + name;
+    std::ifstream original(path, std::ios::binary);
+    assert(original.is_open());
+    std::stringstream contents;
+    contents << original.rdbuf();
+    original.clear();
+    original.seekg(0);
+
+    std::stringstream compressed;
+    HuffmanCodec<64>::compress(original, compressed);
+    std::ostringstream restored;
+    HuffmanCodec<64>::decompress(compressed, restored);
+    assert(restored.str() == contents.str());
+  }
+}
+
+int main() {
+  edgeCaseTest();
+  errorTest();
+  roundTripFileTest();
+
+  std::cout << "All tests passed" << std::endl;
+  return 0;
+}
@@ -0,0 +1,312 @@
+/**
+ * \file huffmancodec.hpp
+ * \copyright Matthew Calligaro
+ * \date January 2020
+ * \brief Declares the HuffmanCodec class
+ */
+
+#ifndef TEMPLATES_HUFFMANCODEC_HPP_
+#define TEMPLATES_HUFFMANCODEC_HPP_
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <vector>
+#include "minheap.hpp"
+
+/**
+ * \class HuffmanCodec
+ * \brief Compresses and decompresses streams of bytes with a Huffman code
+ * \details A Huffman code gives common bytes short codes and rare bytes long
+ * ones.  The code is built by putting every byte which occurs in a MinHeap,
+ * ordered by how often it occurs, and then repeatedly joining the two least
+ * common entries into one, until a single tree is left.  The depth of each
+ * byte in that tree is the length of its code.
+ *
+ * Only the lengths are stored.  The codes themselves are assigned in a fixed
+ * ("canonical") order, so the lengths alone are enough to rebuild them.
+ * Both directions are driven by tables.  Encoding looks up each byte's code
+ * and length.  Decoding looks at the next LOOKUP_BITS bits at once, and a
+ * table built from them says which bytes (often several) those bits start
+ * with and how many bits they use.  Only codes longer than LOOKUP_BITS are
+ * decoded a bit at a time.
+ *
+ * Input and output go through buffers of BUFFER_SIZE bytes, so a stream of
+ * any length is processed in constant memory.
+ * \note compress writes the length of the input, then the length of each
+ * byte's code, then the encoded bits.  decompress reads the same layout.
+ */
+template <size_t BUFFER_SIZE = 1 << 16>
+class HuffmanCodec {
+ public:
+  static_assert(BUFFER_SIZE > 0, "The buffers must hold at least one byte");
+
+  /** \brief The number of different bytes */
+  static constexpr size_t SYMBOLS = 256;
+
+  /**
+   * \brief The longest code allowed, which keeps every code inside the bit
+   * buffers with room to spare
+   */
+  static constexpr size_t MAX_CODE_LENGTH = 24;
+
+  /** \brief The number of bits each lookup in the decoding table reads */
+  static constexpr size_t LOOKUP_BITS = 11;
+
+  /** \brief The most bytes a single decoding lookup can produce */
+  static constexpr size_t MAX_SYMBOLS_PER_LOOKUP = 4;
+
+  /**
+   * \brief Creates the Huffman code for bytes with the given counts
+   * \param counts  The number of times each byte occurs
+   * \note Run time: constant, since there are always 256 bytes
+   */
+  explicit HuffmanCodec(const std::array<uint64_t, SYMBOLS>& counts);
+
+  /**
+   * \brief Creates a Huffman code from the lengths of its codes, such as
+   * the lengths stored by compress
+   * \param lengths   The length of each byte's code, or 0 for bytes which do
+   * not occur
+   * \return The HuffmanCodec with those lengths
+   * \note Run time: constant
+   * \throw std::runtime_error if the lengths do not describe a valid code
+   */
+  static HuffmanCodec fromLengths(const std::array<uint8_t, SYMBOLS>& lengths);
+
+  /**
+   * \brief Returns the length of each byte's code
+   * \return The length of each byte's code, or 0 for bytes which do not occur
+   * \note Run time: constant
+   */
+  const std::array<uint8_t, SYMBOLS>& lengths() const;
+
+  /**
+   * \brief Encodes every byte of a stream
+   * \param in    The stream of bytes to encode
+   * \param out   The stream to which to write the encoded bits, padded with
+   * zeros to a whole byte
+   * \return The number of bytes encoded
+   * \note Run time: linear in the length of in
+   * \warning Behavior is undefined if in contains a byte which has no code
+   */
+  uint64_t encode(std::istream& in, std::ostream& out) const;
+
+  /**
+   * \brief Decodes a number of bytes from a stream of encoded bits
+   * \param in      The stream of encoded bits, as written by encode
+   * \param out     The stream to which to write the decoded bytes
+   * \param count   The number of bytes to decode
+   * \note Run time: linear in count
+   * \throw std::runtime_error if in does not contain a valid encoding
+   */
+  void decode(std::istream& in, std::ostream& out, uint64_t count) const;
+
+  /**
+   * \brief Compresses a stream, including everything decompress needs
+   * \param in    The stream to compress, which must support seekg, since it
+   * is read twice: once to count the bytes and once to encode them
+   * \param out   The stream to which to write the compressed data
+   * \note Run time: linear in the length of in
+   */
+  static void compress(std::istream& in, std::ostream& out);
+
+  /**
+   * \brief Decompresses a stream written by compress
+   * \param in    The compressed stream
+   * \param out   The stream to which to write the original bytes
+   * \note Run time: linear in the length of the original stream
+   * \throw std::runtime_error if in was not written by compress
+   */
+  static void decompress(std::istream& in, std::ostream& out);
+
+ private:
+  /**
+   * \struct TreeNode
+   * \brief A subtree waiting in the MinHeap while the code is built
+   */
+  struct TreeNode {
+    /** \brief The total count of the bytes in the subtree */
+    uint64_t weight;
+
+    /**
+     * \brief The byte, for a leaf, or SYMBOLS plus the order in which the
+     * subtree was made, for a join.  Breaking ties by index makes the code
+     * the same on every platform.
+     */
+    size_t index;
+
+    bool operator<(const TreeNode& rhs) const;
+    bool operator==(const TreeNode& rhs) const;
+  };
+
+  /**
+   * \struct DecodeEntry
+   * \brief What the decoding table knows about one pattern of LOOKUP_BITS
+   * bits
+   */
+  struct DecodeEntry {
+    /** \brief The bytes whose codes fit entirely in the bits */
+    std::array<uint8_t, MAX_SYMBOLS_PER_LOOKUP> symbols;
+
+    /**
+     * \brief The number of bytes in symbols, or 0 if the bits start with a
+     * code longer than LOOKUP_BITS
+     */
+    uint8_t count;
+
+    /** \brief The number of bits the codes of those bytes take up */
+    uint8_t bits;
+  };
+
+  /**
+   * \class BitWriter
+   * \brief Writes codes to a stream through a buffer
+   */
+  class BitWriter {
+   public:
+    /**
+     * \brief Creates a BitWriter which writes to out
+     * \param out   The stream to which to write
+     */
+    explicit BitWriter(std::ostream& out);
+
+    /**
+     * \brief Adds a code after the bits written so far
+     * \param code    The code, in its lowest length bits
+     * \param length  The number of bits in the code
+     */
+    void write(uint32_t code, size_t length);
+
+    /**
+     * \brief Pads the last byte with zeros and writes out the buffer
+     */
+    void flush();
+
+   private:
+    std::ostream& out_;
+
+    /** \brief Bits not yet moved to buffer_, in the lowest pendingBits_ */
+    uint64_t pending_ = 0;
+    size_t pendingBits_ = 0;
+
+    std::vector<char> buffer_;
+    size_t used_ = 0;
+
+    /**
+     * \brief Adds a byte to the buffer, writing the buffer out if it is full
+     * \param byte  The byte to add
+     */
+    void put(uint8_t byte);
+  };
+
+  /**
+   * \class BitReader
+   * \brief Reads bits from a stream through a buffer
+   * \details The next bits are kept at the top of a 64-bit window, so the
+   * next n bits are simply the window shifted right by 64 - n.  Past the end
+   * of the stream, the window fills with zeros.
+   */
+  class BitReader {
+   public:
+    /**
+     * \brief Creates a BitReader which reads from in
+     * \param in  The stream from which to read
+     */
+    explicit BitReader(std::istream& in);
+
+    /**
+     * \brief Returns the next bits without using them up
+     * \param count   The number of bits, from 1 to 56
+     * \return The next count bits, in the lowest count bits
+     */
+    uint64_t peek(size_t count);
+
+    /**
+     * \brief Uses up bits which have been peeked at
+     * \param count   The number of bits
+     */
+    void skip(size_t count);
+
+    /**
+     * \brief Returns whether bits past the end of the stream were used up
+     * \return True if the stream ended before the bits that were skipped
+     */
+    bool overran() const;
+
+   private:
+    std::istream& in_;
+
+    /** \brief The next available_ bits, starting at the top bit */
+    uint64_t window_ = 0;
+    size_t available_ = 0;
+
+    /** \brief How many of the available bits are zeros past the end */
+    size_t padding_ = 0;
+
+    std::vector<char> buffer_;
+    size_t used_ = 0;
+    size_t filled_ = 0;
+  };
+
+  /** \brief The length of each byte's code, or 0 if it has none */
+  std::array<uint8_t, SYMBOLS> lengths_;
+
+  /** \brief The code of each byte, in its lowest lengths_ bits */
+  std::array<uint32_t, SYMBOLS> codes_;
+
+  /**
+   * \brief The first code of each length.  The codes of a length are
+   * consecutive, and go to the bytes of that length in increasing order.
+   */
+  std::array<uint32_t, MAX_CODE_LENGTH + 1> firstCode_;
+
+  /** \brief The number of codes of each length */
+  std::array<uint32_t, MAX_CODE_LENGTH + 1> lengthCount_;
+
+  /** \brief Where the bytes of each length start in sortedSymbols_ */
+  std::array<uint32_t, MAX_CODE_LENGTH + 1> symbolStart_;
+
+  /** \brief The bytes which have codes, sorted by length and then value */
+  std::array<uint8_t, SYMBOLS> sortedSymbols_;
+
+  /** \brief One DecodeEntry for each pattern of LOOKUP_BITS bits */
+  std::vector<DecodeEntry> table_;
+
+  /**
+   * \brief Creates a HuffmanCodec with no codes, to be filled in
+   */
+  HuffmanCodec();
+
+  /**
+   * \brief Builds the code lengths for the given counts with a MinHeap
+   * \param counts  The number of times each byte occurs
+   * \return The length of each byte's code, some of which may be longer
+   * than MAX_CODE_LENGTH
+   * \note Run time: constant
+   */
+  static std::array<uint8_t, SYMBOLS> buildLengths(
+      const std::array<uint64_t, SYMBOLS>& counts);
+
+  /**
+   * \brief Fills in the codes and the tables from lengths_
+   * \throw std::runtime_error if lengths_ do not describe a valid code
+   * \note Run time: constant
+   */
+  void assignCodes();
+
+  /**
+   * \brief Decodes one code of up to bitCount bits, one bit at a time
+   * \param bits      The bits, with the first one at position bitCount - 1
+   * \param bitCount  The number of bits available
+   * \param length    Set to the length of the code, if one is found
+   * \return The byte, or SYMBOLS if the bits do not start with a code
+   */
+  size_t decodeSlowly(uint64_t bits, size_t bitCount, size_t& length) const;
+};
+
+#include "huffmancodec-private.hpp"
+
+#endif  // TEMPLATES_HUFFMANCODEC_HPP_
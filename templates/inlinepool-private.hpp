@@ -0,0 +1,56 @@
+/**
+ * \file inlinepool-private.hpp
+ * \copyright Matthew Calligaro
+ * \date January 2020
+ * \brief Provides the template implementation for the InlinePool class
+ */
+
+// NOLINT(build/header_guard)
+
+#include <functional>
+#include <new>
+
+template <typename T, size_t CAPACITY>
+constexpr InlinePool<T, CAPACITY>::InlinePool() : freeCount_{CAPACITY} {
+  // We push the slots in reverse order so that the first object created is
+  // placed in slot 0
+  for (size_t i = 0; i < CAPACITY; ++i) {
+    freeSlots_[i] = CAPACITY - 1 - i;
+  }
+}
+
+template <typename T, size_t CAPACITY>
+T* InlinePool<T, CAPACITY>::create(const T& val) {
+  if (freeCount_ == 0) {
+    return nullptr;
+  }
+
+  // Placement new constructs an object at an address we provide rather than
+  // allocating memory for it
+  --freeCount_;
+  return new (slot(freeSlots_[freeCount_])) T(val);
+}
+
+template <typename T, size_t CAPACITY>
+bool InlinePool<T, CAPACITY>::owns(const T* element) const {
+  const T* first = reinterpret_cast<const T*>(storage_);
+
+  // Comparing unrelated pointers with < is unspecified, but std::less is
+  // guaranteed to give a consistent order for any two pointers
+  return !std::less<const T*>()(element, first) &&
+         std::less<const T*>()(element, first + CAPACITY);
+}
+
+template <typename T, size_t CAPACITY>
+void InlinePool<T, CAPACITY>::destroy(T* element) {
+  // An object created with placement new must have its destructor called
+  // explicitly, since there is no memory for delete to free
+  element->~T();
+  freeSlots_[freeCount_] = element - slot(0);
+  ++freeCount_;
+}
+
+template <typename T, size_t CAPACITY>
+T* InlinePool<T, CAPACITY>::slot(size_t index) {
+  return reinterpret_cast<T*>(storage_) + index;
+}
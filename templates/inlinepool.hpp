@@ -0,0 +1,98 @@
+/**
+ * \file inlinepool.hpp
+ * \copyright Matthew Calligaro
+ * \date January 2020
+ * \brief Declares the InlinePool class
+ */
+
+#ifndef TEMPLATES_INLINEPOOL_HPP_
+#define TEMPLATES_INLINEPOOL_HPP_
+
+#include <cstddef>
+
+/**
+ * \class InlinePool
+ * \brief A fixed number of object slots stored directly inside the pool
+ * \details Objects created in an InlinePool live in the pool's own storage
+ * rather than on the heap, so when an InlinePool is a data member, creating
+ * an object costs no memory allocation.  When every slot is in use, create
+ * returns nullptr and the caller is expected to fall back to the heap.
+ * \note The template type T must support the copy constructor
+ * \warning The pool does not track which slots are in use, so the owner must
+ * destroy every object it created before the pool itself is destroyed
+ */
+template <typename T, size_t CAPACITY>
+class InlinePool {
+ public:
+  /**
+   * \brief Creates an InlinePool with every slot free
+   * \note Run time: linear in CAPACITY
+   */
+  constexpr InlinePool();
+
+  // Objects in the pool are referred to by their address, which would be
+  // wrong for a copy, so we disable copying
+  InlinePool(const InlinePool& other) = delete;
+  InlinePool& operator=(const InlinePool& other) = delete;
+
+  /**
+   * \brief Copies val into a free slot of the pool
+   * \param val   The value to copy into the pool
+   * \return A pointer to the new object, or nullptr if the pool is full
+   * \note Run time: constant
+   */
+  T* create(const T& val);
+
+  /**
+   * \brief Determines whether an object lives in the pool
+   * \param element   A pointer to the object
+   * \return True if element points into the storage of this pool
+   * \note Run time: constant
+   */
+  bool owns(const T* element) const;
+
+  /**
+   * \brief Destroys an object and frees its slot
+   * \param element   A pointer to the object to destroy
+   * \note Run time: constant
+   * \warning Behavior is undefined if owns(element) is false
+   */
+  void destroy(T* element);
+
+ private:
+  /** \brief Raw, correctly aligned storage for CAPACITY objects */
+  alignas(T) unsigned char storage_[CAPACITY * sizeof(T)];
+
+  /** \brief A stack of the indices of the free slots in storage_ */
+  size_t freeSlots_[CAPACITY];
+
+  /** \brief The number of indices in freeSlots_ */
+  size_t freeCount_;
+
+  /**
+   * \brief Returns a pointer to a slot of storage_
+   * \param index   The index of the slot
+   * \return A pointer to the slot
+   * \note Run time: constant
+   */
+  T* slot(size_t index);
+};
+
+/**
+ * \class InlinePool<T, 0>
+ * \brief An InlinePool with no slots, which takes up no storage
+ * \details An array of size 0 is not allowed in C++, so we provide a partial
+ * specialization for a CAPACITY of 0.  Every method is trivial, so the
+ * compiler can remove any code which uses the pool entirely.
+ */
+template <typename T>
+class InlinePool<T, 0> {
+ public:
+  T* create(const T&) { return nullptr; }
+  bool owns(const T*) const { return false; }
+  void destroy(T*) {}
+};
+
+#include "inlinepool-private.hpp"
+
+#endif  // TEMPLATES_INLINEPOOL_HPP_
@@ -0,0 +1,301 @@
+/**
+ * \file keyedminheap-private.hpp
+ * \copyright Matthew Calligaro
+ * \date January 2020
+ * \brief Provides the template implementation for the KeyedMinHeap class
+ */
+
+// NOLINT(build/header_guard)
+
+#include <algorithm>
+#include <ostream>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/*******************************************************************************
+ * KeyedMinHeap implementation
+ ******************************************************************************/
+
+template <typename Key, typename Value>
+KeyedMinHeap<Key, Value>::KeyedMinHeap() : keys_(1), valueIndices_(1) {
+  // Nothing else to do
+}
+
+template <typename Key, typename Value>
+void KeyedMinHeap<Key, Value>::swap(KeyedMinHeap& other) {
+  keys_.swap(other.keys_);
+  valueIndices_.swap(other.valueIndices_);
+  values_.swap(other.values_);
+  freeValues_.swap(other.freeValues_);
+}
+
+template <typename Key, typename Value>
+bool KeyedMinHeap<Key, Value>::operator==(const KeyedMinHeap& rhs) const {
+  if (size() != rhs.size()) {
+    return false;
+  }
+
+  // As in MinHeap, we drain copies of both heaps and compare them in order.
+  // Equal keys come out in no particular order, though, so for each run of
+  // equal keys we compare the values as a multiset rather than one by one.
+  KeyedMinHeap lcopy(*this);
+  KeyedMinHeap rcopy(rhs);
+  std::vector<Value> lvalues;
+  std::vector<Value> rvalues;
+  while (!lcopy.empty()) {
+    Key key = lcopy.peakMin();
+    if (!(rcopy.peakMin() == key)) {
+      return false;
+    }
+    lvalues.clear();
+    rvalues.clear();
+    while (!lcopy.empty() && lcopy.peakMin() == key) {
+      lvalues.push_back(lcopy.peakMinValue());
+      lcopy.deleteMin();
+    }
+    while (!rcopy.empty() && rcopy.peakMin() == key) {
+      rvalues.push_back(rcopy.peakMinValue());
+      rcopy.deleteMin();
+    }
+    if (lvalues.size() != rvalues.size() ||
+        !std::is_permutation(lvalues.begin(), lvalues.end(),
+                             rvalues.begin())) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+template <typename Key, typename Value>
+bool KeyedMinHeap<Key, Value>::operator!=(const KeyedMinHeap& rhs) const {
+  return !(*this == rhs);
+}
+
+template <typename Key, typename Value>
+typename KeyedMinHeap<Key, Value>::const_iterator
+KeyedMinHeap<Key, Value>::begin() const {
+  return cbegin();
+}
+
+template <typename Key, typename Value>
+typename KeyedMinHeap<Key, Value>::const_iterator
+KeyedMinHeap<Key, Value>::end() const {
+  return cend();
+}
+
+template <typename Key, typename Value>
+typename KeyedMinHeap<Key, Value>::const_iterator
+KeyedMinHeap<Key, Value>::cbegin() const {
+  return const_iterator(this, 1);
+}
+
+template <typename Key, typename Value>
+typename KeyedMinHeap<Key, Value>::const_iterator
+KeyedMinHeap<Key, Value>::cend() const {
+  return const_iterator(this, keys_.size());
+}
+
+template <typename Key, typename Value>
+size_t KeyedMinHeap<Key, Value>::size() const {
+  return keys_.size() - 1;
+}
+
+template <typename Key, typename Value>
+bool KeyedMinHeap<Key, Value>::empty() const {
+  return keys_.size() == 1;
+}
+
+template <typename Key, typename Value>
+const Key& KeyedMinHeap<Key, Value>::peakMin() const {
+  return keys_[1];
+}
+
+template <typename Key, typename Value>
+const Value& KeyedMinHeap<Key, Value>::peakMinValue() const {
+  return values_[valueIndices_[1]];
+}
+
+template <typename Key, typename Value>
+std::ostream& KeyedMinHeap<Key, Value>::print(std::ostream& os,
+                                              bool complete) const {
+  os << "[";
+
+  // In complete mode, print the unused index 0
+  if (complete) {
+    os << "x";
+  }
+
+  // Print each key with its value, seperated by commas
+  for (size_t i = 1; i < keys_.size(); ++i) {
+    os << (i > 1 || complete ? "," : "") << keys_[i] << ":"
+       << values_[valueIndices_[i]];
+  }
+
+  // In complete mode, print the spaces keys_ has room for without growing
+  if (complete) {
+    for (size_t i = keys_.size(); i < keys_.capacity(); ++i) {
+      os << ",_";
+    }
+  }
+
+  os << "]";
+  return os;
+}
+
+template <typename Key, typename Value>
+bool KeyedMinHeap<Key, Value>::exists(const Key& key) const {
+  return existsBelow(1, key);
+}
+
+template <typename Key, typename Value>
+void KeyedMinHeap<Key, Value>::insert(const Key& key, const Value& val) {
+  // Store the value in a free index if there is one, where it stays until it
+  // is deleted
+  size_t valueIndex;
+  if (freeValues_.empty()) {
+    valueIndex = values_.size();
+    values_.push_back(val);
+  } else {
+    valueIndex = freeValues_.back();
+    freeValues_.pop_back();
+    values_[valueIndex] = val;
+  }
+
+  // As in PagedMinHeap, we move each larger parent down into the hole and
+  // only write the new key once we find its place.  We copy key first, since
+  // it could refer to one of the keys we are about to move.
+  Key newKey = key;
+  size_t index = keys_.size();
+  keys_.push_back(newKey);
+  valueIndices_.push_back(valueIndex);
+  while (index > 1 && newKey < keys_[index / 2]) {
+    place(index, keys_[index / 2], valueIndices_[index / 2]);
+    index /= 2;
+  }
+  place(index, newKey, valueIndex);
+}
+
+template <typename Key, typename Value>
+void KeyedMinHeap<Key, Value>::deleteMin() {
+  // A value which owns resources (such as a std::string) gives them up now,
+  // rather than whenever its index is reused.  Anything else is left as is.
+  size_t freed = valueIndices_[1];
+  if constexpr (!std::is_trivially_destructible_v<Value>) {
+    values_[freed] = Value();
+  }
+  freeValues_.push_back(freed);
+
+  // Take the last key out of keys_, and move the smaller child of the hole up
+  // until the last key fits in it.  Only keys_ is read along the way.
+  Key last = std::move(keys_.back());
+  size_t lastValueIndex = valueIndices_.back();
+  keys_.pop_back();
+  valueIndices_.pop_back();
+  size_t end = keys_.size();
+  if (end == 1) {
+    // The heap is empty, so every index in values_ is free
+    values_.clear();
+    freeValues_.clear();
+    return;
+  }
+
+  size_t index = 1;
+  while (2 * index < end) {
+    size_t child = 2 * index;
+    if (child + 1 < end && keys_[child + 1] < keys_[child]) {
+      ++child;
+    }
+    if (!(keys_[child] < last)) {
+      break;
+    }
+    place(index, keys_[child], valueIndices_[child]);
+    index = child;
+  }
+  place(index, last, lastValueIndex);
+}
+
+template <typename Key, typename Value>
+void KeyedMinHeap<Key, Value>::place(size_t index, const Key& key,
+                                     size_t valueIndex) {
+  keys_[index] = key;
+  valueIndices_[index] = valueIndex;
+}
+
+template <typename Key, typename Value>
+bool KeyedMinHeap<Key, Value>::existsBelow(size_t index,
+                                           const Key& key) const {
+  // Every key below index is at least keys_[index], so once that is larger
+  // than key, the whole subtree can be skipped.  As in MinHeap::exists, a
+  // match is decided by operator==.
+  if (index >= keys_.size() || key < keys_[index]) {
+    return false;
+  }
+  if (keys_[index] == key) {
+    return true;
+  }
+  return existsBelow(2 * index, key) || existsBelow(2 * index + 1, key);
+}
+
+/*******************************************************************************
+ * KeyedMinHeap::ConstIterator implementation
+ ******************************************************************************/
+
+template <typename Key, typename Value>
+KeyedMinHeap<Key, Value>::ConstIterator::ConstIterator()
+    : heap_{nullptr}, index_{0} {}
+
+template <typename Key, typename Value>
+KeyedMinHeap<Key, Value>::ConstIterator::ConstIterator(
+    const KeyedMinHeap* heap, size_t index)
+    : heap_{heap}, index_{index} {}
+
+template <typename Key, typename Value>
+bool KeyedMinHeap<Key, Value>::ConstIterator::operator==(
+    const ConstIterator& rhs) const {
+  return heap_ == rhs.heap_ && index_ == rhs.index_;
+}
+
+template <typename Key, typename Value>
+bool KeyedMinHeap<Key, Value>::ConstIterator::operator!=(
+    const ConstIterator& rhs) const {
+  return !(*this == rhs);
+}
+
+template <typename Key, typename Value>
+typename KeyedMinHeap<Key, Value>::ConstIterator::reference
+    KeyedMinHeap<Key, Value>::ConstIterator::operator*() const {
+  return reference(heap_->keys_[index_],
+                   heap_->values_[heap_->valueIndices_[index_]]);
+}
+
+template <typename Key, typename Value>
+typename KeyedMinHeap<Key, Value>::ConstIterator&
+KeyedMinHeap<Key, Value>::ConstIterator::operator++() {
+  ++index_;
+  return *this;
+}
+
+template <typename Key, typename Value>
+typename KeyedMinHeap<Key, Value>::ConstIterator
+KeyedMinHeap<Key, Value>::ConstIterator::operator++(int) {
+  ConstIterator copy = *this;
+  ++*this;
+  return copy;
+}
+
+/*******************************************************************************
+ * Overloading global functions
+ ******************************************************************************/
+
+template <typename Key, typename Value>
+void swap(KeyedMinHeap<Key, Value>& lhs, KeyedMinHeap<Key, Value>& rhs) {
+  lhs.swap(rhs);
+}
+
+template <typename Key, typename Value>
+std::ostream& operator<<(std::ostream& os,
+                         const KeyedMinHeap<Key, Value>& heap) {
+  return heap.print(os);
+}
@@ -0,0 +1,232 @@
+/**
+ * \file keyedminheap-test.cpp
+ * \copyright Matthew Calligaro
+ * \date January 2020
+ * \brief An assortment of ad hoc tests for the KeyedMinHeap class
+ * \note These tests are not comprehensive and are NOT a good example of unit
+ * testing
+ */
+
+#include <algorithm>
+#include <cassert>
+#include <functional>
+#include <iostream>
+#include <queue>
+#include <random>
+#include <sstream>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "keyedminheap.hpp"
+
+/**
+ * \brief Compares a KeyedMinHeap against std::priority_queue over random
+ * operations, checking that every value stays with its key
+ */
+void randomTest() {
+  const size_t OPERATIONS = 50000;
+  std::default_random_engine engine(2020);
+  std::uniform_int_distribution<int> keys(0, 1000);
+  std::uniform_int_distribution<int> choices(0, 2);
+
+  // Each value is its key written out, so we can tell which key it belongs
+  // to even when keys repeat
+  KeyedMinHeap<int, std::string> heap;
+  std::priority_queue<int, std::vector<int>, std::greater<int>> expected;
+  for (size_t i = 0; i < OPERATIONS; ++i) {
+    bool growing = i < OPERATIONS / 2;
+    if (expected.empty() || choices(engine) < (growing ? 2 : 1)) {
+      int key = keys(engine);
+      heap.insert(key, std::to_string(key));
+      expected.push(key);
+    } else {
+      heap.deleteMin();
+      expected.pop();
+    }
+    assert(heap.size() == expected.size());
+    if (!expected.empty()) {
+      assert(heap.peakMin() == expected.top());
+      assert(heap.peakMinValue() == std::to_string(expected.top()));
+    }
+  }
+  while (!heap.empty()) {
+    heap.deleteMin();
+  }
+}
+
+/**
+ * \brief Runs several ad hoc tests of copying, swapping, and reusing freed
+ * values
+ */
+void coreTest() {
+  KeyedMinHeap<double, std::string> h1;
+  assert(h1.empty() && h1.size() == 0);
+  h1.insert(3.5, "three and a half");
+  h1.insert(1.0, "one");
+  h1.insert(2.0, "two");
+  assert(h1.size() == 3 && h1.peakMin() == 1.0);
+  assert(h1.peakMinValue() == "one");
+
+  // A key taken from the heap itself is copied before anything moves
+  h1.insert(h1.peakMin(), "also one");
+  assert(h1.size() == 4 && h1.peakMin() == 1.0);
+
+  // Copies are deep, and swap exchanges everything
+  KeyedMinHeap<double, std::string> h2 = h1;
+  h1.deleteMin();
+  h1.deleteMin();
+  assert(h1.peakMin() == 2.0 && h1.peakMinValue() == "two");
+  assert(h2.size() == 4 && h2.peakMin() == 1.0);
+  swap(h1, h2);
+  assert(h1.size() == 4 && h2.size() == 2);
+  assert(h2.peakMinValue() == "two");
+
+  // Values freed by deleteMin are reused by later inserts
+  h2.insert(0.5, "half");
+  assert(h2.peakMinValue() == "half");
+  h2.deleteMin();
+  h2.deleteMin();
+  assert(h2.peakMinValue() == "three and a half");
+  h2.deleteMin();
+  assert(h2.empty());
+  h2.insert(4.0, "four");
+  assert(h2.size() == 1 && h2.peakMinValue() == "four");
+}
+
+/**
+ * \struct Version
+ * \brief A key which is ordered by its major number alone, but is only
+ * equal to a key with the same minor number too
+ */
+struct Version {
+  int major;
+  int minor;
+
+  bool operator<(const Version& rhs) const { return major < rhs.major; }
+  bool operator==(const Version& rhs) const {
+    return major == rhs.major && minor == rhs.minor;
+  }
+};
+
+/**
+ * \brief Checks the parts of the MinHeap interface which KeyedMinHeap
+ * shares: the STL typedefs, exists, print, iteration, and comparison
+ */
+void surfaceTest() {
+  using Heap = KeyedMinHeap<int, std::string>;
+  static_assert(std::is_same_v<Heap::key_type, int>);
+  static_assert(std::is_same_v<Heap::mapped_type, std::string>);
+  static_assert(std::is_same_v<Heap::value_type, std::pair<int, std::string>>);
+  static_assert(std::is_same_v<Heap::size_type, size_t>);
+  static_assert(std::is_same_v<Heap::difference_type, ptrdiff_t>);
+  static_assert(std::is_same_v<Heap::const_reference,
+                               std::pair<const int&, const std::string&>>);
+  static_assert(
+      std::is_same_v<std::iterator_traits<Heap::const_iterator>::value_type,
+                     Heap::value_type>);
+
+  Heap heap;
+  assert(!heap.exists(1));
+  assert(heap.begin() == heap.end());
+  std::ostringstream empty;
+  empty << heap;
+  assert(empty.str() == "[]");
+
+  heap.insert(5, "five");
+  heap.insert(2, "two");
+  heap.insert(8, "eight");
+  heap.insert(2, "deux");
+  heap.insert(9, "nine");
+
+  // exists skips subtrees which only hold larger keys, but still finds keys
+  // at every depth
+  for (int key : {2, 5, 8, 9}) {
+    assert(heap.exists(key));
+  }
+  for (int key : {0, 3, 6, 10}) {
+    assert(!heap.exists(key));
+  }
+
+  // As in MinHeap, exists looks for an equal key, not just one which is
+  // neither smaller nor larger
+  KeyedMinHeap<Version, int> versions;
+  versions.insert(Version{1, 0}, 10);
+  versions.insert(Version{2, 1}, 21);
+  versions.insert(Version{2, 3}, 23);
+  assert(versions.exists(Version{2, 3}) && versions.exists(Version{1, 0}));
+  assert(!versions.exists(Version{2, 2}) && !versions.exists(Version{1, 1}));
+
+  // Iteration visits keys_ in order, each with its own value
+  std::vector<std::pair<int, std::string>> visited;
+  for (Heap::const_iterator i = heap.cbegin(); i != heap.cend(); ++i) {
+    std::pair<const int&, const std::string&> entry = *i;
+    visited.push_back({entry.first, entry.second});
+  }
+  assert(visited.size() == heap.size());
+  assert(visited.front().first == heap.peakMin());
+  assert(visited.front().second == heap.peakMinValue());
+  std::sort(visited.begin(), visited.end());
+  assert((visited == std::vector<std::pair<int, std::string>>{
+                         {2, "deux"},
+                         {2, "two"},
+                         {5, "five"},
+                         {8, "eight"},
+                         {9, "nine"}}));
+  size_t count = 0;
+  for (auto [key, value] : heap) {
+    assert(heap.exists(key) && !value.empty());
+    ++count;
+  }
+  assert(count == heap.size());
+
+  // print follows the same order as iteration
+  std::ostringstream printed;
+  printed << heap;
+  std::ostringstream expected;
+  expected << "[";
+  for (Heap::const_iterator i = heap.begin(); i != heap.end(); ++i) {
+    expected << (i == heap.begin() ? "" : ",") << (*i).first << ":"
+             << (*i).second;
+  }
+  expected << "]";
+  assert(printed.str() == expected.str());
+  std::ostringstream complete;
+  heap.print(complete, true);
+  assert(complete.str().rfind("[x,", 0) == 0);
+
+  // Heaps are equal if they hold the same pairs, whatever order they were
+  // inserted in, even among equal keys
+  Heap same;
+  same.insert(9, "nine");
+  same.insert(2, "deux");
+  same.insert(8, "eight");
+  same.insert(2, "two");
+  same.insert(5, "five");
+  assert(heap == same && !(heap != same));
+
+  Heap swapped = same;
+  swapped.deleteMin();
+  swapped.deleteMin();
+  swapped.insert(2, "two");
+  swapped.insert(2, "zwei");
+  assert(heap != swapped && !(heap == swapped));
+
+  Heap shorter = same;
+  shorter.deleteMin();
+  assert(heap != shorter);
+
+  Heap otherKey = same;
+  otherKey.deleteMin();
+  otherKey.insert(3, "two");
+  assert(heap != otherKey);
+}
+
+int main() {
+  randomTest();
+  coreTest();
+  surfaceTest();
+
+  std::cout << "All tests passed" << std::endl;
+  return 0;
+}
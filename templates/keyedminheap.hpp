@@ -0,0 +1,335 @@
+/**
+ * \file keyedminheap.hpp
+ * \copyright Matthew Calligaro
+ * \date January 2020
+ * \brief Declares the KeyedMinHeap class
+ */
+
+#ifndef TEMPLATES_KEYEDMINHEAP_HPP_
+#define TEMPLATES_KEYEDMINHEAP_HPP_
+
+#include <cstddef>
+#include <ostream>
+#include <iterator>
+#include <utility>
+#include <vector>
+
+/**
+ * \class KeyedMinHeap
+ * \brief A templated binary min heap of values, each ordered by a separate
+ * key
+ * \details A MinHeap of large records follows a pointer to a whole record for
+ * every comparison, and a PagedMinHeap moves whole records up and down the
+ * tree.  When only a small key decides the order, neither is necessary.
+ * KeyedMinHeap keeps the keys in a dense array of their own, next to an array
+ * of the same shape which says where each key's value is stored.  A value
+ * keeps its index in that store from insert until deleteMin, so bubbling up
+ * and down reads and writes only the keys and the value indices (a
+ * "structure of arrays" rather than an
+ * "array of structures").  With 8-byte keys, eight of them share a cache
+ * line, however large the values are.
+ * \note The template type Key must support the copy constructor, copy
+ * assignment, and operator<.  The template type Value must support the copy
+ * constructor and copy assignment, and also the default constructor unless
+ * it is trivially destructible.
+ * \note Equal keys come out in no particular order
+ * \note exists also needs Key to support operator==.  operator== and
+ * operator!= also need Key and Value to support operator==, and print needs
+ * both to support operator<<.
+ */
+template <typename Key, typename Value>
+class KeyedMinHeap {
+ private:
+  class ConstIterator;
+
+ public:
+  // STL container type definitions
+  using key_type = Key;
+  using mapped_type = Value;
+  using value_type = std::pair<Key, Value>;
+  using size_type = size_t;
+  using difference_type = ptrdiff_t;
+  using reference = std::pair<const Key&, const Value&>;
+  using const_reference = std::pair<const Key&, const Value&>;
+  using const_iterator = ConstIterator;
+
+  /**
+   * \brief Creates an empty KeyedMinHeap
+   * \note Run time: constant
+   */
+  KeyedMinHeap();
+
+  /**
+   * \brief Exchanges the contents of the KeyedMinHeap with other
+   * \param other   The KeyedMinHeap with which to exchange contents
+   * \note Run time: constant
+   */
+  void swap(KeyedMinHeap& other);
+
+  /**
+   * \brief Compares if two KeyedMinHeaps contain the same keys, each with the
+   * same value
+   * \param rhs   The KeyedMinHeap with which to compare
+   * \return True if this KeyedMinHeap and rhs contain the exact same key and
+   * value pairs
+   * \note Run time: O(nlog(n)), where n is the size of the KeyedMinHeap, plus
+   * quadratic in the number of values which share a key
+   */
+  bool operator==(const KeyedMinHeap& rhs) const;
+
+  /**
+   * \brief Compares if two KeyedMinHeaps contain the same keys, each with the
+   * same value
+   * \param rhs   The KeyedMinHeap with which to compare
+   * \return False if this KeyedMinHeap and rhs contain the exact same key and
+   * value pairs
+   * \note Run time: O(nlog(n)), where n is the size of the KeyedMinHeap, plus
+   * quadratic in the number of values which share a key
+   */
+  bool operator!=(const KeyedMinHeap& rhs) const;
+
+  /**
+   * \brief Creates a const_iterator to the first key of the KeyedMinHeap
+   * \return A const_iterator pointing to the first key and its value
+   * \note Run time: constant
+   */
+  const_iterator begin() const;
+
+  /**
+   * \brief Creates a const_iterator to the past-the-end key of the
+   * KeyedMinHeap
+   * \return A const_iterator to the past-the-end key of the KeyedMinHeap
+   * \note Run time: constant
+   */
+  const_iterator end() const;
+
+  /**
+   * \brief Creates a const_iterator to the first key of the KeyedMinHeap
+   * \return A const_iterator pointing to the first key and its value
+   * \note Run time: constant
+   */
+  const_iterator cbegin() const;
+
+  /**
+   * \brief Creates a const_iterator to the past-the-end key of the
+   * KeyedMinHeap
+   * \return A const_iterator to the past-the-end key of the KeyedMinHeap
+   * \note Run time: constant
+   */
+  const_iterator cend() const;
+
+  /**
+   * \brief Returns the number of values in the KeyedMinHeap
+   * \return The number of values in the KeyedMinHeap
+   * \note Run time: constant
+   */
+  size_type size() const;
+
+  /**
+   * \brief Returns whether the KeyedMinHeap is empty
+   * \return True if the size of the KeyedMinHeap is 0
+   * \note Run time: constant
+   */
+  bool empty() const;
+
+  /**
+   * \brief Returns the smallest key in the KeyedMinHeap
+   * \return A reference to the smallest key
+   * \note Run time: constant
+   * \warning Behavior is undefined if the KeyedMinHeap is empty
+   */
+  const Key& peakMin() const;
+
+  /**
+   * \brief Returns the value stored with the smallest key
+   * \return A reference to the value stored with the smallest key
+   * \note Run time: constant
+   * \warning Behavior is undefined if the KeyedMinHeap is empty
+   * \warning The values are stored in a std::vector, so an insert which grows
+   * it invalidates the reference
+   */
+  const Value& peakMinValue() const;
+
+  /**
+   * \brief Prints the keys and values of the KeyedMinHeap to an ostream, as
+   * key:value in the order of keys_
+   * \param os        The ostream to which to print
+   * \param complete  If true, also print the unused index 0 and the spaces
+   * keys_ has room for
+   * \return The ostream which was passed in
+   * \note Run time: linear in the size of the KeyedMinHeap
+   */
+  std::ostream& print(std::ostream& os, bool complete = false) const;
+
+  /**
+   * \brief Determines whether a key is in the KeyedMinHeap
+   * \param key   The key for which to search
+   * \return True if some value was inserted with a key equal to key
+   * \note Run time: worst-case linear in the size of the KeyedMinHeap
+   * \note Only keys_ is read, and subtrees whose smallest key is larger than
+   * key are skipped
+   */
+  bool exists(const Key& key) const;
+
+  /**
+   * \brief Adds a new value to the KeyedMinHeap
+   * \param key   The key which orders the value
+   * \param val   The value to insert
+   * \note Run time: amortized logarithmic in the size of the KeyedMinHeap
+   * \note Only the value is copied once; bubbling up moves the key alone
+   */
+  void insert(const Key& key, const Value& val);
+
+  /**
+   * \brief Removes the value with the smallest key from the KeyedMinHeap
+   * \note Run time: logarithmic in the size of the KeyedMinHeap
+   * \warning Behavior is undefined if the KeyedMinHeap is empty
+   */
+  void deleteMin();
+
+ private:
+  /**
+   * \brief The keys, in heap order
+   * \details As in MinHeap, keys_ is 1-indexed, so the children of index i
+   * are 2i and 2i + 1.  keys_[0] is never used.
+   */
+  std::vector<Key> keys_;
+
+  /** \brief The index in values_ of the value for each key in keys_ */
+  std::vector<size_t> valueIndices_;
+
+  /**
+   * \brief The values, in no particular order
+   * \details A value stays at the same index from insert until deleteMin, so
+   * that none of them are ever moved while the heap is reordered
+   */
+  std::vector<Value> values_;
+
+  /** \brief The indices in values_ which are not in use */
+  std::vector<size_t> freeValues_;
+
+  /**
+   * \brief Moves a key and its value index into keys_ and valueIndices_
+   * \param index       The index in keys_ at which to store them
+   * \param key         The key to store
+   * \param valueIndex  The index in values_ of the key's value
+   * \note Run time: constant
+   */
+  void place(size_t index, const Key& key, size_t valueIndex);
+
+  /**
+   * \brief Searches the subtree below an index for a key
+   * \param index   The root of the subtree
+   * \param key     The key for which to search
+   * \return True if the subtree holds a key equal to key
+   * \note Run time: linear in the size of the subtree
+   */
+  bool existsBelow(size_t index, const Key& key) const;
+
+  /**
+   * \class ConstIterator
+   * \brief A const_iterator pointing to a key of a KeyedMinHeap and its value
+   * \details This iterator performs a breadth-first traversal of keys_, so it
+   * does not visit the keys from smallest to largest.  Dereferencing it gives
+   * a pair of references to the key and its value, which live in different
+   * arrays, so there is no pair in memory for it to point to.  That makes it
+   * an input iterator as far as the STL is concerned, although it can be
+   * copied and read more than once.
+   */
+  class ConstIterator {
+   public:
+    // STL iterator type definitions
+    using difference_type = ptrdiff_t;
+    using iterator_category = std::input_iterator_tag;
+    using value_type = std::pair<Key, Value>;
+    using reference = std::pair<const Key&, const Value&>;
+    using pointer = void;
+
+    /**
+     * \brief Creates a default ConstIterator which does not point to any
+     * KeyedMinHeap
+     * \note Run time: constant
+     * \warning It is undefined behavior to dereference or ++ this iterator
+     */
+    ConstIterator();
+
+    /**
+     * \brief Compares if two ConstIterators are pointing to the same key
+     * \param rhs   The ConstIterator with which to compare
+     * \return True if this ConstIterator and rhs point to the same key
+     * \note Run time: constant
+     */
+    bool operator==(const ConstIterator& rhs) const;
+
+    /**
+     * \brief Compares if two ConstIterators are pointing to the same key
+     * \param rhs   The ConstIterator with which to compare
+     * \return False if this ConstIterator and rhs point to the same key
+     * \note Run time: constant
+     */
+    bool operator!=(const ConstIterator& rhs) const;
+
+    /**
+     * \brief Returns the key to which the ConstIterator points and its value
+     * \return A pair of references to the key and the value
+     * \note Run time: constant
+     */
+    reference operator*() const;
+
+    /**
+     * \brief Moves the ConstIterator to the next key in the KeyedMinHeap
+     * \return A reference to the ConstIterator after it was moved
+     * \note Run time: constant
+     */
+    ConstIterator& operator++();
+
+    /**
+     * \brief Moves the ConstIterator to the next key in the KeyedMinHeap
+     * \return A copy of the ConstIterator before it was moved
+     * \note Run time: constant
+     */
+    ConstIterator operator++(int);
+
+   private:
+    // KeyedMinHeap needs the private constructor below
+    friend class KeyedMinHeap;
+
+    /**
+     * \brief Creates a ConstIterator pointing to an index of keys_
+     * \param heap    The KeyedMinHeap
+     * \param index   The index in keys_
+     * \note Run time: constant
+     */
+    ConstIterator(const KeyedMinHeap* heap, size_t index);
+
+    /** \brief The KeyedMinHeap whose keys and values are visited */
+    const KeyedMinHeap* heap_;
+
+    /** \brief The index in keys_ of the current key */
+    size_t index_;
+  };
+};
+
+/**
+ * \brief Exchanges the contents of two KeyedMinHeaps
+ * \param lhs   The first KeyedMinHeap
+ * \param rhs   The second KeyedMinHeap
+ * \note Run time: constant
+ */
+template <typename Key, typename Value>
+void swap(KeyedMinHeap<Key, Value>& lhs, KeyedMinHeap<Key, Value>& rhs);
+
+/**
+ * \brief Prints a KeyedMinHeap to an ostream
+ * \param os    The ostream to which to print
+ * \param heap  The KeyedMinHeap to print
+ * \return The ostream which was passed in
+ * \note Run time: linear in the size of the KeyedMinHeap
+ */
+template <typename Key, typename Value>
+std::ostream& operator<<(std::ostream& os,
+                         const KeyedMinHeap<Key, Value>& heap);
+
+#include "keyedminheap-private.hpp"
+
+#endif  // TEMPLATES_KEYEDMINHEAP_HPP_
@@ -0,0 +1,134 @@
+/**
+ * \file latencyhistogram-private.hpp
+ * \copyright Matthew Calligaro
+ * \date January 2020
+ * \brief Provides the template implementation for the LatencyHistogram class
+ */
+
+// NOLINT(build/header_guard)
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cmath>
+#include <ostream>
+
+template <size_t SUB_BUCKET_BITS>
+LatencyHistogram<SUB_BUCKET_BITS>::LatencyHistogram()
+    : count_{0}, sum_{0}, max_{0} {
+  reset();
+}
+
+template <size_t SUB_BUCKET_BITS>
+void LatencyHistogram<SUB_BUCKET_BITS>::record(uint64_t nanoseconds) {
+  // Nothing reads the counters in any particular order relative to anything
+  // else, so relaxed increments are enough, and they never wait
+  buckets_[bucketOf(nanoseconds)].fetch_add(1, std::memory_order_relaxed);
+  count_.fetch_add(1, std::memory_order_relaxed);
+  sum_.fetch_add(nanoseconds, std::memory_order_relaxed);
+
+  uint64_t largest = max_.load(std::memory_order_relaxed);
+  while (nanoseconds > largest &&
+         !max_.compare_exchange_weak(largest, nanoseconds,
+                                     std::memory_order_relaxed)) {
+    // compare_exchange_weak has loaded the new largest, so try again
+  }
+}
+
+template <size_t SUB_BUCKET_BITS>
+void LatencyHistogram<SUB_BUCKET_BITS>::reset() {
+  for (std::atomic<uint64_t>& bucket : buckets_) {
+    bucket.store(0, std::memory_order_relaxed);
+  }
+  count_.store(0, std::memory_order_relaxed);
+  sum_.store(0, std::memory_order_relaxed);
+  max_.store(0, std::memory_order_relaxed);
+}
+
+template <size_t SUB_BUCKET_BITS>
+uint64_t LatencyHistogram<SUB_BUCKET_BITS>::count() const {
+  return count_.load(std::memory_order_relaxed);
+}
+
+template <size_t SUB_BUCKET_BITS>
+double LatencyHistogram<SUB_BUCKET_BITS>::mean() const {
+  uint64_t total = count();
+  if (total == 0) {
+    return 0.0;
+  }
+  return static_cast<double>(sum_.load(std::memory_order_relaxed)) / total;
+}
+
+template <size_t SUB_BUCKET_BITS>
+uint64_t LatencyHistogram<SUB_BUCKET_BITS>::max() const {
+  return max_.load(std::memory_order_relaxed);
+}
+
+template <size_t SUB_BUCKET_BITS>
+uint64_t LatencyHistogram<SUB_BUCKET_BITS>::percentile(double fraction) const {
+  // The measurement we want is the rank-th smallest, counting from 1
+  uint64_t total = count();
+  if (total == 0) {
+    return 0;
+  }
+  uint64_t rank = static_cast<uint64_t>(std::ceil(fraction * total));
+  rank = std::clamp(rank, uint64_t{1}, total);
+
+  uint64_t seen = 0;
+  for (size_t bucket = 0; bucket < BUCKETS; ++bucket) {
+    seen += buckets_[bucket].load(std::memory_order_relaxed);
+    if (seen >= rank) {
+      return std::min(largestIn(bucket), max());
+    }
+  }
+
+  // Other threads recorded into count_ before their buckets were visible
+  return max();
+}
+
+template <size_t SUB_BUCKET_BITS>
+std::ostream& LatencyHistogram<SUB_BUCKET_BITS>::writeText(
+    std::ostream& os) const {
+  os << "count " << count() << "\n"
+     << "mean " << mean() << " ns\n"
+     << "p50 " << percentile(0.5) << " ns\n"
+     << "p99 " << percentile(0.99) << " ns\n"
+     << "p999 " << percentile(0.999) << " ns\n"
+     << "max " << max() << " ns\n";
+  return os;
+}
+
+template <size_t SUB_BUCKET_BITS>
+std::ostream& LatencyHistogram<SUB_BUCKET_BITS>::writeJson(
+    std::ostream& os) const {
+  os << "{\"count\": " << count() << ", \"mean_ns\": " << mean()
+     << ", \"p50_ns\": " << percentile(0.5)
+     << ", \"p99_ns\": " << percentile(0.99)
+     << ", \"p999_ns\": " << percentile(0.999) << ", \"max_ns\": " << max()
+     << "}";
+  return os;
+}
+
+template <size_t SUB_BUCKET_BITS>
+constexpr size_t LatencyHistogram<SUB_BUCKET_BITS>::bucketOf(uint64_t value) {
+  // Small values get a bucket each.  Otherwise, the highest set bit picks
+  // the power of two, and the SUB_BUCKET_BITS bits below it pick the bucket
+  // within it.
+  if (value < SUB_BUCKETS) {
+    return value;
+  }
+  size_t exponent = std::bit_width(value) - 1;
+  size_t shift = exponent - SUB_BUCKET_BITS;
+  return (shift + 1) * SUB_BUCKETS + ((value >> shift) - SUB_BUCKETS);
+}
+
+template <size_t SUB_BUCKET_BITS>
+constexpr uint64_t LatencyHistogram<SUB_BUCKET_BITS>::largestIn(
+    size_t bucket) {
+  if (bucket < SUB_BUCKETS) {
+    return bucket;
+  }
+  size_t shift = bucket / SUB_BUCKETS - 1;
+  uint64_t smallest = (SUB_BUCKETS + bucket % SUB_BUCKETS) << shift;
+  return smallest + ((uint64_t{1} << shift) - 1);
+}
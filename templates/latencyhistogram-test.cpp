@@ -0,0 +1,162 @@
+/**
+ * \file latencyhistogram-test.cpp
+ * \copyright Matthew Calligaro
+ * \date January 2020
+ * \brief An assortment of ad hoc tests for the LatencyHistogram class and
+ * the MinHeap latency hooks
+ * \note These tests are not comprehensive and are NOT a good example of unit
+ * testing
+ */
+
+// Turns on the MinHeap latency hooks, which must happen before minheap.hpp
+// is included
+#define MINHEAP_LATENCY_HISTOGRAM
+
+#include <array>
+#include <cassert>
+#include <cstdint>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "latencyhistogram.hpp"
+#include "minheap.hpp"
+
+/**
+ * \brief Checks that every value lands in a bucket which contains it, and
+ * that the buckets are no wider than promised
+ */
+void bucketTest() {
+  using Histogram = LatencyHistogram<>;
+  std::vector<uint64_t> values = {0, 1, 15, 16, 17, 31, 32, 33, 1000, 1 << 20,
+                                  UINT64_MAX / 3, UINT64_MAX - 1, UINT64_MAX};
+  for (uint64_t value : values) {
+    size_t bucket = Histogram::bucketOf(value);
+    assert(bucket < Histogram::BUCKETS);
+    assert(Histogram::largestIn(bucket) >= value);
+    assert(bucket == 0 || Histogram::largestIn(bucket - 1) < value);
+  }
+  for (size_t bucket = 1; bucket < Histogram::BUCKETS; ++bucket) {
+    uint64_t smallest = Histogram::largestIn(bucket - 1) + 1;
+    uint64_t largest = Histogram::largestIn(bucket);
+    assert(Histogram::bucketOf(smallest) == bucket);
+    assert(Histogram::bucketOf(largest) == bucket);
+    assert(largest - smallest <= smallest / Histogram::SUB_BUCKETS);
+  }
+  static_assert(Histogram::bucketOf(UINT64_MAX) == Histogram::BUCKETS - 1);
+}
+
+/**
+ * \brief Checks the percentiles of some known measurements
+ */
+void percentileTest() {
+  LatencyHistogram<> histogram;
+  assert(histogram.count() == 0);
+  assert(histogram.percentile(0.5) == 0);
+
+  for (uint64_t value = 1; value <= 10000; ++value) {
+    histogram.record(value);
+  }
+  histogram.record(1000000);
+  assert(histogram.count() == 10001);
+  assert(histogram.max() == 1000000);
+
+  // Each answer is the top of a bucket, so it is at most 1/16 too high
+  uint64_t p50 = histogram.percentile(0.5);
+  assert(p50 >= 5001 && p50 <= 5001 + 5001 / 16);
+  uint64_t p99 = histogram.percentile(0.99);
+  assert(p99 >= 9901 && p99 <= 9901 + 9901 / 16);
+  assert(histogram.percentile(1.0) == 1000000);
+  assert(histogram.percentile(0.0) == 1);
+  assert(histogram.mean() > 5000.0 && histogram.mean() < 5200.0);
+
+  std::ostringstream text;
+  histogram.writeText(text);
+  assert(text.str().find("max 1000000 ns\n") != std::string::npos);
+  std::ostringstream json;
+  histogram.writeJson(json);
+  assert(json.str().front() == '{' && json.str().back() == '}');
+  assert(json.str().find("\"count\": 10001") != std::string::npos);
+
+  histogram.reset();
+  assert(histogram.count() == 0 && histogram.max() == 0);
+}
+
+/**
+ * \brief Records from several threads at once
+ */
+void threadTest() {
+  const size_t THREADS = 4;
+  const uint64_t PER_THREAD = 20000;
+  LatencyHistogram<> histogram;
+  std::vector<std::thread> threads;
+  for (size_t thread = 0; thread < THREADS; ++thread) {
+    threads.emplace_back([&histogram, thread] {
+      for (uint64_t i = 0; i < PER_THREAD; ++i) {
+        histogram.record(i * THREADS + thread);
+      }
+    });
+  }
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+  assert(histogram.count() == THREADS * PER_THREAD);
+  assert(histogram.max() == THREADS * PER_THREAD - 1);
+}
+
+/**
+ * \brief Builds a sorted array at compile time, which only works if the
+ * hooks do nothing during constant evaluation
+ * \return The sorted array
+ */
+constexpr std::array<int, 5> compileTimeSort() {
+  MinHeap<int> heap;
+  for (int value : {3, 1, 4, 1, 5}) {
+    heap.insert(value);
+  }
+  std::array<int, 5> sorted = {};
+  for (int& value : sorted) {
+    value = heap.peakMin();
+    heap.deleteMin();
+  }
+  return sorted;
+}
+
+/**
+ * \brief Checks that MinHeap records its operations
+ */
+void hookTest() {
+  MinHeapLatency& latency = MinHeapLatency::global();
+  uint64_t inserts = latency.insert.count();
+  uint64_t deletes = latency.deleteMin.count();
+  uint64_t resizes = latency.resize.count();
+
+  MinHeap<int> heap;
+  for (int i = 0; i < 1000; ++i) {
+    heap.insert(i);
+  }
+  while (!heap.empty()) {
+    heap.deleteMin();
+  }
+  assert(latency.insert.count() == inserts + 1000);
+  assert(latency.deleteMin.count() == deletes + 1000);
+
+  // array_ doubled from 2 slots to 1024 and halved back down
+  assert(latency.resize.count() >= resizes + 2 * 9);
+
+  std::ostringstream json;
+  latency.writeJson(json);
+  assert(json.str().find("\"resize\": {") != std::string::npos);
+  static_assert(compileTimeSort() == std::array<int, 5>{1, 1, 3, 4, 5});
+}
+
+int main() {
+  bucketTest();
+  percentileTest();
+  threadTest();
+  hookTest();
+
+  std::cout << "All tests passed" << std::endl;
+  return 0;
+}
@@ -0,0 +1,143 @@
+/**
+ * \file latencyhistogram.hpp
+ * \copyright Matthew Calligaro
+ * \date January 2020
+ * \brief Declares the LatencyHistogram class
+ */
+
+#ifndef TEMPLATES_LATENCYHISTOGRAM_HPP_
+#define TEMPLATES_LATENCYHISTOGRAM_HPP_
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+
+/**
+ * \class LatencyHistogram
+ * \brief Counts how long operations take, in nanoseconds, so that rare slow
+ * operations can be found as well as the typical ones
+ * \details An average hides the occasional slow operation, and keeping
+ * every measurement takes too much memory, so a LatencyHistogram counts the
+ * measurements in buckets.  Like an HdrHistogram, the buckets grow with the
+ * values they hold: each power of two is split into 2^SUB_BUCKET_BITS equal
+ * buckets, so every bucket is within 1 / 2^SUB_BUCKET_BITS of its values
+ * (6.25% by default) whether it holds nanoseconds or seconds, and 64 powers
+ * of two need only about a thousand counters.
+ *
+ * Each counter is a std::atomic which is only ever incremented, so any
+ * number of threads may record into one LatencyHistogram at once without a
+ * lock.  Reading a percentile while other threads are recording gives an
+ * answer which is correct for some of the measurements in progress.
+ * \note SUB_BUCKET_BITS must be from 1 to 8
+ */
+template <size_t SUB_BUCKET_BITS = 4>
+class LatencyHistogram {
+  static_assert(SUB_BUCKET_BITS >= 1 && SUB_BUCKET_BITS <= 8,
+                "Choose between 2 and 256 buckets per power of two");
+
+ public:
+  /** \brief The number of buckets each power of two is split into */
+  static constexpr size_t SUB_BUCKETS = size_t{1} << SUB_BUCKET_BITS;
+
+  /** \brief The number of buckets, enough for every uint64_t */
+  static constexpr size_t BUCKETS = (64 - SUB_BUCKET_BITS + 1) * SUB_BUCKETS;
+
+  /**
+   * \brief Creates an empty LatencyHistogram
+   * \note Run time: linear in BUCKETS
+   */
+  LatencyHistogram();
+
+  LatencyHistogram(const LatencyHistogram& other) = delete;
+  LatencyHistogram& operator=(const LatencyHistogram& other) = delete;
+
+  /**
+   * \brief Counts one measurement
+   * \param nanoseconds   The measurement
+   * \note Run time: constant
+   */
+  void record(uint64_t nanoseconds);
+
+  /**
+   * \brief Forgets every measurement
+   * \note Run time: linear in BUCKETS
+   * \warning Measurements recorded by other threads during reset may be
+   * partly kept
+   */
+  void reset();
+
+  /**
+   * \brief Returns the number of measurements
+   * \return The number of measurements
+   * \note Run time: constant
+   */
+  uint64_t count() const;
+
+  /**
+   * \brief Returns the average measurement
+   * \return The mean, or 0 if there are no measurements
+   * \note Run time: constant
+   */
+  double mean() const;
+
+  /**
+   * \brief Returns the largest measurement
+   * \return The exact largest measurement, or 0 if there are none
+   * \note Run time: constant
+   */
+  uint64_t max() const;
+
+  /**
+   * \brief Returns a value which at least a fraction of the measurements do
+   * not exceed
+   * \param fraction  The fraction, such as 0.99 for the 99th percentile
+   * \return The largest value in the bucket which holds that measurement (but
+   * no more than max), or 0 if there are no measurements
+   * \note Run time: linear in BUCKETS
+   */
+  uint64_t percentile(double fraction) const;
+
+  /**
+   * \brief Writes the count, mean, p50, p99, p999 and max as lines of text
+   * \param os  The ostream to which to write
+   * \return The ostream which was passed in
+   * \note Run time: linear in BUCKETS
+   */
+  std::ostream& writeText(std::ostream& os) const;
+
+  /**
+   * \brief Writes the count, mean, p50, p99, p999 and max as a JSON object
+   * \param os  The ostream to which to write
+   * \return The ostream which was passed in
+   * \note Run time: linear in BUCKETS
+   */
+  std::ostream& writeJson(std::ostream& os) const;
+
+  /**
+   * \brief Returns the bucket which counts a value
+   * \param value   The value
+   * \return The index of its bucket
+   * \note Run time: constant
+   */
+  static constexpr size_t bucketOf(uint64_t value);
+
+  /**
+   * \brief Returns the largest value a bucket counts
+   * \param bucket  The index of the bucket
+   * \return The largest value which bucketOf maps to bucket
+   * \note Run time: constant
+   */
+  static constexpr uint64_t largestIn(size_t bucket);
+
+ private:
+  std::array<std::atomic<uint64_t>, BUCKETS> buckets_;
+  std::atomic<uint64_t> count_;
+  std::atomic<uint64_t> sum_;
+  std::atomic<uint64_t> max_;
+};
+
+#include "latencyhistogram-private.hpp"
+
+#endif  // TEMPLATES_LATENCYHISTOGRAM_HPP_
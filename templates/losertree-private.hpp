@@ -0,0 +1,129 @@
+/**
+ * \file losertree-private.hpp
+ * \copyright Matthew Calligaro
+ * \date January 2020
+ * \brief Provides the template implementation for the LoserTree class and the
+ * kWayMerge function
+ */
+
+// NOLINT(build/header_guard)
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+/*******************************************************************************
+ * LoserTree implementation
+ ******************************************************************************/
+
+template <typename InputIt>
+LoserTree<InputIt>::LoserTree(
+    const std::vector<std::pair<InputIt, InputIt>>& ranges)
+    : k_{ranges.size()},
+      ranges_{ranges},
+      heads_(CACHES_HEADS ? k_ : 0),
+      tree_(std::max(k_, size_t{1}), Node{nullptr, 0}) {
+  // Play every match from the bottom of the tree up.  winners[i] is the
+  // range which won at node i, and the leaves are their own winners.
+  std::vector<Node> winners(2 * k_);
+  for (size_t r = 0; r < k_; ++r) {
+    winners[k_ + r] = nodeFor(r);
+  }
+  for (size_t node = k_ > 0 ? k_ - 1 : 0; node > 0; --node) {
+    const Node& left = winners[2 * node];
+    const Node& right = winners[2 * node + 1];
+    if (beats(left, right)) {
+      winners[node] = left;
+      tree_[node] = right;
+    } else {
+      winners[node] = right;
+      tree_[node] = left;
+    }
+  }
+  if (k_ > 0) {
+    tree_[0] = winners[1];
+  }
+}
+
+template <typename InputIt>
+bool LoserTree<InputIt>::empty() const {
+  return tree_[0].head == nullptr;
+}
+
+template <typename InputIt>
+typename LoserTree<InputIt>::reference LoserTree<InputIt>::peakMin() const {
+  if constexpr (CACHES_HEADS) {
+    return *tree_[0].head;
+  } else {
+    return *ranges_[tree_[0].range].first;
+  }
+}
+
+template <typename InputIt>
+void LoserTree<InputIt>::deleteMin() {
+  size_t range = tree_[0].range;
+  ++ranges_[range].first;
+  Node winner = nodeFor(range);
+
+  // Only the matches on the path from the winner's leaf to the root involved
+  // the element we just removed, so we replay them against the losers stored
+  // along the way.  Whichever range loses stays at the node.
+  for (size_t node = (k_ + range) / 2; node > 0; node /= 2) {
+    if (beats(tree_[node], winner)) {
+      std::swap(tree_[node], winner);
+    }
+  }
+  tree_[0] = winner;
+}
+
+template <typename InputIt>
+typename LoserTree<InputIt>::Node LoserTree<InputIt>::nodeFor(
+    size_t range) {
+  const std::pair<InputIt, InputIt>& r = ranges_[range];
+  if (r.first == r.second) {
+    return Node{nullptr, range};
+  }
+
+  // An iterator which returns by value gives a temporary, so we keep a copy
+  // of it in heads_, which never reallocates.  Otherwise the element stays
+  // put until the iterator is incremented, and so does the pointer to it.
+  if constexpr (CACHES_HEADS) {
+    std::optional<value_type>& head = heads_[range];
+    head.emplace(*r.first);
+    return Node{&*head, range};
+  } else {
+    return Node{&*r.first, range};
+  }
+}
+
+template <typename InputIt>
+bool LoserTree<InputIt>::beats(const Node& lhs, const Node& rhs) {
+  // A range with no elements left loses every match
+  if (rhs.head == nullptr) {
+    return true;
+  }
+  if (lhs.head == nullptr) {
+    return false;
+  }
+
+  // Break ties in favor of the earlier range so that the merge is stable.
+  // Either way, each match takes a single comparison.
+  if (lhs.range < rhs.range) {
+    return !(*rhs.head < *lhs.head);
+  }
+  return *lhs.head < *rhs.head;
+}
+
+/*******************************************************************************
+ * kWayMerge implementation
+ ******************************************************************************/
+
+template <typename InputIt, typename OutputIt>
+OutputIt kWayMerge(const std::vector<std::pair<InputIt, InputIt>>& ranges,
+                   OutputIt out) {
+  for (LoserTree<InputIt> tree(ranges); !tree.empty(); tree.deleteMin()) {
+    *out = tree.peakMin();
+    ++out;
+  }
+  return out;
+}
@@ -0,0 +1,192 @@
+/**
+ * \file losertree-test.cpp
+ * \copyright Matthew Calligaro
+ * \date January 2020
+ * \brief An assortment of ad hoc tests for the LoserTree class and the
+ * kWayMerge function
+ * \note These tests are not comprehensive and are NOT a good example of unit
+ * testing
+ */
+
+#include <algorithm>
+#include <cassert>
+#include <cstdlib>
+#include <iostream>
+#include <iterator>
+#include <new>
+#include <random>
+#include <ranges>
+#include <sstream>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "losertree.hpp"
+
+/** \brief The number of calls to operator new made by the whole program */
+size_t allocationCount = 0;
+
+// We replace the global operator new so that tests can check whether an
+// operation allocates memory
+void* operator new(size_t size) {
+  ++allocationCount;
+  void* memory = std::malloc(size == 0 ? 1 : size);
+  if (memory == nullptr) {
+    throw std::bad_alloc();
+  }
+  return memory;
+}
+
+void operator delete(void* memory) noexcept { std::free(memory); }
+
+void operator delete(void* memory, size_t) noexcept { std::free(memory); }
+
+/**
+ * \struct Counted
+ * \brief An int which counts the comparisons made between Counted values,
+ * and remembers which range it came from
+ */
+struct Counted {
+  static size_t comparisons;
+  int value;
+  size_t range;
+
+  bool operator<(const Counted& rhs) const {
+    ++comparisons;
+    return value < rhs.value;
+  }
+};
+
+size_t Counted::comparisons = 0;
+
+/**
+ * \brief Merges random ranges and compares the result against std::sort
+ */
+void mergeTest() {
+  std::default_random_engine engine(2020);
+  for (size_t k : {0, 1, 2, 3, 5, 8, 13, 64, 100}) {
+    std::vector<std::vector<int>> inputs(k);
+    std::vector<int> expected;
+    for (std::vector<int>& input : inputs) {
+      // Some ranges are empty, and the values repeat often
+      input.resize(engine() % 50);
+      for (int& value : input) {
+        value = engine() % 100;
+      }
+      std::sort(input.begin(), input.end());
+      expected.insert(expected.end(), input.begin(), input.end());
+    }
+    std::sort(expected.begin(), expected.end());
+
+    std::vector<std::pair<std::vector<int>::const_iterator,
+                          std::vector<int>::const_iterator>>
+        ranges;
+    for (const std::vector<int>& input : inputs) {
+      ranges.push_back({input.cbegin(), input.cend()});
+    }
+    std::vector<int> merged;
+    kWayMerge(ranges, std::back_inserter(merged));
+    assert(merged == expected);
+  }
+}
+
+/**
+ * \brief Checks that equal elements keep the order of their ranges, that
+ * each element costs at most ceil(log2(k)) comparisons, and that merging
+ * does not allocate memory
+ */
+void tournamentTest() {
+  const size_t K = 100;
+  const size_t DEPTH = 7;
+  std::vector<std::vector<Counted>> inputs(K);
+  for (size_t r = 0; r < K; ++r) {
+    for (int value = 0; value < 20; ++value) {
+      inputs[r].push_back(Counted{value / 4, r});
+    }
+  }
+  std::vector<std::pair<const Counted*, const Counted*>> ranges;
+  for (const std::vector<Counted>& input : inputs) {
+    ranges.push_back({input.data(), input.data() + input.size()});
+  }
+
+  LoserTree<const Counted*> tree(ranges);
+  Counted previous = tree.peakMin();
+  size_t count = 0;
+  size_t allocations = allocationCount;
+  for (; !tree.empty(); tree.deleteMin()) {
+    const Counted& next = tree.peakMin();
+    assert(previous.value < next.value ||
+           (previous.value == next.value && previous.range <= next.range));
+    previous = next;
+    ++count;
+  }
+  assert(allocationCount == allocations);
+  assert(count == K * 20);
+
+  // Building the tree plays K - 1 matches, and each element after that
+  // replays at most DEPTH
+  Counted::comparisons = 0;
+  LoserTree<const Counted*> counted(ranges);
+  assert(Counted::comparisons == K - 1);
+  for (; !counted.empty(); counted.deleteMin()) {
+  }
+  assert(Counted::comparisons <= K - 1 + count * DEPTH);
+}
+
+/**
+ * \brief Merges ranges which are read from streams one element at a time
+ */
+void streamTest() {
+  std::istringstream evens("0 2 4 6 8");
+  std::istringstream odds("1 3 5 7 9 11");
+  std::istringstream empty("");
+  std::vector<std::pair<std::istream_iterator<int>, std::istream_iterator<int>>>
+      ranges = {{std::istream_iterator<int>(evens), {}},
+                {std::istream_iterator<int>(empty), {}},
+                {std::istream_iterator<int>(odds), {}}};
+
+  std::vector<int> merged;
+  kWayMerge(ranges, std::back_inserter(merged));
+  assert((merged == std::vector<int>{0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 11}));
+}
+
+/**
+ * \brief Merges ranges whose iterators return their elements by value, so
+ * the tree has nothing to point to but its own copies
+ */
+void generatorTest() {
+  // Each range holds the multiples of its step, computed as they are read
+  auto multiples = [](int step, int count) {
+    return std::views::iota(0, count) |
+           std::views::transform([step](int i) { return i * step; });
+  };
+  std::vector<decltype(multiples(0, 0))> views;
+  std::vector<int> expected;
+  for (int step : {2, 3, 5}) {
+    views.push_back(multiples(step, 10));
+    for (int i = 0; i < 10; ++i) {
+      expected.push_back(i * step);
+    }
+  }
+  std::sort(expected.begin(), expected.end());
+
+  using Iterator = std::ranges::iterator_t<decltype(multiples(0, 0))>;
+  static_assert(!std::is_lvalue_reference_v<
+                std::iterator_traits<Iterator>::reference>);
+  std::vector<std::pair<Iterator, Iterator>> ranges;
+  for (auto& view : views) {
+    ranges.push_back({view.begin(), view.end()});
+  }
+  std::vector<int> merged;
+  kWayMerge(ranges, std::back_inserter(merged));
+  assert(merged == expected);
+}
+
+int main() {
+  mergeTest();
+  tournamentTest();
+  streamTest();
+  generatorTest();
+
+  std::cout << "All tests passed" << std::endl;
+  return 0;
+}
@@ -0,0 +1,155 @@
+/**
+ * \file losertree.hpp
+ * \copyright Matthew Calligaro
+ * \date January 2020
+ * \brief Declares the LoserTree class and the kWayMerge function
+ */
+
+#ifndef TEMPLATES_LOSERTREE_HPP_
+#define TEMPLATES_LOSERTREE_HPP_
+
+#include <cstddef>
+#include <iterator>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/**
+ * \class LoserTree
+ * \brief A tournament tree which repeatedly finds the smallest of the next
+ * elements of K sorted input ranges
+ * \details The K ranges are the leaves of a binary tree, and each internal
+ * node remembers the range which lost the match played at that node, while
+ * the winner moves up to play at the next node.  After the overall winner's
+ * element is taken, only the matches on the path from its leaf to the root
+ * need to be replayed, and each of them compares against the loser stored
+ * at that node.  So each element costs about log2(K) comparisons, against
+ * roughly twice as many for a MinHeap deleteMin and insert, and the tree
+ * never moves or copies the elements themselves.
+ *
+ * Ties are won by the range which was passed in first, so merging equal
+ * elements keeps the order of the ranges (the merge is stable).
+ * \note The template type InputIt may be any input iterator, including one
+ * which generates its elements on demand, such as std::istream_iterator, or
+ * one which returns its elements by value.  In the last case the tree keeps a
+ * copy of the next element of each range.  Its value_type must support
+ * operator<, and the copy constructor if InputIt returns by value.
+ * \warning The ranges must be sorted and must stay valid while the LoserTree
+ * is in use
+ */
+template <typename InputIt>
+class LoserTree {
+ public:
+  // STL container type definitions
+  using value_type = typename std::iterator_traits<InputIt>::value_type;
+  using size_type = size_t;
+  using reference = typename std::iterator_traits<InputIt>::reference;
+
+  /**
+   * \brief Creates a LoserTree over some sorted ranges
+   * \param ranges  The first and past-the-end iterator of each range
+   * \note Run time: linear in the number of ranges
+   */
+  explicit LoserTree(const std::vector<std::pair<InputIt, InputIt>>& ranges);
+
+  /**
+   * \brief Returns whether every range has been used up
+   * \return True if there are no elements left
+   * \note Run time: constant
+   */
+  bool empty() const;
+
+  /**
+   * \brief Returns the smallest of the next elements of the ranges
+   * \return The element at the front of the winning range
+   * \note Run time: constant
+   * \warning Behavior is undefined if the LoserTree is empty
+   */
+  reference peakMin() const;
+
+  /**
+   * \brief Moves past the smallest element and finds the next one
+   * \note Run time: logarithmic in the number of ranges
+   * \warning Behavior is undefined if the LoserTree is empty
+   */
+  void deleteMin();
+
+ private:
+  /** \brief The number of ranges, which is the number of leaves */
+  size_t k_;
+
+  /**
+   * \brief The next element and the past-the-end iterator of each range
+   */
+  std::vector<std::pair<InputIt, InputIt>> ranges_;
+
+  /**
+   * \brief Whether dereferencing an InputIt gives a temporary, which the
+   * tree cannot point to, so it copies the next element of each range
+   */
+  static constexpr bool CACHES_HEADS = !std::is_lvalue_reference_v<reference>;
+
+  /**
+   * \brief The copy of the next element of each range if CACHES_HEADS, and
+   * empty otherwise
+   */
+  std::vector<std::optional<value_type>> heads_;
+
+  /**
+   * \struct Node
+   * \brief A range which took part in a match, together with a pointer to
+   * its next element, so that replaying a match does not need to look the
+   * range up in ranges_
+   */
+  struct Node {
+    /** \brief The next element of the range, or nullptr if it is used up */
+    const value_type* head;
+
+    /** \brief The index of the range */
+    size_t range;
+  };
+
+  /**
+   * \brief The loser of the match at each internal node, 1 to k_ - 1, and
+   * the overall winner in tree_[0]
+   * \details As in MinHeap, the children of node i are 2i and 2i + 1.  The
+   * leaf for range r is node k_ + r, which is not stored.
+   */
+  std::vector<Node> tree_;
+
+  /**
+   * \brief Creates the Node for the current position of a range
+   * \param range   The index of the range
+   * \return A Node pointing to the next element of the range
+   * \note Run time: constant, plus a copy of the element if CACHES_HEADS
+   */
+  Node nodeFor(size_t range);
+
+  /**
+   * \brief Plays the match between two ranges
+   * \param lhs   The first range
+   * \param rhs   The second range
+   * \return True if lhs wins, which means its next element is smaller, or
+   * equal and lhs was passed in first, or rhs has no elements left
+   * \note Run time: constant
+   */
+  static bool beats(const Node& lhs, const Node& rhs);
+};
+
+/**
+ * \brief Merges sorted ranges into one sorted output
+ * \param ranges  The first and past-the-end iterator of each range
+ * \param out     The output iterator to which to write the merged elements
+ * \return The output iterator after the last element written
+ * \note Run time: O(n log(k)), where n is the total number of elements and
+ * k is the number of ranges
+ * \note Equal elements are written in the order of their ranges
+ */
+template <typename InputIt, typename OutputIt>
+OutputIt kWayMerge(const std::vector<std::pair<InputIt, InputIt>>& ranges,
+                   OutputIt out);
+
+#include "losertree-private.hpp"
+
+#endif  // TEMPLATES_LOSERTREE_HPP_
@@ -10,59 +10,167 @@
 // NOLINT(build/header_guard)
 
 #include <algorithm>
+#include <bit>
+#include <cstring>
+#include <functional>
+#include <iterator>
 #include <ostream>
-#include <queue>
+#include <thread>
+#include <type_traits>
+#include <unordered_set>
 #include <utility>
+#include <vector>
+
+/*******************************************************************************
+ * MinHeapKeyPrefix implementation
+ ******************************************************************************/
+
+// A member of a full specialization is not a template, but constexpr makes it
+// inline, so it may still be defined in a header
+constexpr uint64_t MinHeapKeyPrefix<std::string>::of(const std::string& key) {
+  // Most strings are long enough to load all 8 bytes at once, and on a
+  // little-endian processor one instruction reverses them
+  if (!std::is_constant_evaluated() && key.size() >= sizeof(uint64_t)) {
+    uint64_t prefix;
+    std::memcpy(&prefix, key.data(), sizeof(prefix));
+    if constexpr (std::endian::native == std::endian::little) {
+      prefix = __builtin_bswap64(prefix);
+    }
+    return prefix;
+  }
+
+  uint64_t prefix = 0;
+  for (size_t i = 0; i < sizeof(uint64_t); ++i) {
+    unsigned char byte = i < key.size() ? key[i] : 0;
+    prefix = (prefix << 8) | byte;
+  }
+  return prefix;
+}
 
 /*******************************************************************************
  * MinHeap implementation
  ******************************************************************************/
 
-template <typename T>
-MinHeap<T>::MinHeap() : arraySize_{2}, size_{0}, array_{new T*[arraySize_]} {}
+template <typename T, size_t INLINE_CAPACITY, typename Prefetch>
+constexpr MinHeap<T, INLINE_CAPACITY, Prefetch>::MinHeap()
+    : arraySize_{INLINE_SLOTS}, size_{0}, array_{inlineArray_} {}
 
-template <typename T>
-MinHeap<T>::MinHeap(const MinHeap& other)
-    : arraySize_{other.arraySize_},
-      size_{other.size_},
-      array_{new T*[arraySize_]} {
-  // We must manually copy each element in order to make a deep copy
-  for (size_t i = 1; i <= size_; ++i) {
-    array_[i] = new T(*other.array_[i]);
+// A delegating constructor: we first create an empty MinHeap with the default
+// constructor and then copy other's elements into it
+template <typename T, size_t INLINE_CAPACITY, typename Prefetch>
+constexpr MinHeap<T, INLINE_CAPACITY, Prefetch>::MinHeap(const MinHeap& other)
+    : MinHeap() {
+  copyFrom(other);
+}
+
+// A member function template of a class template needs two template headers:
+// one for the class and one for the constructor itself
+template <typename T, size_t INLINE_CAPACITY, typename Prefetch>
+template <typename Iter>
+constexpr MinHeap<T, INLINE_CAPACITY, Prefetch>::MinHeap(Iter first, Iter last,
+                                               size_t threads)
+    : MinHeap() {
+  // std::distance would use up a single-pass range before we could copy it
+  using Category = typename std::iterator_traits<Iter>::iterator_category;
+  static_assert(std::is_base_of<std::forward_iterator_tag, Category>::value,
+                "The range must be readable more than once");
+
+  // Choose the same arraySize_ that repeated inserts would have reached
+  size_t count = std::distance(first, last);
+  while (count > arraySize_ - 1) {
+    arraySize_ *= 2;
+  }
+  if (arraySize_ > INLINE_SLOTS) {
+    array_ = Slots::allocate(arraySize_);
   }
+  size_ = count;
+
+  // The first elements may go into pool_, which is not safe to share between
+  // threads, so we always create them on this thread
+  size_t index = 1;
+  for (; index <= size_ && index <= INLINE_CAPACITY; ++index, ++first) {
+    array_[index] = makeSlot(createElement(*first));
+  }
+
+  // If we can jump to any element of the input in constant time, the threads
+  // can each copy a separate block of the remaining elements
+  if (std::is_base_of<std::random_access_iterator_tag, Category>::value &&
+      threads > 1 && !std::is_constant_evaluated()) {
+    size_t start = index;
+    parallelFor(threads, [this, first, start, threads](size_t thread) {
+      size_t blockSize = (size_ - start + threads) / threads;
+      size_t blockStart = start + thread * blockSize;
+      size_t blockEnd = std::min(blockStart + blockSize, size_ + 1);
+      for (size_t i = blockStart; i < blockEnd; ++i) {
+        array_[i] = makeSlot(new T(*std::next(first, i - start)));
+      }
+    });
+  } else {
+    for (; index <= size_; ++index, ++first) {
+      array_[index] = makeSlot(createElement(*first));
+    }
+  }
+
+  heapify(threads);
 }
 
-template <typename T>
-MinHeap<T>& MinHeap<T>::operator=(const MinHeap& other) {
+template <typename T, size_t INLINE_CAPACITY, typename Prefetch>
+constexpr MinHeap<T, INLINE_CAPACITY, Prefetch>&
+MinHeap<T, INLINE_CAPACITY, Prefetch>::operator=(const MinHeap& other) {
   // It is idiomatic to implement operator= by leveraging the copy constructor
-  // and swap
-  MinHeap copy = other;
-  swap(copy);
+  // and swap.  However, when elements are stored inline, swap must copy them
+  // (see below), so we instead clear this MinHeap and copy other directly.
+  if (INLINE_CAPACITY == 0) {
+    MinHeap copy = other;
+    swap(copy);
+  } else if (this != &other) {
+    clear();
+    copyFrom(other);
+  }
   return *this;
 }
 
-template <typename T>
-MinHeap<T>::~MinHeap() {
-  // We must manually delete each element and array_ itself
-  for (size_t i = 1; i <= size_; ++i) {
-    delete array_[i];
-  }
-  delete[] array_;
+template <typename T, size_t INLINE_CAPACITY, typename Prefetch>
+constexpr MinHeap<T, INLINE_CAPACITY, Prefetch>::~MinHeap() {
+  clear();
 }
 
-template <typename T>
-void MinHeap<T>::swap(MinHeap& other) {
-  // We only need to swap the pointers (which takes constant time); there is no
-  // need to move the objects on the heap
-  std::swap(arraySize_, other.arraySize_);
-  std::swap(size_, other.size_);
-  std::swap(array_, other.array_);
+template <typename T, size_t INLINE_CAPACITY, typename Prefetch>
+constexpr void MinHeap<T, INLINE_CAPACITY, Prefetch>::swap(MinHeap& other) {
+  if (INLINE_CAPACITY == 0) {
+    // Every element is on the heap, so we only need to swap the pointers
+    // (which takes constant time); there is no need to move the objects on the
+    // heap.  The one catch is that an array_ which points to inlineArray_
+    // must keep pointing into its own MinHeap after the swap.
+    bool thisInline = array_ == inlineArray_;
+    bool otherInline = other.array_ == other.inlineArray_;
+    std::swap(inlineArray_, other.inlineArray_);
+    std::swap(arraySize_, other.arraySize_);
+    std::swap(size_, other.size_);
+    std::swap(array_, other.array_);
+    std::swap(erased_, other.erased_);
+    if (thisInline) {
+      other.array_ = other.inlineArray_;
+    }
+    if (otherInline) {
+      array_ = inlineArray_;
+    }
+  } else {
+    // Elements in pool_ live inside the MinHeap object itself, so they cannot
+    // be handed to other by swapping pointers.  Instead, we exchange copies.
+    MinHeap copy = *this;
+    clear();
+    copyFrom(other);
+    other.clear();
+    other.copyFrom(copy);
+  }
 }
 
-template <typename T>
-bool MinHeap<T>::operator==(const MinHeap& rhs) const {
+template <typename T, size_t INLINE_CAPACITY, typename Prefetch>
+constexpr bool MinHeap<T, INLINE_CAPACITY, Prefetch>::operator==(
+    const MinHeap& rhs) const {
   // If two MinHeap's have a different number of elements, they cannot be equal
-  if (size_ != rhs.size_) {
+  if (size() != rhs.size()) {
     return false;
   }
 
@@ -70,7 +178,7 @@ bool MinHeap<T>::operator==(const MinHeap& rhs) const {
   // two MinHeaps may have the exact same elements but in different orders.
   // Instead, we copy each MinHeap and compare and remove the min element until
   // both are empty
-  for (MinHeap<T> lcopy(*this), rcopy(rhs); !lcopy.empty();
+  for (MinHeap lcopy(*this), rcopy(rhs); !lcopy.empty();
        lcopy.deleteMin(), rcopy.deleteMin()) {
     if (lcopy.peakMin() != rcopy.peakMin()) {
       return false;
@@ -80,63 +188,78 @@ bool MinHeap<T>::operator==(const MinHeap& rhs) const {
   return true;
 }
 
-template <typename T>
-bool MinHeap<T>::operator!=(const MinHeap& rhs) const {
+template <typename T, size_t INLINE_CAPACITY, typename Prefetch>
+constexpr bool MinHeap<T, INLINE_CAPACITY, Prefetch>::operator!=(
+    const MinHeap& rhs) const {
   // It is idiomatic to implement operator!= by leveraging operator==
   return !(*this == rhs);
 }
 
-template <typename T>
+template <typename T, size_t INLINE_CAPACITY, typename Prefetch>
 // Due to templating, the compiler does not realize that "MinHeap<T>::iterator"
 // is a typename, so we must explicitly add the typename keyword before the
 // return type of this method
-typename MinHeap<T>::iterator MinHeap<T>::begin() {
+constexpr typename MinHeap<T, INLINE_CAPACITY, Prefetch>::iterator
+MinHeap<T, INLINE_CAPACITY, Prefetch>::begin() {
   // Because array_ is a 1-indexed array, array_[1] is always a pointer to the
-  // first element
+  // first element, once any erased elements are gone
+  compactBeforeIterating();
   return iterator(array_ + 1);
 }
 
-template <typename T>
-typename MinHeap<T>::iterator MinHeap<T>::end() {
+template <typename T, size_t INLINE_CAPACITY, typename Prefetch>
+constexpr typename MinHeap<T, INLINE_CAPACITY, Prefetch>::iterator
+MinHeap<T, INLINE_CAPACITY, Prefetch>::end() {
   // array_[size_] points to the last element, so array_[size_ + 1] points to
   // the past-the-end element
+  compactBeforeIterating();
   return iterator(array_ + size_ + 1);
 }
 
-template <typename T>
-typename MinHeap<T>::const_iterator MinHeap<T>::begin() const {
+template <typename T, size_t INLINE_CAPACITY, typename Prefetch>
+constexpr typename MinHeap<T, INLINE_CAPACITY, Prefetch>::const_iterator
+MinHeap<T, INLINE_CAPACITY, Prefetch>::begin() const {
   // The const version of begin can leverage cbegin
   return cbegin();
 }
 
-template <typename T>
-typename MinHeap<T>::const_iterator MinHeap<T>::end() const {
+template <typename T, size_t INLINE_CAPACITY, typename Prefetch>
+constexpr typename MinHeap<T, INLINE_CAPACITY, Prefetch>::const_iterator
+MinHeap<T, INLINE_CAPACITY, Prefetch>::end() const {
   // The const version of end can leverage cend
   return cend();
 }
 
-template <typename T>
-typename MinHeap<T>::const_iterator MinHeap<T>::cbegin() const {
+template <typename T, size_t INLINE_CAPACITY, typename Prefetch>
+constexpr typename MinHeap<T, INLINE_CAPACITY, Prefetch>::const_iterator
+MinHeap<T, INLINE_CAPACITY, Prefetch>::cbegin() const {
+  compactBeforeIterating();
   return const_iterator(array_ + 1);
 }
 
-template <typename T>
-typename MinHeap<T>::const_iterator MinHeap<T>::cend() const {
+template <typename T, size_t INLINE_CAPACITY, typename Prefetch>
+constexpr typename MinHeap<T, INLINE_CAPACITY, Prefetch>::const_iterator
+MinHeap<T, INLINE_CAPACITY, Prefetch>::cend() const {
+  compactBeforeIterating();
   return const_iterator(array_ + size_ + 1);
 }
 
-template <typename T>
-typename MinHeap<T>::size_type MinHeap<T>::size() const {
-  return size_;
+template <typename T, size_t INLINE_CAPACITY, typename Prefetch>
+constexpr typename MinHeap<T, INLINE_CAPACITY, Prefetch>::size_type
+MinHeap<T, INLINE_CAPACITY, Prefetch>::size() const {
+  // Erased elements stay in array_ until they are discarded, but they are no
+  // longer part of the MinHeap
+  return erased_ == nullptr ? size_ : size_ - erased_->size();
 }
 
-template <typename T>
-bool MinHeap<T>::empty() const {
+template <typename T, size_t INLINE_CAPACITY, typename Prefetch>
+constexpr bool MinHeap<T, INLINE_CAPACITY, Prefetch>::empty() const {
   return size_ == 0;
 }
 
-template <typename T>
-std::ostream& MinHeap<T>::print(std::ostream& os, bool complete) const {
+template <typename T, size_t INLINE_CAPACITY, typename Prefetch>
+std::ostream& MinHeap<T, INLINE_CAPACITY, Prefetch>::print(std::ostream& os,
+                                                 bool complete) const {
   os << "[";
 
   // In complete mode, print the unused index 0
@@ -144,14 +267,19 @@ std::ostream& MinHeap<T>::print(std::ostream& os, bool complete) const {
     os << "x";
   }
 
-  // Print the elements in array_ seperated by commas
-  size_t startIndex = 1;
-  if (!complete && size_ > 0) {
-    os << *array_[1];
-    startIndex = 2;
-  }
-  for (size_t i = startIndex; i <= size_; ++i) {
-    os << "," << *array_[i];
+  // Print the elements in array_ seperated by commas.  Erased elements are
+  // skipped, or shown as "-" in complete mode.
+  bool first = !complete;
+  for (size_t i = 1; i <= size_; ++i) {
+    if (complete || !isErased(elementOf(array_[i]))) {
+      os << (first ? "" : ",");
+      first = false;
+    }
+    if (!isErased(elementOf(array_[i]))) {
+      os << *elementOf(array_[i]);
+    } else if (complete) {
+      os << "-";
+    }
   }
 
   // In complete mode, print the empty spaces at the end of array_
@@ -165,35 +293,28 @@ std::ostream& MinHeap<T>::print(std::ostream& os, bool complete) const {
   return os;
 }
 
-template <typename T>
-typename MinHeap<T>::const_reference MinHeap<T>::peakMin() const {
-  // By construction, the first element of array_ is always the smallest
-  return *array_[1];
+template <typename T, size_t INLINE_CAPACITY, typename Prefetch>
+constexpr typename MinHeap<T, INLINE_CAPACITY, Prefetch>::const_reference
+MinHeap<T, INLINE_CAPACITY, Prefetch>::peakMin() const {
+  // By construction, the first element of array_ is always the smallest, and
+  // we never leave an erased element there
+  return *elementOf(array_[1]);
 }
 
-template <typename T>
-bool MinHeap<T>::exists(const_reference val) const {
-  std::queue<size_t> q;
-  q.push(1);
-
-  // We perform a breadth first traversal of the heap and abandon any branch
-  // if its value is greater than val
-  while (!q.empty() && q.front() <= size_) {
-    size_t index = q.front();
-    q.pop();
-    if (*array_[index] == val) {
-      return true;
-    } else if (*array_[index] < val) {
-      q.push(2 * index);
-      q.push(2 * index + 1);
-    }
-  }
-
-  return false;
+template <typename T, size_t INLINE_CAPACITY, typename Prefetch>
+constexpr bool MinHeap<T, INLINE_CAPACITY, Prefetch>::exists(
+    const_reference val) const {
+  // The slot only reads val, so casting away const is safe
+  return findBelow(1, makeSlot(const_cast<T*>(&val))) != 0;
 }
 
-template <typename T>
-void MinHeap<T>::insert(const_reference val) {
+template <typename T, size_t INLINE_CAPACITY, typename Prefetch>
+constexpr void MinHeap<T, INLINE_CAPACITY, Prefetch>::insert(
+    const_reference val) {
+#ifdef MINHEAP_LATENCY_HISTOGRAM
+  MinHeapLatency::Timer timer(&MinHeapLatency::insert);
+#endif
+
   // If array_ is full, double its size
   if (size_ >= arraySize_ - 1) {
     resize(true);
@@ -201,58 +322,495 @@ void MinHeap<T>::insert(const_reference val) {
 
   // Insert val at the end of array_
   ++size_;
-  array_[size_] = new T(val);
+  array_[size_] = makeSlot(createElement(val));
 
   // Bubble up val while it is smaller than its parent
-  for (size_t index = size_; index > 1 && *array_[index] < *array_[index / 2];
-       index /= 2) {
+  for (size_t index = size_;
+       index > 1 && lessThan(array_[index], array_[index / 2]); index /= 2) {
     std::swap(array_[index], array_[index / 2]);
   }
 }
 
-template <typename T>
-void MinHeap<T>::deleteMin() {
-  // Delete the top element and move the last element to the top
-  delete array_[1];
-  array_[1] = array_[size_];
-  --size_;
+template <typename T, size_t INLINE_CAPACITY, typename Prefetch>
+constexpr void MinHeap<T, INLINE_CAPACITY, Prefetch>::deleteMin() {
+#ifdef MINHEAP_LATENCY_HISTOGRAM
+  MinHeapLatency::Timer timer(&MinHeapLatency::deleteMin);
+#endif
 
-  // Bubble down the top element by switching with its smaller child until it
-  // is smaller than both of its children
-  size_t index = 1;
-  while ((2 * index <= size_ && *array_[2 * index] < *array_[index]) ||
-         (2 * index + 1 <= size_ && *array_[2 * index + 1] < *array_[index])) {
-    size_t smallerChildIndex =
-        *array_[2 * index] < *array_[2 * index + 1] ? 2 * index : 2 * index + 1;
+  removeRoot();
+  discardErasedRoots();
+
+  // If array_ is 1/4 full or less, cut the size in half, but never make it
+  // smaller than inlineArray_
+  if (size_ > 0 && size_ <= arraySize_ / 4 && arraySize_ > INLINE_SLOTS) {
+    resize(false);
+  }
+}
+
+template <typename T, size_t INLINE_CAPACITY, typename Prefetch>
+bool MinHeap<T, INLINE_CAPACITY, Prefetch>::erase(const_reference val) {
+  size_t index = findBelow(1, makeSlot(const_cast<T*>(&val)));
+  if (index == 0) {
+    return false;
+  }
+
+  markErased(elementOf(array_[index]));
+  discardErasedRoots();
+  compactIfNeeded();
+  return true;
+}
+
+template <typename T, size_t INLINE_CAPACITY, typename Prefetch>
+template <typename Predicate>
+size_t MinHeap<T, INLINE_CAPACITY, Prefetch>::eraseIf(Predicate pred) {
+  // Unlike erase, a predicate gives us no way to prune the search, so we must
+  // visit every element
+  size_t count = 0;
+  for (size_t i = 1; i <= size_; ++i) {
+    T* element = elementOf(array_[i]);
+    if (!isErased(element) && pred(*element)) {
+      markErased(element);
+      ++count;
+    }
+  }
+
+  discardErasedRoots();
+  compactIfNeeded();
+  return count;
+}
+
+template <typename T, size_t INLINE_CAPACITY, typename Prefetch>
+void MinHeap<T, INLINE_CAPACITY, Prefetch>::compact() {
+  if (erased_ == nullptr) {
+    return;
+  }
+
+  // Destroy the erased elements and slide the remaining ones to the front of
+  // array_.  This breaks the heap order, so we heapify afterwards.
+  size_t kept = 0;
+  for (size_t i = 1; i <= size_; ++i) {
+    if (isErased(elementOf(array_[i]))) {
+      destroyElement(elementOf(array_[i]));
+    } else {
+      ++kept;
+      array_[kept] = array_[i];
+    }
+  }
+  size_ = kept;
+  delete erased_;
+  erased_ = nullptr;
+  heapify(1);
+
+  while (size_ <= arraySize_ / 4 && arraySize_ > INLINE_SLOTS) {
+    resize(false);
+  }
+}
+
+template <typename T, size_t INLINE_CAPACITY, typename Prefetch>
+constexpr void MinHeap<T, INLINE_CAPACITY, Prefetch>::bubbleDown(size_t index) {
+#ifdef MINHEAP_BRANCH_FREE_SIFT
+  if constexpr (CHEAP_COMPARISONS) {
+    bubbleDownBranchFree(index);
+    return;
+  }
+#endif
+
+  // Bubble down the element at index by switching with its smaller child until
+  // it is smaller than both of its children
+  while (2 * index <= size_) {
+    prefetchBelow(index);
+    size_t smallerChildIndex = 2 * index;
+    if (smallerChildIndex + 1 <= size_ &&
+        !lessThan(array_[smallerChildIndex], array_[smallerChildIndex + 1])) {
+      ++smallerChildIndex;
+    }
+    if (!lessThan(array_[smallerChildIndex], array_[index])) {
+      break;
+    }
     std::swap(array_[index], array_[smallerChildIndex]);
     index = smallerChildIndex;
   }
+}
 
-  // If array_ is 1/4 full or less, cut the size in half
-  if (size_ > 0 && size_ <= arraySize_ / 4) {
-    resize(false);
+template <typename T, size_t INLINE_CAPACITY, typename Prefetch>
+constexpr void MinHeap<T, INLINE_CAPACITY, Prefetch>::bubbleDownBranchFree(
+    size_t index) {
+  // With random elements, the left child is the smaller one half of the
+  // time, so the processor mispredicts "if (right < left)" half of the time.
+  // Adding the result of the comparison (0 or 1) to the index instead gives
+  // the compiler nothing to jump on.  The one remaining branch leaves the
+  // loop, which happens once per call.  The catch is that the next level's
+  // loads now wait for this level's comparison instead of being started on
+  // a guess, which is why this is not the default (see heap-bench
+  // branchfree).
+  //
+  // Rather than swapping at every level, we hold the moving element aside
+  // and write it once at the end.  The loop only visits parents with two
+  // children, so it never checks for a missing right child; the one parent
+  // which may have a single child is handled afterwards.  The element ends
+  // up exactly where bubbleDown would put it, including on ties.
+  Slot moving = array_[index];
+  while (2 * index + 1 <= size_) {
+    prefetchBelow(index);
+    size_t smallerChildIndex = 2 * index;
+    smallerChildIndex +=
+        !lessThan(array_[smallerChildIndex], array_[smallerChildIndex + 1]);
+    if (!lessThan(array_[smallerChildIndex], moving)) {
+      break;
+    }
+    array_[index] = array_[smallerChildIndex];
+    index = smallerChildIndex;
+  }
+  if (2 * index == size_ && lessThan(array_[size_], moving)) {
+    array_[index] = array_[size_];
+    index = size_;
   }
+  array_[index] = moving;
 }
 
-template <typename T>
-void MinHeap<T>::resize(bool upsize) {
-  T** oldArray = array_;
+template <typename T, size_t INLINE_CAPACITY, typename Prefetch>
+constexpr void MinHeap<T, INLINE_CAPACITY, Prefetch>::heapify(size_t threads) {
+  // Floyd's algorithm: bubble down every element that has children, from the
+  // last one up to the root.  When an element is bubbled down, both of its
+  // subtrees are already heaps, so the whole array_ is a heap at the end.
+  // This takes linear time, while inserting the elements one at a time takes
+  // O(nlog(n)) time.
+  size_t lastSerialIndex = size_ / 2;
+
+  // The subtrees rooted at the nodes of one level do not share any elements,
+  // so different threads can heapify them at the same time.  We choose a
+  // level with at least 4 subtrees per thread so that the work is balanced.
+  if (threads > 1 && !std::is_constant_evaluated()) {
+    size_t level = 1;
+    while (level < 4 * threads) {
+      level *= 2;
+    }
+    if (level <= size_ / 2) {
+      parallelFor(threads, [this, level, threads](size_t thread) {
+        for (size_t root = level + thread; root < 2 * level; root += threads) {
+          heapifySubtree(root);
+        }
+      });
+
+      // Only the levels above the subtrees are left for the serial loop
+      lastSerialIndex = level - 1;
+    }
+  }
+
+  for (size_t index = lastSerialIndex; index >= 1; --index) {
+    if (index > HEAPIFY_PREFETCH_DISTANCE) {
+      prefetchFamily(index - HEAPIFY_PREFETCH_DISTANCE);
+    }
+    bubbleDown(index);
+  }
+}
+
+template <typename T, size_t INLINE_CAPACITY, typename Prefetch>
+constexpr void MinHeap<T, INLINE_CAPACITY, Prefetch>::heapifySubtree(
+    size_t root) {
+  // The descendants of root which are k levels below it are the 2^k
+  // consecutive indices starting at root * 2^k.  We find the deepest of these
+  // levels which has children, and then work back up to root.
+  size_t levelStart = root;
+  size_t levelSize = 1;
+  while (2 * levelStart <= size_ / 2) {
+    levelStart *= 2;
+    levelSize *= 2;
+  }
+
+  while (levelStart >= root) {
+    size_t levelEnd = std::min(levelStart + levelSize - 1, size_ / 2);
+    for (size_t index = levelStart; index <= levelEnd; ++index) {
+      if (index + HEAPIFY_PREFETCH_DISTANCE <= levelEnd) {
+        prefetchFamily(index + HEAPIFY_PREFETCH_DISTANCE);
+      }
+      bubbleDown(index);
+    }
+    levelStart /= 2;
+    levelSize /= 2;
+  }
+}
+
+template <typename T, size_t INLINE_CAPACITY, typename Prefetch>
+constexpr void MinHeap<T, INLINE_CAPACITY, Prefetch>::prefetchBelow(
+    size_t index) const {
+  constexpr size_t LEVELS = Prefetch::LEVELS_AHEAD;
+  if constexpr (LEVELS > 0) {
+    if (std::is_constant_evaluated()) {
+      return;
+    }
+
+    // As in heapifySubtree, the descendants LEVELS levels below index are the
+    // 2^LEVELS indices starting at index * 2^LEVELS.  Their slots were
+    // prefetched when bubbleDown was at the parent of index, so reading the
+    // pointers in them should not stall.
+    size_t first = index << LEVELS;
+    size_t last = std::min(first + (size_t{1} << LEVELS) - 1, size_);
+    for (size_t i = first; i <= last; ++i) {
+      __builtin_prefetch(elementOf(array_[i]));
+    }
+
+    // The slots one level further down are consecutive, so we only need to
+    // prefetch each cache line they cover once.  first is rarely the first
+    // slot of its line, so we step over line addresses from the line holding
+    // array_[first] to the one holding array_[last].  Stepping over slot
+    // indices instead would skip the last line whenever the range ends
+    // partway into it.  A prefetch never faults, so the rounded-down address
+    // may safely lie before array_ (inlineArray_ is not aligned).
+    first *= 2;
+    last = std::min(first + (size_t{2} << LEVELS) - 1, size_);
+    if (first <= last) {
+      uintptr_t line = reinterpret_cast<uintptr_t>(array_ + first);
+      uintptr_t lastLine = reinterpret_cast<uintptr_t>(array_ + last);
+      line -= line % Slots::ALIGNMENT;
+      for (; line <= lastLine; line += Slots::ALIGNMENT) {
+        __builtin_prefetch(reinterpret_cast<const void*>(line));
+      }
+    }
+  }
+}
+
+template <typename T, size_t INLINE_CAPACITY, typename Prefetch>
+constexpr void MinHeap<T, INLINE_CAPACITY, Prefetch>::prefetchFamily(
+    size_t index) const {
+  if constexpr (Prefetch::LEVELS_AHEAD > 0) {
+    if (std::is_constant_evaluated()) {
+      return;
+    }
+
+    // heapify walks array_ in order, which the processor can predict on its
+    // own, but the elements the slots point to can be anywhere
+    __builtin_prefetch(elementOf(array_[index]));
+    __builtin_prefetch(elementOf(array_[2 * index]));
+    if (2 * index + 1 <= size_) {
+      __builtin_prefetch(elementOf(array_[2 * index + 1]));
+    }
+  }
+}
+
+template <typename T, size_t INLINE_CAPACITY, typename Prefetch>
+void MinHeap<T, INLINE_CAPACITY, Prefetch>::parallelFor(
+    size_t threads, const std::function<void(size_t)>& work) {
+  // The calling thread does part of the work itself rather than sitting idle
+  std::vector<std::thread> workers;
+  for (size_t thread = 1; thread < threads; ++thread) {
+    workers.emplace_back(work, thread);
+  }
+  work(0);
+  for (std::thread& worker : workers) {
+    worker.join();
+  }
+}
+
+template <typename T, size_t INLINE_CAPACITY, typename Prefetch>
+constexpr void MinHeap<T, INLINE_CAPACITY, Prefetch>::resize(bool upsize) {
+#ifdef MINHEAP_LATENCY_HISTOGRAM
+  MinHeapLatency::Timer timer(&MinHeapLatency::resize);
+#endif
+
+  Slot* oldArray = array_;
+  size_t oldArraySize = arraySize_;
 
-  // Create a new array_ with the updated size
   if (upsize) {
     arraySize_ *= 2;
   } else {
-    arraySize_ /= 2;
+    arraySize_ = std::max(arraySize_ / 2, INLINE_SLOTS);
   }
-  array_ = new T*[arraySize_];
 
-  // Copy over the pointers from oldArray to the new array_, without touching
-  // any of the elements themselves
+  // Copy over the pointers to the new array_, without touching any of the
+  // elements themselves.  Between two allocated arrays, Slots can often
+  // avoid copying altogether.
+  if (oldArray == inlineArray_) {
+    array_ = Slots::allocate(arraySize_);
+    std::copy(oldArray, oldArray + size_ + 1, array_);
+  } else if (arraySize_ == INLINE_SLOTS) {
+    array_ = inlineArray_;
+    std::copy(oldArray, oldArray + size_ + 1, array_);
+    Slots::deallocate(oldArray, oldArraySize);
+  } else {
+    array_ = Slots::reallocate(oldArray, oldArraySize, arraySize_, size_ + 1);
+  }
+}
+
+template <typename T, size_t INLINE_CAPACITY, typename Prefetch>
+constexpr size_t MinHeap<T, INLINE_CAPACITY, Prefetch>::findBelow(
+    size_t index, const Slot& val) const {
+  // We perform a depth first traversal of the heap and abandon any branch if
+  // its value is greater than val.  Unlike a breadth first traversal, this
+  // needs no queue, so it never allocates memory, and the recursion is only
+  // as deep as the heap, which is logarithmic in its size.
+  if (index > size_ || lessThan(val, array_[index])) {
+    return 0;
+  } else if (equalTo(array_[index], val) &&
+             !isErased(elementOf(array_[index]))) {
+    return index;
+  }
+  size_t found = findBelow(2 * index, val);
+  return found != 0 ? found : findBelow(2 * index + 1, val);
+}
+
+template <typename T, size_t INLINE_CAPACITY, typename Prefetch>
+constexpr void MinHeap<T, INLINE_CAPACITY, Prefetch>::removeRoot() {
+  // Delete the top element and move the last element to the top
+  destroyElement(elementOf(array_[1]));
+  array_[1] = array_[size_];
+  --size_;
+
+  bubbleDown(1);
+}
+
+template <typename T, size_t INLINE_CAPACITY, typename Prefetch>
+constexpr bool MinHeap<T, INLINE_CAPACITY, Prefetch>::isErased(
+    const T* element) const {
+  return erased_ != nullptr && erased_->count(element) > 0;
+}
+
+template <typename T, size_t INLINE_CAPACITY, typename Prefetch>
+void MinHeap<T, INLINE_CAPACITY, Prefetch>::markErased(const T* element) {
+  // Most MinHeaps never erase anything, so we only create erased_ once it is
+  // needed
+  if (erased_ == nullptr) {
+    erased_ = new std::unordered_set<const T*>();
+  }
+  erased_->insert(element);
+}
+
+template <typename T, size_t INLINE_CAPACITY, typename Prefetch>
+constexpr void MinHeap<T, INLINE_CAPACITY, Prefetch>::discardErasedRoots() {
+  // The address of a destroyed element may be reused by a new element, so we
+  // must forget it before destroying it
+  while (size_ > 0 && isErased(elementOf(array_[1]))) {
+    erased_->erase(elementOf(array_[1]));
+    removeRoot();
+  }
+}
+
+template <typename T, size_t INLINE_CAPACITY, typename Prefetch>
+void MinHeap<T, INLINE_CAPACITY, Prefetch>::compactIfNeeded() {
+  if (erased_ != nullptr && erased_->size() > size_ * MAX_ERASED_FRACTION) {
+    compact();
+  }
+}
+
+template <typename T, size_t INLINE_CAPACITY, typename Prefetch>
+constexpr void MinHeap<T, INLINE_CAPACITY, Prefetch>::compactBeforeIterating()
+    const {
+  // Compacting changes where elements sit in array_, but not which elements
+  // the MinHeap holds, so it does not change the MinHeap's value.  Casting
+  // away const is safe because a MinHeap which was created const has no
+  // erased elements: erase needs a non-const MinHeap, and copies leave
+  // erased elements out (see copyFrom).
+  if (erased_ != nullptr) {
+    const_cast<MinHeap*>(this)->compact();
+  }
+}
+
+template <typename T, size_t INLINE_CAPACITY, typename Prefetch>
+constexpr typename MinHeap<T, INLINE_CAPACITY, Prefetch>::Slot
+MinHeap<T, INLINE_CAPACITY, Prefetch>::makeSlot(T* element) {
+  if constexpr (MinHeapKeyPrefix<T>::ENABLED) {
+    return {element, MinHeapKeyPrefix<T>::of(*element)};
+  } else {
+    return element;
+  }
+}
+
+template <typename T, size_t INLINE_CAPACITY, typename Prefetch>
+constexpr T* MinHeap<T, INLINE_CAPACITY, Prefetch>::elementOf(
+    const Slot& slot) {
+  if constexpr (MinHeapKeyPrefix<T>::ENABLED) {
+    return slot.element;
+  } else {
+    return slot;
+  }
+}
+
+template <typename T, size_t INLINE_CAPACITY, typename Prefetch>
+constexpr bool MinHeap<T, INLINE_CAPACITY, Prefetch>::lessThan(
+    const Slot& lhs, const Slot& rhs) {
+  // Different prefixes settle the comparison without reading either element
+  if constexpr (MinHeapKeyPrefix<T>::ENABLED) {
+    if (lhs.prefix != rhs.prefix) {
+      return lhs.prefix < rhs.prefix;
+    }
+  }
+  return *elementOf(lhs) < *elementOf(rhs);
+}
+
+template <typename T, size_t INLINE_CAPACITY, typename Prefetch>
+constexpr bool MinHeap<T, INLINE_CAPACITY, Prefetch>::equalTo(
+    const Slot& lhs, const Slot& rhs) {
+  if constexpr (MinHeapKeyPrefix<T>::ENABLED) {
+    if (lhs.prefix != rhs.prefix) {
+      return false;
+    }
+  }
+  return *elementOf(lhs) == *elementOf(rhs);
+}
+
+template <typename T, size_t INLINE_CAPACITY, typename Prefetch>
+constexpr T* MinHeap<T, INLINE_CAPACITY, Prefetch>::createElement(
+    const_reference val) {
+  // pool_ constructs elements in raw memory, which is not allowed in a
+  // constant expression, so at compile time every element goes on the heap
+  if (std::is_constant_evaluated()) {
+    return new T(val);
+  }
+
+  // Use a free slot of pool_ if there is one, and only otherwise go to the
+  // heap
+  T* element = pool_.create(val);
+  return element != nullptr ? element : new T(val);
+}
+
+template <typename T, size_t INLINE_CAPACITY, typename Prefetch>
+constexpr void MinHeap<T, INLINE_CAPACITY, Prefetch>::destroyElement(
+    T* element) {
+  if (!std::is_constant_evaluated() && pool_.owns(element)) {
+    pool_.destroy(element);
+  } else {
+    delete element;
+  }
+}
+
+template <typename T, size_t INLINE_CAPACITY, typename Prefetch>
+constexpr void MinHeap<T, INLINE_CAPACITY, Prefetch>::clear() {
+  // We must manually delete each element and array_ itself
   for (size_t i = 1; i <= size_; ++i) {
-    array_[i] = oldArray[i];
+    destroyElement(elementOf(array_[i]));
   }
+  if (array_ != inlineArray_) {
+    Slots::deallocate(array_, arraySize_);
+  }
+  delete erased_;
+  erased_ = nullptr;
 
-  delete[] oldArray;
+  arraySize_ = INLINE_SLOTS;
+  size_ = 0;
+  array_ = inlineArray_;
+}
+
+template <typename T, size_t INLINE_CAPACITY, typename Prefetch>
+constexpr void MinHeap<T, INLINE_CAPACITY, Prefetch>::copyFrom(
+    const MinHeap& other) {
+  if (other.arraySize_ > INLINE_SLOTS) {
+    array_ = Slots::allocate(other.arraySize_);
+  }
+  arraySize_ = other.arraySize_;
+
+  // We must manually copy each element in order to make a deep copy.  Erased
+  // elements are left out, which leaves holes in the heap order, so if there
+  // were any we heapify afterwards.
+  size_ = 0;
+  for (size_t i = 1; i <= other.size_; ++i) {
+    if (!other.isErased(elementOf(other.array_[i]))) {
+      ++size_;
+      array_[size_] = makeSlot(createElement(*elementOf(other.array_[i])));
+    }
+  }
+  if (size_ < other.size_) {
+    heapify(1);
+  }
 }
 
 /*******************************************************************************
@@ -262,78 +820,260 @@ void MinHeap<T>::resize(bool upsize) {
 // Two default constructed Iterators must be equal, so we cannot used the
 // synthesized default constructor, which could give pointer_ any value.
 // Instead, we initialize pointer_ to the deterministic value nullptr (ie 0).
-template <typename T>
+template <typename T, size_t INLINE_CAPACITY, typename Prefetch>
 template <bool IS_CONST>
 // In some cases, the compiler does not realize that
 // "MinHeap<T>::Iterator<IS_CONST>" is a class name due to the double
 // templating, so we must add the template keyword as seen below
-MinHeap<T>::template Iterator<IS_CONST>::Iterator() : pointer_{nullptr} {}
+constexpr MinHeap<T, INLINE_CAPACITY, Prefetch>::template Iterator<
+    IS_CONST>::Iterator()
+    : pointer_{nullptr} {}
 
-template <typename T>
+template <typename T, size_t INLINE_CAPACITY, typename Prefetch>
 template <bool IS_CONST>
-MinHeap<T>::Iterator<IS_CONST>::Iterator(T** pointer) : pointer_{pointer} {}
+constexpr MinHeap<T, INLINE_CAPACITY, Prefetch>::Iterator<IS_CONST>::Iterator(
+    Slot* pointer)
+    : pointer_{pointer} {}
 
-template <typename T>
+template <typename T, size_t INLINE_CAPACITY, typename Prefetch>
 template <bool IS_CONST>
-MinHeap<T>::Iterator<IS_CONST>::Iterator(const Iterator<false>& other)
+constexpr MinHeap<T, INLINE_CAPACITY, Prefetch>::Iterator<IS_CONST>::Iterator(
+    const Iterator<false>& other)
     : pointer_{other.pointer_} {}
 
-template <typename T>
+template <typename T, size_t INLINE_CAPACITY, typename Prefetch>
 template <bool IS_CONST>
-bool MinHeap<T>::Iterator<IS_CONST>::operator==(const Iterator& rhs) const {
+constexpr bool
+MinHeap<T, INLINE_CAPACITY, Prefetch>::Iterator<IS_CONST>::operator==(
+    const Iterator& rhs) const {
   return pointer_ == rhs.pointer_;
 }
 
-template <typename T>
+template <typename T, size_t INLINE_CAPACITY, typename Prefetch>
 template <bool IS_CONST>
-bool MinHeap<T>::Iterator<IS_CONST>::operator!=(const Iterator& rhs) const {
+constexpr bool
+MinHeap<T, INLINE_CAPACITY, Prefetch>::Iterator<IS_CONST>::operator!=(
+    const Iterator& rhs) const {
   return !(*this == rhs);
 }
 
-template <typename T>
+template <typename T, size_t INLINE_CAPACITY, typename Prefetch>
 template <bool IS_CONST>
-typename MinHeap<T>::template Iterator<IS_CONST>::reference
-    MinHeap<T>::Iterator<IS_CONST>::operator*() const {
-  return **pointer_;
+constexpr typename MinHeap<T, INLINE_CAPACITY, Prefetch>::template Iterator<
+    IS_CONST>::reference
+MinHeap<T, INLINE_CAPACITY, Prefetch>::Iterator<IS_CONST>::operator*() const {
+  return *elementOf(*pointer_);
 }
 
-template <typename T>
+template <typename T, size_t INLINE_CAPACITY, typename Prefetch>
 template <bool IS_CONST>
-typename MinHeap<T>::template Iterator<IS_CONST>::pointer
-    MinHeap<T>::Iterator<IS_CONST>::operator->() const {
-  return *pointer_;
+constexpr typename MinHeap<T, INLINE_CAPACITY, Prefetch>::template Iterator<
+    IS_CONST>::pointer
+MinHeap<T, INLINE_CAPACITY, Prefetch>::Iterator<IS_CONST>::operator->() const {
+  return elementOf(*pointer_);
 }
 
-template <typename T>
+template <typename T, size_t INLINE_CAPACITY, typename Prefetch>
 template <bool IS_CONST>
-typename MinHeap<T>::template Iterator<IS_CONST>&
-MinHeap<T>::Iterator<IS_CONST>::operator++() {
+constexpr typename MinHeap<T, INLINE_CAPACITY,
+                           Prefetch>::template Iterator<IS_CONST>&
+MinHeap<T, INLINE_CAPACITY, Prefetch>::Iterator<IS_CONST>::operator++() {
   ++pointer_;
   return *this;
 }
 
-template <typename T>
+template <typename T, size_t INLINE_CAPACITY, typename Prefetch>
 template <bool IS_CONST>
-typename MinHeap<T>::template Iterator<IS_CONST>&
-MinHeap<T>::Iterator<IS_CONST>::operator--() {
+constexpr typename MinHeap<T, INLINE_CAPACITY,
+                           Prefetch>::template Iterator<IS_CONST>&
+MinHeap<T, INLINE_CAPACITY, Prefetch>::Iterator<IS_CONST>::operator--() {
   --pointer_;
   return *this;
 }
 
+template <typename T, size_t INLINE_CAPACITY, typename Prefetch>
+template <bool IS_CONST>
+constexpr typename MinHeap<T, INLINE_CAPACITY,
+                           Prefetch>::template Iterator<IS_CONST>
+MinHeap<T, INLINE_CAPACITY, Prefetch>::Iterator<IS_CONST>::operator++(int) {
+  // It is idiomatic to implement postfix ++ by leveraging prefix ++
+  Iterator copy = *this;
+  ++*this;
+  return copy;
+}
+
+template <typename T, size_t INLINE_CAPACITY, typename Prefetch>
+template <bool IS_CONST>
+constexpr typename MinHeap<T, INLINE_CAPACITY,
+                           Prefetch>::template Iterator<IS_CONST>
+MinHeap<T, INLINE_CAPACITY, Prefetch>::Iterator<IS_CONST>::operator--(int) {
+  Iterator copy = *this;
+  --*this;
+  return copy;
+}
+
+template <typename T, size_t INLINE_CAPACITY, typename Prefetch>
+template <bool IS_CONST>
+constexpr typename MinHeap<T, INLINE_CAPACITY,
+                           Prefetch>::template Iterator<IS_CONST>&
+MinHeap<T, INLINE_CAPACITY, Prefetch>::Iterator<IS_CONST>::operator+=(
+    difference_type n) {
+  // Because pointer_ points into a contiguous array, moving n elements is a
+  // single pointer addition rather than n calls to operator++
+  pointer_ += n;
+  return *this;
+}
+
+template <typename T, size_t INLINE_CAPACITY, typename Prefetch>
+template <bool IS_CONST>
+constexpr typename MinHeap<T, INLINE_CAPACITY,
+                           Prefetch>::template Iterator<IS_CONST>&
+MinHeap<T, INLINE_CAPACITY, Prefetch>::Iterator<IS_CONST>::operator-=(
+    difference_type n) {
+  pointer_ -= n;
+  return *this;
+}
+
+template <typename T, size_t INLINE_CAPACITY, typename Prefetch>
+template <bool IS_CONST>
+constexpr typename MinHeap<T, INLINE_CAPACITY,
+                           Prefetch>::template Iterator<IS_CONST>
+MinHeap<T, INLINE_CAPACITY, Prefetch>::Iterator<IS_CONST>::operator+(
+    difference_type n) const {
+  // It is idiomatic to implement operator+ by leveraging operator+=
+  Iterator copy = *this;
+  copy += n;
+  return copy;
+}
+
+template <typename T, size_t INLINE_CAPACITY, typename Prefetch>
+template <bool IS_CONST>
+constexpr typename MinHeap<T, INLINE_CAPACITY,
+                           Prefetch>::template Iterator<IS_CONST>
+MinHeap<T, INLINE_CAPACITY, Prefetch>::Iterator<IS_CONST>::operator-(
+    difference_type n) const {
+  Iterator copy = *this;
+  copy -= n;
+  return copy;
+}
+
+template <typename T, size_t INLINE_CAPACITY, typename Prefetch>
+template <bool IS_CONST>
+constexpr typename MinHeap<T, INLINE_CAPACITY, Prefetch>::template Iterator<
+    IS_CONST>::difference_type
+MinHeap<T, INLINE_CAPACITY, Prefetch>::Iterator<IS_CONST>::operator-(
+    const Iterator& rhs) const {
+  return pointer_ - rhs.pointer_;
+}
+
+template <typename T, size_t INLINE_CAPACITY, typename Prefetch>
+template <bool IS_CONST>
+constexpr typename MinHeap<T, INLINE_CAPACITY, Prefetch>::template Iterator<
+    IS_CONST>::reference
+MinHeap<T, INLINE_CAPACITY, Prefetch>::Iterator<IS_CONST>::operator[](
+    difference_type n) const {
+  return *elementOf(pointer_[n]);
+}
+
+template <typename T, size_t INLINE_CAPACITY, typename Prefetch>
+template <bool IS_CONST>
+constexpr bool
+MinHeap<T, INLINE_CAPACITY, Prefetch>::Iterator<IS_CONST>::operator<(
+    const Iterator& rhs) const {
+  return pointer_ < rhs.pointer_;
+}
+
+template <typename T, size_t INLINE_CAPACITY, typename Prefetch>
+template <bool IS_CONST>
+constexpr bool
+MinHeap<T, INLINE_CAPACITY, Prefetch>::Iterator<IS_CONST>::operator>(
+    const Iterator& rhs) const {
+  // It is idiomatic to implement the remaining comparisons by leveraging
+  // operator<
+  return rhs < *this;
+}
+
+template <typename T, size_t INLINE_CAPACITY, typename Prefetch>
+template <bool IS_CONST>
+constexpr bool
+MinHeap<T, INLINE_CAPACITY, Prefetch>::Iterator<IS_CONST>::operator<=(
+    const Iterator& rhs) const {
+  return !(rhs < *this);
+}
+
+template <typename T, size_t INLINE_CAPACITY, typename Prefetch>
+template <bool IS_CONST>
+constexpr bool
+MinHeap<T, INLINE_CAPACITY, Prefetch>::Iterator<IS_CONST>::operator>=(
+    const Iterator& rhs) const {
+  return !(*this < rhs);
+}
+
 /*******************************************************************************
  * Overloading global functions
  ******************************************************************************/
 
 // We overload the global operator<< to call MinHeap::print, which allows us to
 // write things such as "std::cout << heap << std::endl;"
-template <typename T>
-std::ostream& operator<<(std::ostream& os, const MinHeap<T>& heap) {
+template <typename T, size_t INLINE_CAPACITY, typename Prefetch>
+std::ostream& operator<<(std::ostream& os,
+                         const MinHeap<T, INLINE_CAPACITY, Prefetch>& heap) {
   return heap.print(os);
 }
 
 // We overload the global swap function to call the MinHeap::swap, which allows
 // us to write "swap(h1, h2)" rather than just "h1.swap(h2)"
-template <typename T>
-void swap(MinHeap<T>& first, MinHeap<T>& second) {
+template <typename T, size_t INLINE_CAPACITY, typename Prefetch>
+constexpr void swap(MinHeap<T, INLINE_CAPACITY, Prefetch>& first,
+                    MinHeap<T, INLINE_CAPACITY, Prefetch>& second) {
   first.swap(second);
 }
+
+#ifdef MINHEAP_LATENCY_HISTOGRAM
+/*******************************************************************************
+ * MinHeapLatency implementation
+ ******************************************************************************/
+
+// MinHeapLatency is not a template, so its methods are marked inline, which
+// lets every file which includes minheap.hpp share one definition of each
+
+inline MinHeapLatency& MinHeapLatency::global() {
+  static MinHeapLatency latency;
+  return latency;
+}
+
+inline std::ostream& MinHeapLatency::writeText(std::ostream& os) const {
+  os << "insert\n";
+  insert.writeText(os);
+  os << "deleteMin\n";
+  deleteMin.writeText(os);
+  os << "resize\n";
+  return resize.writeText(os);
+}
+
+inline std::ostream& MinHeapLatency::writeJson(std::ostream& os) const {
+  os << "{\"insert\": ";
+  insert.writeJson(os);
+  os << ", \"deleteMin\": ";
+  deleteMin.writeJson(os);
+  os << ", \"resize\": ";
+  resize.writeJson(os);
+  return os << "}";
+}
+
+constexpr MinHeapLatency::Timer::Timer(
+    LatencyHistogram<> MinHeapLatency::*histogram)
+    : histogram_{histogram}, start_{} {
+  if (!std::is_constant_evaluated()) {
+    start_ = std::chrono::steady_clock::now();
+  }
+}
+
+constexpr MinHeapLatency::Timer::~Timer() {
+  if (!std::is_constant_evaluated()) {
+    std::chrono::nanoseconds elapsed =
+        std::chrono::steady_clock::now() - start_;
+    (global().*histogram_).record(elapsed.count());
+  }
+}
+#endif
@@ -9,18 +9,206 @@
 #define TEMPLATES_MINHEAP_HPP_
 
 #include <cstddef>
+#include <cstdint>
+#include <functional>
 #include <iterator>
 #include <ostream>
+#include <string>
 #include <type_traits>
+#include <unordered_set>
 #include <utility>
 
+#include "inlinepool.hpp"
+#include "slotallocator.hpp"
+
+#ifdef MINHEAP_LATENCY_HISTOGRAM
+#include <chrono>
+
+#include "latencyhistogram.hpp"
+#endif
+
+/**
+ * \struct NoPrefetch
+ * \brief The default prefetch policy for MinHeap, which leaves every memory
+ * access to the hardware
+ */
+struct NoPrefetch {
+  /** \brief How many levels ahead bubbleDown fetches elements, or 0 */
+  static constexpr size_t LEVELS_AHEAD = 0;
+};
+
+/**
+ * \struct PrefetchAhead
+ * \brief A prefetch policy for MinHeap, which asks the processor to start
+ * loading memory that bubbleDown will need a few levels from now
+ * \details bubbleDown compares the two children of its current index, and
+ * each comparison follows a pointer from array_ to an element.  Once the heap
+ * is larger than the cache, each of those loads is a cache miss, and the
+ * processor cannot start the next level's loads until it knows which child
+ * won.  With this policy, bubbleDown starts loading the elements LEVELS
+ * levels below the current index, and the slots of array_ one level below
+ * those, so that they have arrived by the time it gets there.  This costs
+ * 2^LEVELS prefetches per level, most of which are for subtrees that
+ * bubbleDown never enters, so a larger LEVELS hides more latency but wastes
+ * more memory bandwidth.  "./heap-bench prefetch" compares the choices.
+ * \note LEVELS must be at least 2, since the children of the current index
+ * are compared straight away
+ */
+template <size_t LEVELS = 2>
+struct PrefetchAhead {
+  static_assert(LEVELS >= 2, "The children are needed straight away");
+
+  /** \brief How many levels ahead bubbleDown fetches elements, or 0 */
+  static constexpr size_t LEVELS_AHEAD = LEVELS;
+};
+
+/**
+ * \struct MinHeapKeyPrefix
+ * \brief Says whether MinHeap keeps a prefix of each element's key next to
+ * its pointer in array_, and how to compute it
+ * \details Comparing two elements normally follows two pointers from array_,
+ * and for a type such as std::string, two more to the characters.  If each
+ * slot of array_ also holds a number which orders the elements the same way
+ * whenever the numbers differ, most comparisons never leave array_, and only
+ * ties compare the elements themselves.
+ *
+ * This primary template turns the prefix off, so array_ holds bare pointers.
+ * A specialization turns it on by providing
+ *     static constexpr bool ENABLED = true;
+ *     static constexpr uint64_t of(const T& key);
+ * where of(a) < of(b) must imply a < b.  Equal prefixes say nothing, so of
+ * may map many keys to one prefix.
+ */
+template <typename T>
+struct MinHeapKeyPrefix {
+  /** \brief Whether array_ holds a prefix next to each pointer */
+  static constexpr bool ENABLED = false;
+};
+
+/**
+ * \struct MinHeapKeyPrefix<std::string>
+ * \brief Caches the first 8 bytes of each std::string in array_
+ * \details std::string compares its characters as unsigned bytes, from the
+ * first one on, so packing the first 8 of them into a big-endian integer
+ * (padded with zeros) orders strings which differ within those 8 bytes
+ * correctly.  Strings which share their first 8 bytes, such as URLs from
+ * one site, always tie and gain nothing.
+ */
+template <>
+struct MinHeapKeyPrefix<std::string> {
+  /** \brief Whether array_ holds a prefix next to each pointer */
+  static constexpr bool ENABLED = true;
+
+  /**
+   * \brief Computes the prefix of a string
+   * \param key   The string
+   * \return Its first 8 bytes as a big-endian integer
+   * \note Run time: constant
+   */
+  static constexpr uint64_t of(const std::string& key);
+};
+
+#ifdef MINHEAP_LATENCY_HISTOGRAM
+/**
+ * \struct MinHeapLatency
+ * \brief How long the insert, deleteMin, and resize operations of every
+ * MinHeap in the program have taken
+ * \details Only exists if MINHEAP_LATENCY_HISTOGRAM is defined.  Otherwise
+ * MinHeap does not time anything, and none of this is compiled at all.
+ *
+ * An insert or deleteMin which resizes the heap is also counted by resize,
+ * so a slow tail in insert or deleteMin which matches resize is the cost of
+ * copying array_.
+ */
+struct MinHeapLatency {
+  LatencyHistogram<> insert;
+  LatencyHistogram<> deleteMin;
+  LatencyHistogram<> resize;
+
+  /**
+   * \brief Returns the histograms which every MinHeap records into
+   * \return The histograms
+   */
+  static MinHeapLatency& global();
+
+  /**
+   * \brief Writes each histogram as lines of text
+   * \param os  The ostream to which to write
+   * \return The ostream which was passed in
+   */
+  std::ostream& writeText(std::ostream& os) const;
+
+  /**
+   * \brief Writes the histograms as a JSON object with one member each
+   * \param os  The ostream to which to write
+   * \return The ostream which was passed in
+   */
+  std::ostream& writeJson(std::ostream& os) const;
+
+  /**
+   * \class Timer
+   * \brief Records the time from its creation to its destruction into one
+   * of the global histograms
+   * \note Does nothing during constant evaluation, where there is no clock
+   */
+  class Timer {
+   public:
+    /**
+     * \brief Starts timing an operation
+     * \param histogram   The global histogram to record into
+     */
+    constexpr explicit Timer(LatencyHistogram<> MinHeapLatency::*histogram);
+
+    /**
+     * \brief Records the time since the Timer was created
+     */
+    constexpr ~Timer();
+
+   private:
+    LatencyHistogram<> MinHeapLatency::*histogram_;
+    std::chrono::steady_clock::time_point start_;
+  };
+};
+#endif
+
 /**
  * \class MinHeap
  * \brief A templated binary min heap implemented as an extendable array
+ * \details The first INLINE_CAPACITY elements, and the array of pointers to
+ * them, are stored inside the MinHeap object itself.  A MinHeap which never
+ * grows past INLINE_CAPACITY elements therefore never allocates memory, and
+ * only spills onto the heap once it is exceeded.  The default of 0 stores
+ * every element on the heap.
+ *
+ * Every method except print, erase, eraseIf, and compact is constexpr, so a
+ * MinHeap can be created, used, and destroyed inside a constant expression
+ * (for example, to compute a sorted table at compile time).  C++20 allows
+ * memory to be allocated during constant evaluation as long as it is freed
+ * before the evaluation ends, so the MinHeap itself cannot outlive the
+ * constant expression; copy the results into a std::array instead.  The
+ * erasing methods are the exception because they keep their tombstones in a
+ * std::unordered_set, which cannot be used in a constant expression.
+ *
+ * The Prefetch policy (NoPrefetch or PrefetchAhead) controls whether
+ * bubbleDown and heapify prefetch memory, which only pays off for heaps
+ * which are larger than the cache.
+ *
+ * Defining MINHEAP_LATENCY_HISTOGRAM before including this file makes
+ * insert, deleteMin, and resize record how long they take (see
+ * MinHeapLatency).
+ *
+ * For types with a MinHeapKeyPrefix, such as std::string, each slot of
+ * array_ also holds a prefix of the element's key, which settles most
+ * comparisons without reading the element.
+ *
+ * Defining MINHEAP_BRANCH_FREE_SIFT makes bubbleDown pick the smaller child
+ * without a branch when comparing two slots is cheap (see
+ * CHEAP_COMPARISONS and bubbleDownBranchFree).
  * \note The template type T must support the copy constructor, operator<, and
  * operator==
  */
-template <typename T>
+template <typename T, size_t INLINE_CAPACITY = 0,
+          typename Prefetch = NoPrefetch>
 class MinHeap {
  private:
   template <bool IS_CONST>
@@ -40,34 +228,51 @@ class MinHeap {
    * \brief Creates an empty MinHeap
    * \note Run time: constant
    */
-  MinHeap();
+  constexpr MinHeap();
+
+  /**
+   * \brief Creates a MinHeap containing copies of the elements in a range
+   * \param first     An iterator to the first element to copy
+   * \param last      An iterator to the past-the-end element to copy
+   * \param threads   The number of threads to use (including this one)
+   * \note Run time: linear in the size of the range, divided by threads
+   * \note The result is a valid heap for any number of threads, although the
+   * exact order of array_ depends on the number of threads.  Copying the
+   * elements uses every thread only if Iter is a random-access iterator.
+   * \note Iter must be at least a forward iterator, since the range is
+   * counted before it is copied.  Copy a single-pass range such as an
+   * std::istream_iterator into a container first.
+   */
+  template <typename Iter>
+  constexpr MinHeap(Iter first, Iter last, size_t threads = 1);
 
   /**
    * \brief Creates a MinHeap containing a deep copy of the contents of other
    * \param other   The MinHeap to be copied
    * \note Run time: linear in the size of other
    */
-  MinHeap(const MinHeap& other);
+  constexpr MinHeap(const MinHeap& other);
 
   /**
    * \brief Replaces current contents with a deep copy of the contents of other
    * \param other   The MinHeap to be copied
    * \note Run time: linear in the size of other
    */
-  MinHeap& operator=(const MinHeap& other);
+  constexpr MinHeap& operator=(const MinHeap& other);
 
   /**
    * \brief Frees all memory associated with the MinHeap
    * \note Run time: linear in the size of the MinHeap
    */
-  ~MinHeap();
+  constexpr ~MinHeap();
 
   /**
    * \brief Exchanges the contents of the MinHeap with other
    * \param other   The MinHeap with which to exchange contents
-   * \note Run time: constant
+   * \note Run time: constant if INLINE_CAPACITY is 0, otherwise linear in the
+   * size of both MinHeaps
    */
-  void swap(MinHeap& other);
+  constexpr void swap(MinHeap& other);
 
   /**
    * \brief Compares if two MinHeaps contain the same elements
@@ -75,7 +280,7 @@ class MinHeap {
    * \return True if this MinHeap and rhs contain the exact same elements
    * \note Run time: O(nlog(n)), where n is the size of the MinHeap
    */
-  bool operator==(const MinHeap& rhs) const;
+  constexpr bool operator==(const MinHeap& rhs) const;
 
   /**
    * \brief Compares if two MinHeaps contain the same elements
@@ -83,7 +288,7 @@ class MinHeap {
    * \return False if this MinHeap and rhs contain the exact same elements
    * \note Run time: worst-case quadratic in the number of elements
    */
-  bool operator!=(const MinHeap& rhs) const;
+  constexpr bool operator!=(const MinHeap& rhs) const;
 
   /**
    * \brief Creates an iterator to the first element of the MinHeap
@@ -93,7 +298,7 @@ class MinHeap {
    * behavior (in practice, MinHeap should only support a const_iterator, but
    * we have implemented an iterator as an example for other data structures)
    */
-  iterator begin();
+  constexpr iterator begin();
 
   /**
    * \brief Creates an iterator to the past-the-end element of the MinHeap
@@ -103,49 +308,49 @@ class MinHeap {
    * behavior (in practice, MinHeap should only support a const_iterator, but
    * we have implemented an iterator as an example for other data structures)
    */
-  iterator end();
+  constexpr iterator end();
 
   /**
    * \brief Creates a const_iterator to the first element of the MinHeap
    * \return A const_iterator pointing to the first element of the MinHeap
    * \note Run time: constant
    */
-  const_iterator begin() const;
+  constexpr const_iterator begin() const;
 
   /**
    * \brief Creates a const_iterator to the past-the-end element of the MinHeap
    * \return A const_iterator to the past-the-end element of the MinHeap
    * \note Run time: constant
    */
-  const_iterator end() const;
+  constexpr const_iterator end() const;
 
   /**
    * \brief Creates a const_iterator to the first element of the MinHeap
    * \return A const_iterator pointing to the first element of the MinHeap
    * \note Run time: constant
    */
-  const_iterator cbegin() const;
+  constexpr const_iterator cbegin() const;
 
   /**
    * \brief Creates a const_iterator to the past-the-end element of the MinHeap
    * \return A const_iterator to the past-the-end element of the MinHeap
    * \note Run time: constant
    */
-  const_iterator cend() const;
+  constexpr const_iterator cend() const;
 
   /**
    * \brief Returns the number of elements in the MinHeap
    * \return The number of elements in the MinHeap
    * \note Run time: constant
    */
-  size_type size() const;
+  constexpr size_type size() const;
 
   /**
    * \brief Returns whether the MinHeap is empty
    * \return True if the size of the MinHeap is 0
    * \note Run time: constant
    */
-  bool empty() const;
+  constexpr bool empty() const;
 
   /**
    * \brief Prints the elements of the MinHeap to an ostream
@@ -162,7 +367,7 @@ class MinHeap {
    * \note Run time: constant
    * \warning Behavior is undefined if the MinHeap is empty
    */
-  const_reference peakMin() const;
+  constexpr const_reference peakMin() const;
 
   /**
    * \brief Determines whether a value is contained in the MinHeap
@@ -170,7 +375,7 @@ class MinHeap {
    * \return True if val is contained in the MinHeap
    * \note Run time: worst-case linear in the size of the MinHeap
    */
-  bool exists(const_reference val) const;
+  constexpr bool exists(const_reference val) const;
 
   /**
    * \brief Adds a new value to the MinHeap
@@ -178,7 +383,7 @@ class MinHeap {
    * \note Run time: amortized logarithmic in the size of the MinHeap
    * \warning Invalidates all iterators pointing to this MinHeap
    */
-  void insert(const_reference val);
+  constexpr void insert(const_reference val);
 
   /**
    * \brief Removes the smallest value from the MinHeap
@@ -186,31 +391,302 @@ class MinHeap {
    * \warning Invalidates all iterators pointing to this MinHeap
    * \warning Behavior is undefined if the MinHeap is empty
    */
-  void deleteMin();
+  constexpr void deleteMin();
+
+  /**
+   * \brief Removes one copy of a value from the MinHeap, if it is present
+   * \param val   The value to remove
+   * \return True if val was found and removed
+   * \note Run time: worst-case linear in the size of the MinHeap to find val
+   * (the same search as exists); marking it erased is amortized constant
+   * \warning Invalidates all iterators pointing to this MinHeap
+   */
+  bool erase(const_reference val);
+
+  /**
+   * \brief Removes every value for which a predicate returns true
+   * \param pred   A function which takes a const_reference and returns a bool
+   * \return The number of values removed
+   * \note Run time: linear in the size of the MinHeap
+   * \warning Invalidates all iterators pointing to this MinHeap
+   */
+  template <typename Predicate>
+  size_t eraseIf(Predicate pred);
+
+  /**
+   * \brief Frees the erased elements which are still stored in the MinHeap
+   * \details erase and eraseIf only mark elements as erased, which is much
+   * faster than rebuilding the heap.  Erased elements are skipped by peakMin,
+   * deleteMin, exists, print, and size, and are freed once they reach the top
+   * of the heap or once they make up more than MAX_ERASED_FRACTION of array_.
+   * begin, end, cbegin, and cend call compact first, so iterators never
+   * visit them and end() - begin() is always size().  Copies of the MinHeap
+   * leave them out as well.
+   * \note Run time: linear in the size of the MinHeap
+   * \warning Invalidates all iterators pointing to this MinHeap
+   */
+  void compact();
 
  private:
   /** \brief The size of array_ */
   size_t arraySize_;
 
-  /** \brief The number of elements in the MinHeap */
+  /** \brief The number of elements in array_, including erased elements */
   size_t size_;
 
-  /** \brief A 1-indexed array of pointers to the elements of the MinHeap */
-  T** array_;
+  /**
+   * \struct PrefixedSlot
+   * \brief A slot of array_ which holds a pointer to an element and the
+   * prefix of its key
+   */
+  struct PrefixedSlot {
+    T* element;
+    uint64_t prefix;
+  };
+
+  /**
+   * \brief What each slot of array_ holds: a bare pointer to an element, or
+   * a PrefixedSlot if MinHeapKeyPrefix<T> is enabled.  Swapping slots moves
+   * the prefix with the pointer, so only creating a slot computes it.
+   */
+  using Slot = std::conditional_t<MinHeapKeyPrefix<T>::ENABLED, PrefixedSlot,
+                                  T*>;
+
+  /** \brief A 1-indexed array of slots for the elements of the MinHeap */
+  Slot* array_;
+
+  /** \brief Allocates array_ whenever it is not inlineArray_ */
+  using Slots = SlotAllocator<Slot>;
+
+  /** \brief The size of inlineArray_, which is also the smallest arraySize_ */
+  static constexpr size_t INLINE_SLOTS =
+      INLINE_CAPACITY + 1 > 2 ? INLINE_CAPACITY + 1 : 2;
+
+  /** \brief The storage used for array_ while it has INLINE_SLOTS slots */
+  Slot inlineArray_[INLINE_SLOTS] = {};
+
+  /** \brief The storage used for the first INLINE_CAPACITY elements */
+  InlinePool<T, INLINE_CAPACITY> pool_;
+
+  /**
+   * \brief The addresses of the elements which have been erased, or nullptr
+   * if no elements are erased
+   * \details Swapping elements in array_ only moves pointers, so an element's
+   * address never changes while it is in the MinHeap.  This lets us mark it
+   * erased without touching array_ at all.
+   */
+  std::unordered_set<const T*>* erased_ = nullptr;
+
+  /**
+   * \brief Creates the slot for an element
+   * \param element   A pointer to the element
+   * \return The slot, with the prefix of *element if there is one
+   * \note Run time: constant
+   */
+  static constexpr Slot makeSlot(T* element);
+
+  /**
+   * \brief Returns the element a slot points to
+   * \param slot  The slot
+   * \return A pointer to the element
+   * \note Run time: constant
+   */
+  static constexpr T* elementOf(const Slot& slot);
+
+  /**
+   * \brief Compares the elements of two slots, using their prefixes first
+   * \param lhs   The slot on the left of the <
+   * \param rhs   The slot on the right of the <
+   * \return True if the element of lhs is smaller than the element of rhs
+   * \note Run time: constant, unless the prefixes tie
+   */
+  static constexpr bool lessThan(const Slot& lhs, const Slot& rhs);
+
+  /**
+   * \brief Compares the elements of two slots for equality
+   * \param lhs   One slot
+   * \param rhs   The other slot
+   * \return True if the elements of lhs and rhs are equal
+   * \note Run time: constant, unless the prefixes tie
+   */
+  static constexpr bool equalTo(const Slot& lhs, const Slot& rhs);
+
+  /**
+   * \brief Whether comparing two slots is cheap enough for
+   * bubbleDownBranchFree to pay off
+   * \details bubbleDownBranchFree only ever moves slots, so what matters is
+   * the comparison it must wait for.  Numbers and pointers compare in one
+   * instruction, and slots with a MinHeapKeyPrefix usually settle on their
+   * prefixes.  Any other T may follow pointers or loop to compare, which
+   * costs far more than a mispredicted branch.
+   */
+  static constexpr bool CHEAP_COMPARISONS =
+      std::is_arithmetic_v<T> || std::is_pointer_v<T> ||
+      MinHeapKeyPrefix<T>::ENABLED;
+
+  /** \brief The fraction of array_ which may be erased before we compact it */
+  static constexpr double MAX_ERASED_FRACTION = 0.25;
 
   /**
    * \brief Either double or halve the size of array_
    * \param upsize  If true, double array_, if false, halve array_
    * \note Run time: linear in the size of the MinHeap
    */
-  void resize(bool upsize);
+  constexpr void resize(bool upsize);
+
+  /**
+   * \brief Moves the element at index down until it is no larger than either
+   * of its children
+   * \param index   The index of the element to move
+   * \note Run time: logarithmic in the size of the MinHeap
+   */
+  constexpr void bubbleDown(size_t index);
+
+  /**
+   * \brief The version of bubbleDown for CHEAP_COMPARISONS, which picks the
+   * smaller child with arithmetic instead of a branch
+   * \details Only used if MINHEAP_BRANCH_FREE_SIFT is defined.  It moves the
+   * slots exactly as bubbleDown does.
+   * \param index   The index of the element to move
+   * \note Run time: logarithmic in the size of the MinHeap
+   */
+  constexpr void bubbleDownBranchFree(size_t index);
+
+  /**
+   * \brief Prefetches the memory bubbleDown will need in the levels below
+   * index, as chosen by the Prefetch policy
+   * \param index   The index which bubbleDown has reached
+   * \note Run time: constant
+   */
+  constexpr void prefetchBelow(size_t index) const;
+
+  /**
+   * \brief Prefetches the element at index and its children, which heapify
+   * is about to compare, as chosen by the Prefetch policy
+   * \param index   An index which heapify will reach soon
+   * \note Run time: constant
+   */
+  constexpr void prefetchFamily(size_t index) const;
+
+  /** \brief How many indices ahead of its loops heapify prefetches */
+  static constexpr size_t HEAPIFY_PREFETCH_DISTANCE = 16;
+
+  /**
+   * \brief Rearranges all of array_ into a valid heap
+   * \param threads   The number of threads to use (including this one)
+   * \note Run time: linear in the size of the MinHeap, divided by threads
+   */
+  constexpr void heapify(size_t threads);
+
+  /**
+   * \brief Rearranges the subtree rooted at root into a valid heap
+   * \param root   The index of the root of the subtree
+   * \note Run time: linear in the size of the subtree
+   */
+  constexpr void heapifySubtree(size_t root);
+
+  /**
+   * \brief Calls work(0) through work(threads - 1), each on its own thread
+   * \param threads   The number of threads to use (including this one)
+   * \param work      The function to call with each thread's number
+   * \note Returns once every call has finished
+   */
+  static void parallelFor(size_t threads,
+                          const std::function<void(size_t)>& work);
+
+  /**
+   * \brief Finds an element equal to val in the subtree rooted at index
+   * \param index   The index of the root of the subtree to search
+   * \param val     A slot for the value for which to search, so that its
+   * prefix is computed only once
+   * \return The index of an element equal to val which is not erased, or 0 if
+   * there is no such element in the subtree
+   * \note Run time: worst-case linear in the size of the subtree
+   */
+  constexpr size_t findBelow(size_t index, const Slot& val) const;
+
+  /**
+   * \brief Destroys the top element and restores the heap order
+   * \note Run time: logarithmic in the size of the MinHeap
+   */
+  constexpr void removeRoot();
+
+  /**
+   * \brief Determines whether an element has been erased
+   * \param element   A pointer to the element
+   * \return True if element has been erased
+   * \note Run time: amortized constant
+   */
+  constexpr bool isErased(const T* element) const;
+
+  /**
+   * \brief Marks an element as erased
+   * \param element   A pointer to the element
+   * \note Run time: amortized constant
+   */
+  void markErased(const T* element);
+
+  /**
+   * \brief Removes erased elements from the top of the heap until the top
+   * element is not erased
+   * \note Run time: logarithmic in the size of the MinHeap per element removed
+   */
+  constexpr void discardErasedRoots();
+
+  /**
+   * \brief Calls compact if more than MAX_ERASED_FRACTION of array_ is erased
+   * \note Run time: amortized constant per erased element
+   */
+  void compactIfNeeded();
+
+  /**
+   * \brief Calls compact if any element is erased, even on a const MinHeap,
+   * so that iterators only visit the elements which are still in it
+   * \note Run time: constant if no element is erased, and otherwise linear
+   * in the size of the MinHeap
+   * \warning Not safe to call from several threads at once if an element is
+   * erased, so iterate over a shared MinHeap only after compacting it
+   */
+  constexpr void compactBeforeIterating() const;
+
+  /**
+   * \brief Creates a copy of val in pool_, or on the heap if pool_ is full
+   * \param val   The value to copy
+   * \return A pointer to the new element
+   * \note Run time: constant
+   */
+  constexpr T* createElement(const_reference val);
+
+  /**
+   * \brief Destroys an element created by createElement
+   * \param element   A pointer to the element to destroy
+   * \note Run time: constant
+   */
+  constexpr void destroyElement(T* element);
+
+  /**
+   * \brief Destroys every element and returns array_ to inlineArray_
+   * \note Run time: linear in the size of the MinHeap
+   */
+  constexpr void clear();
+
+  /**
+   * \brief Copies the elements of other, leaving out erased ones, into this
+   * empty MinHeap
+   * \param other   The MinHeap to be copied
+   * \note Run time: linear in the size of other
+   */
+  constexpr void copyFrom(const MinHeap& other);
 
   /**
    * \class Iterator
-   * \brief A bidirectional iterator pointing to an element of a MinHeap
+   * \brief A random-access iterator pointing to an element of a MinHeap
    * \details This iterator will perform a breadth-first traversal of the
    * MinHeap, which will not necessarily visit the elements from smallest
-   * to largest.
+   * to largest.  Since the iterator is a cursor into the contiguous array_,
+   * it can jump any distance in constant time, so algorithms such as
+   * std::distance, std::advance, and the parallel std::reduce take their
+   * fast random-access paths.
    *
    * \note Iterator is templated on the bool IS_CONST, allowing it to implement
    * both iterator and const_iterator.  This is used as an example for the
@@ -223,7 +699,7 @@ class MinHeap {
    public:
     // STL iterator type definitions
     using difference_type = ptrdiff_t;
-    using iterator_category = std::bidirectional_iterator_tag;
+    using iterator_category = std::random_access_iterator_tag;
     using value_type = T;
     using const_reference = const value_type&;
 
@@ -242,14 +718,14 @@ class MinHeap {
      * \note Run time: constant
      * \warning It is undefined behavior to dereference, ++, or -- this iterator
      */
-    Iterator();
+    constexpr Iterator();
 
     /**
      * \brief Creates an Iterator pointing to the same element as other
      * \param other   The Iterator to be copied
      * \note Run time: constant
      */
-    Iterator(const Iterator<false>& other);
+    constexpr Iterator(const Iterator<false>& other);
 
     /**
      * \brief Frees all memory associated with the Iterator
@@ -263,7 +739,7 @@ class MinHeap {
      * \return True if this Iterator and rhs point to the same element
      * \note Run time: constant
      */
-    bool operator==(const Iterator& rhs) const;
+    constexpr bool operator==(const Iterator& rhs) const;
 
     /**
      * \brief Compares if two Iterators are pointing to the same element
@@ -271,51 +747,156 @@ class MinHeap {
      * \return False if this Iterator and rhs point to the same element
      * \note Run time: constant
      */
-    bool operator!=(const Iterator& rhs) const;
+    constexpr bool operator!=(const Iterator& rhs) const;
 
     /**
      * \brief Returns a reference to the element to which the Iterator points
      * \return A reference to the element to which the Iterator points
      * \note Run time: constant
      */
-    reference operator*() const;
+    constexpr reference operator*() const;
 
     /**
      * \brief Returns a reference to the element to which the Iterator points
      * \return A reference to the element to which the Iterator points
      * \note Run time: constant
      */
-    pointer operator->() const;
+    constexpr pointer operator->() const;
 
     /**
      * \brief Moves the Iterator to the next element in the MinHeap
      * \return A reference to the Iterator after it was moved
      * \note Run time: constant
      */
-    Iterator& operator++();
+    constexpr Iterator& operator++();
 
     /**
      * \brief Moves the Iterator to the previous element in the MinHeap
      * \return A reference to the Iterator after it was moved
      * \note Run time: constant
      */
-    Iterator& operator--();
+    constexpr Iterator& operator--();
+
+    /**
+     * \brief Moves the Iterator to the next element in the MinHeap
+     * \return A copy of the Iterator before it was moved
+     * \note Run time: constant
+     */
+    constexpr Iterator operator++(int);
+
+    /**
+     * \brief Moves the Iterator to the previous element in the MinHeap
+     * \return A copy of the Iterator before it was moved
+     * \note Run time: constant
+     */
+    constexpr Iterator operator--(int);
+
+    /**
+     * \brief Moves the Iterator n elements forward (or backward if n < 0)
+     * \param n   The number of elements by which to move
+     * \return A reference to the Iterator after it was moved
+     * \note Run time: constant
+     */
+    constexpr Iterator& operator+=(difference_type n);
+
+    /**
+     * \brief Moves the Iterator n elements backward (or forward if n < 0)
+     * \param n   The number of elements by which to move
+     * \return A reference to the Iterator after it was moved
+     * \note Run time: constant
+     */
+    constexpr Iterator& operator-=(difference_type n);
+
+    /**
+     * \brief Creates an Iterator n elements after this one
+     * \param n   The number of elements by which to move
+     * \return An Iterator n elements after this one
+     * \note Run time: constant
+     */
+    constexpr Iterator operator+(difference_type n) const;
+
+    /**
+     * \brief Creates an Iterator n elements before this one
+     * \param n   The number of elements by which to move
+     * \return An Iterator n elements before this one
+     * \note Run time: constant
+     */
+    constexpr Iterator operator-(difference_type n) const;
+
+    /**
+     * \brief Computes the number of elements between two Iterators
+     * \param rhs   The Iterator from which to measure
+     * \return The number of increments needed to move from rhs to this
+     * \note Run time: constant
+     * \warning Behavior is undefined if the Iterators point to different
+     * MinHeaps
+     */
+    constexpr difference_type operator-(const Iterator& rhs) const;
+
+    /**
+     * \brief Returns a reference to the element n positions after this one
+     * \param n   The offset of the element from this Iterator
+     * \return A reference to the element n positions after this one
+     * \note Run time: constant
+     */
+    constexpr reference operator[](difference_type n) const;
+
+    /**
+     * \brief Compares the positions of two Iterators in the MinHeap
+     * \param rhs   The Iterator with which to compare
+     * \return True if this Iterator comes before rhs
+     * \note Run time: constant
+     */
+    constexpr bool operator<(const Iterator& rhs) const;
+
+    /**
+     * \brief Compares the positions of two Iterators in the MinHeap
+     * \param rhs   The Iterator with which to compare
+     * \return True if this Iterator comes after rhs
+     * \note Run time: constant
+     */
+    constexpr bool operator>(const Iterator& rhs) const;
+
+    /**
+     * \brief Compares the positions of two Iterators in the MinHeap
+     * \param rhs   The Iterator with which to compare
+     * \return True if this Iterator does not come after rhs
+     * \note Run time: constant
+     */
+    constexpr bool operator<=(const Iterator& rhs) const;
+
+    /**
+     * \brief Compares the positions of two Iterators in the MinHeap
+     * \param rhs   The Iterator with which to compare
+     * \return True if this Iterator does not come before rhs
+     * \note Run time: constant
+     */
+    constexpr bool operator>=(const Iterator& rhs) const;
+
+    // "n + iter" has an int on the left-hand side, so it cannot be a member
+    // function.  We define it as a friend inside the class because the
+    // compiler cannot deduce T and IS_CONST for a nested class template from
+    // a global function template's parameters.
+    friend constexpr Iterator operator+(difference_type n,
+                                        const Iterator& iter) {
+      return iter + n;
+    }
 
    private:
     // We declare MinHeap as a friend so that it can access our private members
     // This also allows Iterator<true> to access the private members of
     // Iterator<false> and vice versa
-    friend class MinHeap<T>;
+    friend class MinHeap<T, INLINE_CAPACITY, Prefetch>;
 
-    /** \brief A pointer to a pointer to the current element in the MinHeap */
-    T** pointer_;
+    /** \brief A pointer to the slot of the current element in the MinHeap */
+    Slot* pointer_;
 
     /**
      * \brief Creates an Iterator pointing to a particular element of a MinHeap
-     * \param pointer   A ** to the element of the MinHeap to which to point
+     * \param pointer   A pointer to the slot of the element to which to point
      * \note Run time: constant
      */
-    Iterator(T** pointer);
+    constexpr Iterator(Slot* pointer);
   };
 };
 
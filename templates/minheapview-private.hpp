@@ -0,0 +1,131 @@
+/**
+ * \file minheapview-private.hpp
+ * \copyright Matthew Calligaro
+ * \date January 2020
+ * \brief Provides the template implementation for the MinHeapView class
+ */
+
+// NOLINT(build/header_guard)
+
+#include <span>
+#include <utility>
+
+template <typename T>
+constexpr MinHeapView<T>::MinHeapView(std::span<T> storage, size_t size)
+    : storage_{storage}, size_{size} {
+  // Bubbling down every parent, starting from the last one, builds the heap
+  // in linear time (the same approach as MinHeap::heapify)
+  for (size_t index = size_ / 2; index > 0; --index) {
+    bubbleDown(index - 1);
+  }
+}
+
+template <typename T>
+constexpr MinHeapView<T>::MinHeapView(std::span<T> storage)
+    : MinHeapView(storage, storage.size()) {
+  // Nothing else to do
+}
+
+template <typename T>
+constexpr const T* MinHeapView<T>::begin() const {
+  return storage_.data();
+}
+
+template <typename T>
+constexpr const T* MinHeapView<T>::end() const {
+  return storage_.data() + size_;
+}
+
+template <typename T>
+constexpr const T* MinHeapView<T>::cbegin() const {
+  return begin();
+}
+
+template <typename T>
+constexpr const T* MinHeapView<T>::cend() const {
+  return end();
+}
+
+template <typename T>
+constexpr size_t MinHeapView<T>::size() const {
+  return size_;
+}
+
+template <typename T>
+constexpr size_t MinHeapView<T>::capacity() const {
+  return storage_.size();
+}
+
+template <typename T>
+constexpr bool MinHeapView<T>::empty() const {
+  return size_ == 0;
+}
+
+template <typename T>
+constexpr bool MinHeapView<T>::full() const {
+  return size_ == storage_.size();
+}
+
+template <typename T>
+constexpr const T& MinHeapView<T>::peakMin() const {
+  return storage_[0];
+}
+
+template <typename T>
+constexpr bool MinHeapView<T>::insert(const T& val) {
+  if (full()) {
+    return false;
+  }
+  storage_[size_] = val;
+  ++size_;
+  bubbleUp(size_ - 1);
+  return true;
+}
+
+template <typename T>
+constexpr void MinHeapView<T>::deleteMin() {
+  // The last element takes the place of the smallest, which moves into the
+  // slot the heap no longer uses instead of being destroyed
+  --size_;
+  if (size_ > 0) {
+    using std::swap;
+    swap(storage_[0], storage_[size_]);
+    bubbleDown(0);
+  }
+}
+
+template <typename T>
+constexpr void MinHeapView<T>::bubbleUp(size_t index) {
+  // Rather than swapping at every level, we hold the element aside and move
+  // each larger parent down into the hole it leaves, then fill the hole once
+  T moving = std::move(storage_[index]);
+  while (index > 0) {
+    size_t parent = (index - 1) / 2;
+    if (!(moving < storage_[parent])) {
+      break;
+    }
+    storage_[index] = std::move(storage_[parent]);
+    index = parent;
+  }
+  storage_[index] = std::move(moving);
+}
+
+template <typename T>
+constexpr void MinHeapView<T>::bubbleDown(size_t index) {
+  T moving = std::move(storage_[index]);
+  while (true) {
+    size_t child = 2 * index + 1;
+    if (child >= size_) {
+      break;
+    }
+    if (child + 1 < size_ && storage_[child + 1] < storage_[child]) {
+      ++child;
+    }
+    if (!(storage_[child] < moving)) {
+      break;
+    }
+    storage_[index] = std::move(storage_[child]);
+    index = child;
+  }
+  storage_[index] = std::move(moving);
+}
@@ -0,0 +1,166 @@
+/**
+ * \file minheapview-test.cpp
+ * \copyright Matthew Calligaro
+ * \date January 2020
+ * \brief An assortment of ad hoc tests for the MinHeapView class
+ * \note These tests are not comprehensive and are NOT a good example of unit
+ * testing
+ */
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <new>
+#include <random>
+#include <string>
+#include <vector>
+#include "minheapview.hpp"
+
+/** \brief The number of times operator new has been called */
+size_t allocations = 0;
+
+void* operator new(size_t size) {
+  ++allocations;
+  void* memory = std::malloc(size == 0 ? 1 : size);
+  if (memory == nullptr) {
+    throw std::bad_alloc();
+  }
+  return memory;
+}
+
+void operator delete(void* memory) noexcept {
+  std::free(memory);
+}
+
+void operator delete(void* memory, size_t) noexcept {
+  std::free(memory);
+}
+
+/**
+ * \brief Checks that every element of a view is no smaller than its parent
+ * \param view  The MinHeapView to check
+ * \return True if the view is a valid heap
+ */
+template <typename T>
+bool isHeap(const MinHeapView<T>& view) {
+  const T* first = view.begin();
+  for (size_t index = 1; index < view.size(); ++index) {
+    if (first[index] < first[(index - 1) / 2]) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/**
+ * \brief Builds views of shuffled vectors and empties them
+ */
+void orderTest() {
+  std::default_random_engine engine(44);
+  for (size_t count : {0, 1, 2, 3, 10, 100, 1000}) {
+    std::vector<int> numbers(count);
+    for (size_t i = 0; i < count; ++i) {
+      numbers[i] = static_cast<int>(i / 2);
+    }
+    std::shuffle(numbers.begin(), numbers.end(), engine);
+    std::vector<int> sorted = numbers;
+    std::sort(sorted.begin(), sorted.end());
+
+    MinHeapView<int> view(numbers);
+    assert(view.size() == count);
+    assert(view.full());
+    assert(isHeap(view));
+    assert(std::is_permutation(view.begin(), view.end(), sorted.begin()));
+
+    // Emptying the view is a heap sort, leaving the largest element first
+    for (size_t i = 0; i < count; ++i) {
+      assert(view.peakMin() == sorted[i]);
+      view.deleteMin();
+      assert(isHeap(view));
+    }
+    assert(view.empty());
+    assert(std::equal(numbers.begin(), numbers.end(), sorted.rbegin()));
+  }
+}
+
+/**
+ * \brief Inserts into spare capacity, mixed with deleteMin
+ */
+void insertTest() {
+  std::array<std::string, 8> storage = {"pear", "fig", "kiwi"};
+  MinHeapView<std::string> view(storage, 3);
+  assert(view.size() == 3);
+  assert(view.capacity() == 8);
+  assert(view.peakMin() == "fig");
+
+  for (const char* fruit : {"apple", "lime", "date", "plum", "yuzu"}) {
+    assert(view.insert(fruit));
+    assert(isHeap(view));
+  }
+  assert(view.full());
+  assert(!view.insert("banana"));
+  assert(view.size() == 8);
+
+  assert(view.peakMin() == "apple");
+  view.deleteMin();
+  assert(storage[7] == "apple");
+  assert(view.peakMin() == "date");
+  assert(view.insert("banana"));
+  assert(view.peakMin() == "banana");
+
+  // The heap only ever touches the first size() slots
+  std::vector<int> numbers = {5, 3, 9, -1, -2};
+  MinHeapView<int> partial(numbers, 3);
+  assert(partial.peakMin() == 3);
+  assert(numbers[3] == -1 && numbers[4] == -2);
+}
+
+/**
+ * \brief Checks that nothing the view does allocates memory
+ */
+void allocationTest() {
+  std::vector<size_t> numbers(1 << 12);
+  std::default_random_engine engine(45);
+  for (size_t& number : numbers) {
+    number = engine();
+  }
+
+  size_t before = allocations;
+  MinHeapView<size_t> view(numbers, numbers.size() / 2);
+  while (view.insert(engine())) {
+    assert(isHeap(view));
+  }
+  while (!view.empty()) {
+    view.deleteMin();
+  }
+  assert(allocations == before);
+  assert(std::is_sorted(numbers.begin(), numbers.end(),
+                        std::greater<size_t>()));
+}
+
+/**
+ * \brief Sorts an array while compiling, which only works if every method
+ * used is constexpr
+ * \return The sorted array
+ */
+constexpr std::array<int, 6> compileTimeSort() {
+  std::array<int, 6> numbers = {4, 1, 5, 9, 2, 6};
+  MinHeapView<int> view(numbers);
+  while (!view.empty()) {
+    view.deleteMin();
+  }
+  return numbers;
+}
+
+int main() {
+  orderTest();
+  insertTest();
+  allocationTest();
+  static_assert(compileTimeSort() == std::array<int, 6>{9, 6, 5, 4, 2, 1});
+
+  std::cout << "All tests passed" << std::endl;
+  return 0;
+}
@@ -0,0 +1,181 @@
+/**
+ * \file minheapview.hpp
+ * \copyright Matthew Calligaro
+ * \date January 2020
+ * \brief Declares the MinHeapView class
+ */
+
+#ifndef TEMPLATES_MINHEAPVIEW_HPP_
+#define TEMPLATES_MINHEAPVIEW_HPP_
+
+#include <cstddef>
+#include <span>
+
+/**
+ * \class MinHeapView
+ * \brief A binary min heap over an array owned by someone else
+ * \details Building a MinHeap from a std::vector copies every element into
+ * its own allocation.  A MinHeapView instead arranges the elements of an
+ * existing array (a std::vector, a std::array, a memory-mapped file, ...)
+ * into a heap where they already are, and never allocates memory.
+ *
+ * The view covers a span of storage.  The first size() elements of the span
+ * are the heap, in the usual 0-indexed layout where the children of index i
+ * are at 2i + 1 and 2i + 2, and the rest is spare capacity.  insert writes
+ * into the first spare slot, like push_back, and deleteMin swaps the smallest
+ * element into the last slot of the heap before shrinking it, like
+ * std::pop_heap.  Calling deleteMin until the view is empty therefore leaves
+ * the storage sorted from largest to smallest.
+ *
+ * The storage must outlive the view, and must not be changed other than
+ * through the view while the view is in use.
+ * \note A MinHeapView cannot be copied, since two views of the same storage
+ * would disagree about which elements are in the heap
+ * \note The template type T must support move construction, move assignment,
+ * and operator<
+ */
+template <typename T>
+class MinHeapView {
+ public:
+  // STL container type definitions
+  using value_type = T;
+  using size_type = size_t;
+  using difference_type = ptrdiff_t;
+  using const_reference = const value_type&;
+  using const_iterator = const value_type*;
+
+  /**
+   * \brief Creates a view of storage, whose first size elements are
+   * rearranged into a heap
+   * \param storage   The array to use, which must outlive the view
+   * \param size      The number of elements at the start of storage which
+   * form the heap.  The rest of storage is spare capacity.
+   * \note Run time: linear in size
+   * \warning Behavior is undefined if size is larger than storage.size()
+   */
+  constexpr MinHeapView(std::span<T> storage, size_type size);
+
+  /**
+   * \brief Creates a view of storage, every element of which is rearranged
+   * into a heap
+   * \param storage   The array to use, which must outlive the view
+   * \note Run time: linear in the size of storage
+   */
+  constexpr explicit MinHeapView(std::span<T> storage);
+
+  MinHeapView(const MinHeapView& other) = delete;
+  MinHeapView& operator=(const MinHeapView& other) = delete;
+
+  /**
+   * \brief Creates a const_iterator to the first element of the heap
+   * \return A const_iterator pointing to the first element of the heap
+   * \note Elements are visited in breadth-first order, so the first is the
+   * smallest, but the rest are not sorted
+   * \note Run time: constant
+   */
+  constexpr const_iterator begin() const;
+
+  /**
+   * \brief Creates a const_iterator to the past-the-end element of the heap
+   * \return A const_iterator to the past-the-end element of the heap, which
+   * is also the first slot of spare capacity
+   * \note Run time: constant
+   */
+  constexpr const_iterator end() const;
+
+  /**
+   * \brief Creates a const_iterator to the first element of the heap
+   * \return A const_iterator pointing to the first element of the heap
+   * \note Run time: constant
+   */
+  constexpr const_iterator cbegin() const;
+
+  /**
+   * \brief Creates a const_iterator to the past-the-end element of the heap
+   * \return A const_iterator to the past-the-end element of the heap
+   * \note Run time: constant
+   */
+  constexpr const_iterator cend() const;
+
+  /**
+   * \brief Returns the number of elements in the heap
+   * \return The number of elements in the heap
+   * \note Run time: constant
+   */
+  constexpr size_type size() const;
+
+  /**
+   * \brief Returns the number of elements the heap can hold
+   * \return The size of the storage
+   * \note Run time: constant
+   */
+  constexpr size_type capacity() const;
+
+  /**
+   * \brief Returns whether the heap is empty
+   * \return True if the size of the heap is 0
+   * \note Run time: constant
+   */
+  constexpr bool empty() const;
+
+  /**
+   * \brief Returns whether the heap has used all of its storage
+   * \return True if the size of the heap is its capacity
+   * \note Run time: constant
+   */
+  constexpr bool full() const;
+
+  /**
+   * \brief Returns a reference to the smallest element of the heap
+   * \return A reference to the smallest element of the heap
+   * \note Run time: constant
+   * \warning Behavior is undefined if the heap is empty
+   */
+  constexpr const_reference peakMin() const;
+
+  /**
+   * \brief Copies a value into the first spare slot and adds it to the heap,
+   * if there is a spare slot
+   * \param val   The value to insert
+   * \return True if val was inserted, false if the heap was full
+   * \note Run time: logarithmic in the size of the heap
+   * \warning Invalidates all iterators pointing to this MinHeapView
+   */
+  constexpr bool insert(const_reference val);
+
+  /**
+   * \brief Removes the smallest value from the heap, moving it into the slot
+   * just past the new end of the heap
+   * \note Run time: logarithmic in the size of the heap
+   * \warning Invalidates all iterators pointing to this MinHeapView
+   * \warning Behavior is undefined if the heap is empty
+   */
+  constexpr void deleteMin();
+
+ private:
+  /** \brief The array, whose first size_ elements are the heap */
+  std::span<T> storage_;
+
+  /** \brief The number of elements in the heap */
+  size_t size_;
+
+  /**
+   * \brief Moves the element at index up until it is no smaller than its
+   * parent
+   * \param index   The index of the element to move
+   * \note Run time: logarithmic in the size of the heap
+   */
+  constexpr void bubbleUp(size_t index);
+
+  /**
+   * \brief Moves the element at index down until it is no larger than either
+   * of its children
+   * \param index   The index of the element to move
+   * \note Run time: logarithmic in the size of the heap
+   */
+  constexpr void bubbleDown(size_t index);
+};
+
+#include "minheapview-private.hpp"
+
+#endif  // TEMPLATES_MINHEAPVIEW_HPP_
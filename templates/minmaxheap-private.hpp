@@ -0,0 +1,446 @@
+/**
+ * \file minmaxheap-private.hpp
+ * \copyright Matthew Calligaro
+ * \date January 2020
+ * \brief Provides the template implementation for the MinMaxHeap class
+ */
+
+// NOLINT(build/header_guard)
+
+#include <ostream>
+#include <utility>
+
+/*******************************************************************************
+ * MinMaxHeap implementation
+ ******************************************************************************/
+
+template <typename T>
+MinMaxHeap<T>::MinMaxHeap()
+    : arraySize_{2}, size_{0}, array_{new T*[arraySize_]} {}
+
+template <typename T>
+MinMaxHeap<T>::MinMaxHeap(const MinMaxHeap& other)
+    : arraySize_{other.arraySize_},
+      size_{other.size_},
+      array_{new T*[arraySize_]} {
+  // We must manually copy each element in order to make a deep copy
+  for (size_t i = 1; i <= size_; ++i) {
+    array_[i] = new T(*other.array_[i]);
+  }
+}
+
+template <typename T>
+MinMaxHeap<T>& MinMaxHeap<T>::operator=(const MinMaxHeap& other) {
+  MinMaxHeap copy = other;
+  swap(copy);
+  return *this;
+}
+
+template <typename T>
+MinMaxHeap<T>::~MinMaxHeap() {
+  for (size_t i = 1; i <= size_; ++i) {
+    delete array_[i];
+  }
+  delete[] array_;
+}
+
+template <typename T>
+void MinMaxHeap<T>::swap(MinMaxHeap& other) {
+  std::swap(arraySize_, other.arraySize_);
+  std::swap(size_, other.size_);
+  std::swap(array_, other.array_);
+}
+
+template <typename T>
+bool MinMaxHeap<T>::operator==(const MinMaxHeap& rhs) const {
+  if (size_ != rhs.size_) {
+    return false;
+  }
+
+  // As with MinHeap, equal MinMaxHeaps may store their elements in different
+  // orders, so we compare copies one minimum at a time
+  for (MinMaxHeap lcopy(*this), rcopy(rhs); !lcopy.empty();
+       lcopy.deleteMin(), rcopy.deleteMin()) {
+    if (lcopy.peakMin() != rcopy.peakMin()) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+template <typename T>
+bool MinMaxHeap<T>::operator!=(const MinMaxHeap& rhs) const {
+  return !(*this == rhs);
+}
+
+template <typename T>
+typename MinMaxHeap<T>::const_iterator MinMaxHeap<T>::begin() const {
+  return cbegin();
+}
+
+template <typename T>
+typename MinMaxHeap<T>::const_iterator MinMaxHeap<T>::end() const {
+  return cend();
+}
+
+template <typename T>
+typename MinMaxHeap<T>::const_iterator MinMaxHeap<T>::cbegin() const {
+  return const_iterator(array_ + 1);
+}
+
+template <typename T>
+typename MinMaxHeap<T>::const_iterator MinMaxHeap<T>::cend() const {
+  return const_iterator(array_ + size_ + 1);
+}
+
+template <typename T>
+typename MinMaxHeap<T>::size_type MinMaxHeap<T>::size() const {
+  return size_;
+}
+
+template <typename T>
+bool MinMaxHeap<T>::empty() const {
+  return size_ == 0;
+}
+
+template <typename T>
+std::ostream& MinMaxHeap<T>::print(std::ostream& os, bool complete) const {
+  os << "[";
+
+  // In complete mode, print the unused index 0
+  if (complete) {
+    os << "x";
+  }
+
+  // Print the elements in array_ seperated by commas
+  size_t startIndex = 1;
+  if (!complete && size_ > 0) {
+    os << *array_[1];
+    startIndex = 2;
+  }
+  for (size_t i = startIndex; i <= size_; ++i) {
+    os << "," << *array_[i];
+  }
+
+  // In complete mode, print the empty spaces at the end of array_
+  if (complete) {
+    for (size_t i = size_ + 1; i < arraySize_; ++i) {
+      os << ",_";
+    }
+  }
+
+  os << "]";
+  return os;
+}
+
+template <typename T>
+typename MinMaxHeap<T>::const_reference MinMaxHeap<T>::peakMin() const {
+  // The root is on a min level, so it is smaller than every other element
+  return *array_[1];
+}
+
+template <typename T>
+typename MinMaxHeap<T>::const_reference MinMaxHeap<T>::peakMax() const {
+  return *array_[maxIndex()];
+}
+
+template <typename T>
+bool MinMaxHeap<T>::exists(const_reference val) const {
+  // Neither the min levels nor the max levels let us rule out a whole subtree
+  // in both directions, so we simply check every element
+  for (size_t i = 1; i <= size_; ++i) {
+    if (*array_[i] == val) {
+      return true;
+    }
+  }
+  return false;
+}
+
+template <typename T>
+void MinMaxHeap<T>::insert(const_reference val) {
+  // If array_ is full, double its size
+  if (size_ >= arraySize_ - 1) {
+    resize(true);
+  }
+
+  // Insert val at the end of array_ and move it into place
+  ++size_;
+  array_[size_] = new T(val);
+  bubbleUp(size_);
+}
+
+template <typename T>
+void MinMaxHeap<T>::deleteMin() {
+  removeAt(1);
+}
+
+template <typename T>
+void MinMaxHeap<T>::deleteMax() {
+  removeAt(maxIndex());
+}
+
+template <typename T>
+void MinMaxHeap<T>::resize(bool upsize) {
+  T** oldArray = array_;
+
+  // Create a new array_ with the updated size
+  if (upsize) {
+    arraySize_ *= 2;
+  } else {
+    arraySize_ /= 2;
+  }
+  array_ = new T*[arraySize_];
+
+  // Copy over the pointers from oldArray to the new array_, without touching
+  // any of the elements themselves
+  for (size_t i = 1; i <= size_; ++i) {
+    array_[i] = oldArray[i];
+  }
+
+  delete[] oldArray;
+}
+
+template <typename T>
+bool MinMaxHeap<T>::onMinLevel(size_t index) {
+  // The root (depth 0) is on a min level, and each level below alternates
+  bool isMin = true;
+  for (; index > 1; index /= 2) {
+    isMin = !isMin;
+  }
+  return isMin;
+}
+
+template <typename T>
+size_t MinMaxHeap<T>::maxIndex() const {
+  // The largest element is on the first max level, unless the root is alone
+  if (size_ == 1) {
+    return 1;
+  } else if (size_ == 2 || *array_[3] < *array_[2]) {
+    return 2;
+  }
+  return 3;
+}
+
+template <typename T>
+bool MinMaxHeap<T>::before(size_t lhs, size_t rhs, bool isMin) const {
+  // Only operator< is required of T, so "a > b" is written as "b < a"
+  return isMin ? *array_[lhs] < *array_[rhs] : *array_[rhs] < *array_[lhs];
+}
+
+template <typename T>
+void MinMaxHeap<T>::bubbleUp(size_t index) {
+  if (index == 1) {
+    return;
+  }
+
+  // If the new element belongs on the other kind of level (for example, it is
+  // on a min level but larger than its parent on a max level), swap it with
+  // its parent first.  Afterwards, it only needs to be compared with its
+  // grandparents, which are on the same kind of level.
+  size_t parent = index / 2;
+  bool isMin = onMinLevel(index);
+  if (before(index, parent, !isMin)) {
+    std::swap(array_[index], array_[parent]);
+    bubbleUpLevels(parent, !isMin);
+  } else {
+    bubbleUpLevels(index, isMin);
+  }
+}
+
+template <typename T>
+void MinMaxHeap<T>::bubbleUpLevels(size_t index, bool isMin) {
+  for (; index >= 4 && before(index, index / 4, isMin); index /= 4) {
+    std::swap(array_[index], array_[index / 4]);
+  }
+}
+
+template <typename T>
+void MinMaxHeap<T>::trickleDown(size_t index) {
+  bool isMin = onMinLevel(index);
+
+  while (2 * index <= size_) {
+    // Find the smallest (or largest, on a max level) of the children and
+    // grandchildren
+    size_t best = 2 * index;
+    for (size_t i : {2 * index + 1, 4 * index, 4 * index + 1, 4 * index + 2,
+                     4 * index + 3}) {
+      if (i <= size_ && before(i, best, isMin)) {
+        best = i;
+      }
+    }
+
+    if (!before(best, index, isMin)) {
+      return;
+    }
+    std::swap(array_[index], array_[best]);
+
+    // A child is on the other kind of level, so it has no descendants on our
+    // kind of level that could be out of place
+    if (best < 4 * index) {
+      return;
+    }
+
+    // The element we moved down to a grandchild might now be out of order
+    // with the grandchild's parent, which is on the other kind of level
+    if (before(best / 2, best, isMin)) {
+      std::swap(array_[best], array_[best / 2]);
+    }
+    index = best;
+  }
+}
+
+template <typename T>
+void MinMaxHeap<T>::removeAt(size_t index) {
+  // Delete the element and move the last element into its place
+  delete array_[index];
+  array_[index] = array_[size_];
+  --size_;
+  if (index <= size_) {
+    trickleDown(index);
+  }
+
+  // If array_ is 1/4 full or less, cut the size in half
+  if (size_ > 0 && size_ <= arraySize_ / 4) {
+    resize(false);
+  }
+}
+
+/*******************************************************************************
+ * MinMaxHeap::ConstIterator implementation
+ ******************************************************************************/
+
+template <typename T>
+MinMaxHeap<T>::ConstIterator::ConstIterator() : pointer_{nullptr} {}
+
+template <typename T>
+MinMaxHeap<T>::ConstIterator::ConstIterator(T* const* pointer)
+    : pointer_{pointer} {}
+
+template <typename T>
+bool MinMaxHeap<T>::ConstIterator::operator==(const ConstIterator& rhs) const {
+  return pointer_ == rhs.pointer_;
+}
+
+template <typename T>
+bool MinMaxHeap<T>::ConstIterator::operator!=(const ConstIterator& rhs) const {
+  return !(*this == rhs);
+}
+
+template <typename T>
+typename MinMaxHeap<T>::ConstIterator::reference
+    MinMaxHeap<T>::ConstIterator::operator*() const {
+  return **pointer_;
+}
+
+template <typename T>
+typename MinMaxHeap<T>::ConstIterator::pointer
+    MinMaxHeap<T>::ConstIterator::operator->() const {
+  return *pointer_;
+}
+
+template <typename T>
+typename MinMaxHeap<T>::ConstIterator&
+MinMaxHeap<T>::ConstIterator::operator++() {
+  ++pointer_;
+  return *this;
+}
+
+template <typename T>
+typename MinMaxHeap<T>::ConstIterator&
+MinMaxHeap<T>::ConstIterator::operator--() {
+  --pointer_;
+  return *this;
+}
+
+template <typename T>
+typename MinMaxHeap<T>::ConstIterator MinMaxHeap<T>::ConstIterator::operator++(
+    int) {
+  ConstIterator copy = *this;
+  ++*this;
+  return copy;
+}
+
+template <typename T>
+typename MinMaxHeap<T>::ConstIterator MinMaxHeap<T>::ConstIterator::operator--(
+    int) {
+  ConstIterator copy = *this;
+  --*this;
+  return copy;
+}
+
+template <typename T>
+typename MinMaxHeap<T>::ConstIterator&
+MinMaxHeap<T>::ConstIterator::operator+=(difference_type n) {
+  pointer_ += n;
+  return *this;
+}
+
+template <typename T>
+typename MinMaxHeap<T>::ConstIterator&
+MinMaxHeap<T>::ConstIterator::operator-=(difference_type n) {
+  pointer_ -= n;
+  return *this;
+}
+
+template <typename T>
+typename MinMaxHeap<T>::ConstIterator MinMaxHeap<T>::ConstIterator::operator+(
+    difference_type n) const {
+  ConstIterator copy = *this;
+  copy += n;
+  return copy;
+}
+
+template <typename T>
+typename MinMaxHeap<T>::ConstIterator MinMaxHeap<T>::ConstIterator::operator-(
+    difference_type n) const {
+  ConstIterator copy = *this;
+  copy -= n;
+  return copy;
+}
+
+template <typename T>
+typename MinMaxHeap<T>::ConstIterator::difference_type
+MinMaxHeap<T>::ConstIterator::operator-(const ConstIterator& rhs) const {
+  return pointer_ - rhs.pointer_;
+}
+
+template <typename T>
+typename MinMaxHeap<T>::ConstIterator::reference
+    MinMaxHeap<T>::ConstIterator::operator[](difference_type n) const {
+  return *pointer_[n];
+}
+
+template <typename T>
+bool MinMaxHeap<T>::ConstIterator::operator<(const ConstIterator& rhs) const {
+  return pointer_ < rhs.pointer_;
+}
+
+template <typename T>
+bool MinMaxHeap<T>::ConstIterator::operator>(const ConstIterator& rhs) const {
+  return rhs < *this;
+}
+
+template <typename T>
+bool MinMaxHeap<T>::ConstIterator::operator<=(const ConstIterator& rhs) const {
+  return !(rhs < *this);
+}
+
+template <typename T>
+bool MinMaxHeap<T>::ConstIterator::operator>=(const ConstIterator& rhs) const {
+  return !(*this < rhs);
+}
+
+/*******************************************************************************
+ * Overloading global functions
+ ******************************************************************************/
+
+template <typename T>
+std::ostream& operator<<(std::ostream& os, const MinMaxHeap<T>& heap) {
+  return heap.print(os);
+}
+
+template <typename T>
+void swap(MinMaxHeap<T>& first, MinMaxHeap<T>& second) {
+  first.swap(second);
+}
@@ -0,0 +1,109 @@
+/**
+ * \file minmaxheap-test.cpp
+ * \copyright Matthew Calligaro
+ * \date January 2020
+ * \brief An assortment of ad hoc tests for the MinMaxHeap class
+ * \note These tests are not comprehensive and are NOT a good example of unit
+ * testing
+ */
+
+#include <cassert>
+#include <iostream>
+#include <iterator>
+#include <random>
+#include <set>
+#include <sstream>
+#include <string>
+#include "minmaxheap.hpp"
+
+/**
+ * \brief Runs several ad hoc tests of MinMaxHeap methods
+ */
+void coreTest() {
+  std::stringstream ss;
+
+  MinMaxHeap<std::string> h1;
+  assert(h1.empty());
+  h1.print(ss, true);
+  assert(ss.str() == "[x,_]");
+
+  for (std::string color : {"orange", "blue", "yellow", "green", "red"}) {
+    h1.insert(color);
+  }
+  assert(h1.size() == 5);
+  assert(h1.peakMin() == "blue" && h1.peakMax() == "yellow");
+  assert(h1.exists("green") && !h1.exists("purple"));
+  ss.str(std::string());
+  ss << h1;
+  assert(ss.str() == "[blue,red,yellow,green,orange]");
+
+  // Copying, assignment, and swap
+  MinMaxHeap<std::string> h2 = h1;
+  assert(h1 == h2);
+  h2.deleteMax();
+  assert(h1 != h2 && h2.peakMax() == "red");
+  MinMaxHeap<std::string> h3;
+  h3 = h2;
+  swap(h1, h3);
+  assert(h1 == h2 && h3.peakMax() == "yellow");
+
+  // Removing from both ends
+  h1.deleteMin();
+  assert(h1.peakMin() == "green" && h1.peakMax() == "red");
+  h1.deleteMax();
+  assert(h1.peakMin() == "green" && h1.peakMax() == "orange");
+  h1.deleteMax();
+  h1.deleteMax();
+  assert(h1.size() == 0);
+
+  // Iteration
+  int count = 0;
+  for (MinMaxHeap<std::string>::const_iterator i = h3.begin(); i != h3.end();
+       ++i) {
+    assert(h3.exists(*i) && !i->empty());
+    ++count;
+  }
+  assert(count == 5 && h3.end() - h3.begin() == 5);
+  assert(h3.begin()[0] == "blue");
+}
+
+/**
+ * \brief Compares a MinMaxHeap against std::multiset over random operations
+ */
+void randomTest() {
+  const size_t OPERATIONS = 20000;
+  std::default_random_engine engine(2020);
+  std::uniform_int_distribution<int> values(0, 500);
+  std::uniform_int_distribution<int> choices(0, 3);
+
+  MinMaxHeap<int> heap;
+  std::multiset<int> expected;
+  for (size_t i = 0; i < OPERATIONS; ++i) {
+    int choice = choices(engine);
+    if (expected.empty() || choice <= 1) {
+      int value = values(engine);
+      heap.insert(value);
+      expected.insert(value);
+    } else if (choice == 2) {
+      heap.deleteMin();
+      expected.erase(expected.begin());
+    } else {
+      heap.deleteMax();
+      expected.erase(std::prev(expected.end()));
+    }
+
+    assert(heap.size() == expected.size());
+    if (!expected.empty()) {
+      assert(heap.peakMin() == *expected.begin());
+      assert(heap.peakMax() == *expected.rbegin());
+    }
+  }
+}
+
+int main() {
+  coreTest();
+  randomTest();
+
+  std::cout << "All tests passed" << std::endl;
+  return 0;
+}
@@ -0,0 +1,455 @@
+/**
+ * \file minmaxheap.hpp
+ * \copyright Matthew Calligaro
+ * \date January 2020
+ * \brief Declares the MinMaxHeap class
+ */
+
+#ifndef TEMPLATES_MINMAXHEAP_HPP_
+#define TEMPLATES_MINMAXHEAP_HPP_
+
+#include <cstddef>
+#include <iterator>
+#include <ostream>
+
+/**
+ * \class MinMaxHeap
+ * \brief A templated min-max heap (double-ended priority queue) implemented as
+ * an extendable array
+ * \details A min-max heap is a binary tree whose levels alternate between min
+ * levels and max levels, starting with a min level at the root.  Every element
+ * on a min level is smaller than all of its descendants and every element on a
+ * max level is larger than all of its descendants.  Therefore, the smallest
+ * element is the root and the largest element is one of the root's children,
+ * so both can be found in constant time and removed in logarithmic time.  Like
+ * MinHeap, the tree is stored in a contiguous, 1-indexed array.
+ * \note The template type T must support the copy constructor, operator<, and
+ * operator==
+ */
+template <typename T>
+class MinMaxHeap {
+ private:
+  class ConstIterator;
+
+ public:
+  // STL container type definitions
+  using value_type = T;
+  using size_type = size_t;
+  using difference_type = ptrdiff_t;
+  using reference = value_type&;
+  using const_reference = const value_type&;
+  using const_iterator = ConstIterator;
+
+  /**
+   * \brief Creates an empty MinMaxHeap
+   * \note Run time: constant
+   */
+  MinMaxHeap();
+
+  /**
+   * \brief Creates a MinMaxHeap containing a deep copy of the contents of
+   * other
+   * \param other   The MinMaxHeap to be copied
+   * \note Run time: linear in the size of other
+   */
+  MinMaxHeap(const MinMaxHeap& other);
+
+  /**
+   * \brief Replaces current contents with a deep copy of the contents of other
+   * \param other   The MinMaxHeap to be copied
+   * \note Run time: linear in the size of other
+   */
+  MinMaxHeap& operator=(const MinMaxHeap& other);
+
+  /**
+   * \brief Frees all memory associated with the MinMaxHeap
+   * \note Run time: linear in the size of the MinMaxHeap
+   */
+  ~MinMaxHeap();
+
+  /**
+   * \brief Exchanges the contents of the MinMaxHeap with other
+   * \param other   The MinMaxHeap with which to exchange contents
+   * \note Run time: constant
+   */
+  void swap(MinMaxHeap& other);
+
+  /**
+   * \brief Compares if two MinMaxHeaps contain the same elements
+   * \param rhs   The MinMaxHeap with which to compare
+   * \return True if this MinMaxHeap and rhs contain the exact same elements
+   * \note Run time: O(nlog(n)), where n is the size of the MinMaxHeap
+   */
+  bool operator==(const MinMaxHeap& rhs) const;
+
+  /**
+   * \brief Compares if two MinMaxHeaps contain the same elements
+   * \param rhs   The MinMaxHeap with which to compare
+   * \return False if this MinMaxHeap and rhs contain the exact same elements
+   * \note Run time: O(nlog(n)), where n is the size of the MinMaxHeap
+   */
+  bool operator!=(const MinMaxHeap& rhs) const;
+
+  /**
+   * \brief Creates a const_iterator to the first element of the MinMaxHeap
+   * \return A const_iterator pointing to the first element of the MinMaxHeap
+   * \note Run time: constant
+   */
+  const_iterator begin() const;
+
+  /**
+   * \brief Creates a const_iterator to the past-the-end element of the
+   * MinMaxHeap
+   * \return A const_iterator to the past-the-end element of the MinMaxHeap
+   * \note Run time: constant
+   */
+  const_iterator end() const;
+
+  /**
+   * \brief Creates a const_iterator to the first element of the MinMaxHeap
+   * \return A const_iterator pointing to the first element of the MinMaxHeap
+   * \note Run time: constant
+   */
+  const_iterator cbegin() const;
+
+  /**
+   * \brief Creates a const_iterator to the past-the-end element of the
+   * MinMaxHeap
+   * \return A const_iterator to the past-the-end element of the MinMaxHeap
+   * \note Run time: constant
+   */
+  const_iterator cend() const;
+
+  /**
+   * \brief Returns the number of elements in the MinMaxHeap
+   * \return The number of elements in the MinMaxHeap
+   * \note Run time: constant
+   */
+  size_type size() const;
+
+  /**
+   * \brief Returns whether the MinMaxHeap is empty
+   * \return True if the size of the MinMaxHeap is 0
+   * \note Run time: constant
+   */
+  bool empty() const;
+
+  /**
+   * \brief Prints the elements of the MinMaxHeap to an ostream
+   * \param os        The ostream to which to print
+   * \param complete  If true, also print the empty spaces in the array
+   * \return The ostream which was passed in
+   * \note Run time: linear in the size of the MinMaxHeap
+   */
+  std::ostream& print(std::ostream& os, bool complete = false) const;
+
+  /**
+   * \brief Returns a reference to the smallest element of the MinMaxHeap
+   * \return A reference to the smallest element of the MinMaxHeap
+   * \note Run time: constant
+   * \warning Behavior is undefined if the MinMaxHeap is empty
+   */
+  const_reference peakMin() const;
+
+  /**
+   * \brief Returns a reference to the largest element of the MinMaxHeap
+   * \return A reference to the largest element of the MinMaxHeap
+   * \note Run time: constant
+   * \warning Behavior is undefined if the MinMaxHeap is empty
+   */
+  const_reference peakMax() const;
+
+  /**
+   * \brief Determines whether a value is contained in the MinMaxHeap
+   * \param val   The value for which to search in the MinMaxHeap
+   * \return True if val is contained in the MinMaxHeap
+   * \note Run time: worst-case linear in the size of the MinMaxHeap
+   */
+  bool exists(const_reference val) const;
+
+  /**
+   * \brief Adds a new value to the MinMaxHeap
+   * \param val   The value to insert into the MinMaxHeap
+   * \note Run time: amortized logarithmic in the size of the MinMaxHeap
+   * \warning Invalidates all iterators pointing to this MinMaxHeap
+   */
+  void insert(const_reference val);
+
+  /**
+   * \brief Removes the smallest value from the MinMaxHeap
+   * \note Run time: amortized logarithmic in the size of the MinMaxHeap
+   * \warning Invalidates all iterators pointing to this MinMaxHeap
+   * \warning Behavior is undefined if the MinMaxHeap is empty
+   */
+  void deleteMin();
+
+  /**
+   * \brief Removes the largest value from the MinMaxHeap
+   * \note Run time: amortized logarithmic in the size of the MinMaxHeap
+   * \warning Invalidates all iterators pointing to this MinMaxHeap
+   * \warning Behavior is undefined if the MinMaxHeap is empty
+   */
+  void deleteMax();
+
+ private:
+  /** \brief The size of array_ */
+  size_t arraySize_;
+
+  /** \brief The number of elements in the MinMaxHeap */
+  size_t size_;
+
+  /** \brief A 1-indexed array of pointers to the elements of the MinMaxHeap */
+  T** array_;
+
+  /**
+   * \brief Either double or halve the size of array_
+   * \param upsize  If true, double array_, if false, halve array_
+   * \note Run time: linear in the size of the MinMaxHeap
+   */
+  void resize(bool upsize);
+
+  /**
+   * \brief Determines whether an index is on a min level of the tree
+   * \param index   The index to check
+   * \return True if index is on a min level (an even depth)
+   * \note Run time: logarithmic in index
+   */
+  static bool onMinLevel(size_t index);
+
+  /**
+   * \brief Returns the index of the largest element
+   * \return 1 if the MinMaxHeap has one element, otherwise the index of the
+   * larger child of the root
+   * \note Run time: constant
+   * \warning Behavior is undefined if the MinMaxHeap is empty
+   */
+  size_t maxIndex() const;
+
+  /**
+   * \brief Compares two elements, either as smaller-than or larger-than
+   * \param lhs     The index of the first element
+   * \param rhs     The index of the second element
+   * \param isMin   If true, compare with <, if false, compare with >
+   * \return True if the element at lhs should be closer to the root
+   * \note Run time: constant
+   */
+  bool before(size_t lhs, size_t rhs, bool isMin) const;
+
+  /**
+   * \brief Moves a new element up until the min-max heap order is restored
+   * \param index   The index of the new element
+   * \note Run time: logarithmic in index
+   */
+  void bubbleUp(size_t index);
+
+  /**
+   * \brief Moves an element up through the levels of one kind (min or max)
+   * \param index   The index of the element to move
+   * \param isMin   True if index is on a min level
+   * \note Run time: logarithmic in index
+   */
+  void bubbleUpLevels(size_t index, bool isMin);
+
+  /**
+   * \brief Moves an element down until the min-max heap order is restored
+   * \param index   The index of the element to move
+   * \note Run time: logarithmic in the size of the MinMaxHeap
+   */
+  void trickleDown(size_t index);
+
+  /**
+   * \brief Removes the element at index, replacing it with the last element
+   * \param index   The index of the element to remove
+   * \note Run time: amortized logarithmic in the size of the MinMaxHeap
+   */
+  void removeAt(size_t index);
+
+  /**
+   * \class ConstIterator
+   * \brief A random-access const_iterator pointing to an element of a
+   * MinMaxHeap
+   * \details This iterator performs a breadth-first traversal of the
+   * MinMaxHeap, which will not visit the elements from smallest to largest.
+   * Unlike MinHeap, MinMaxHeap only provides a const_iterator, since changing
+   * an element could put it out of place.
+   */
+  class ConstIterator {
+   public:
+    // STL iterator type definitions
+    using difference_type = ptrdiff_t;
+    using iterator_category = std::random_access_iterator_tag;
+    using value_type = T;
+    using reference = const value_type&;
+    using pointer = const value_type*;
+
+    /**
+     * \brief Creates a default ConstIterator which does not point to any
+     * MinMaxHeap
+     * \note Run time: constant
+     * \warning It is undefined behavior to dereference, ++, or -- this iterator
+     */
+    ConstIterator();
+
+    /**
+     * \brief Compares if two ConstIterators are pointing to the same element
+     * \param rhs   The ConstIterator with which to compare
+     * \return True if this ConstIterator and rhs point to the same element
+     * \note Run time: constant
+     */
+    bool operator==(const ConstIterator& rhs) const;
+
+    /**
+     * \brief Compares if two ConstIterators are pointing to the same element
+     * \param rhs   The ConstIterator with which to compare
+     * \return False if this ConstIterator and rhs point to the same element
+     * \note Run time: constant
+     */
+    bool operator!=(const ConstIterator& rhs) const;
+
+    /**
+     * \brief Returns a reference to the element to which the ConstIterator
+     * points
+     * \return A reference to the element to which the ConstIterator points
+     * \note Run time: constant
+     */
+    reference operator*() const;
+
+    /**
+     * \brief Returns a pointer to the element to which the ConstIterator
+     * points
+     * \return A pointer to the element to which the ConstIterator points
+     * \note Run time: constant
+     */
+    pointer operator->() const;
+
+    /**
+     * \brief Moves the ConstIterator to the next element in the MinMaxHeap
+     * \return A reference to the ConstIterator after it was moved
+     * \note Run time: constant
+     */
+    ConstIterator& operator++();
+
+    /**
+     * \brief Moves the ConstIterator to the previous element in the MinMaxHeap
+     * \return A reference to the ConstIterator after it was moved
+     * \note Run time: constant
+     */
+    ConstIterator& operator--();
+
+    /**
+     * \brief Moves the ConstIterator to the next element in the MinMaxHeap
+     * \return A copy of the ConstIterator before it was moved
+     * \note Run time: constant
+     */
+    ConstIterator operator++(int);
+
+    /**
+     * \brief Moves the ConstIterator to the previous element in the MinMaxHeap
+     * \return A copy of the ConstIterator before it was moved
+     * \note Run time: constant
+     */
+    ConstIterator operator--(int);
+
+    /**
+     * \brief Moves the ConstIterator n elements forward (or backward if n < 0)
+     * \param n   The number of elements by which to move
+     * \return A reference to the ConstIterator after it was moved
+     * \note Run time: constant
+     */
+    ConstIterator& operator+=(difference_type n);
+
+    /**
+     * \brief Moves the ConstIterator n elements backward (or forward if n < 0)
+     * \param n   The number of elements by which to move
+     * \return A reference to the ConstIterator after it was moved
+     * \note Run time: constant
+     */
+    ConstIterator& operator-=(difference_type n);
+
+    /**
+     * \brief Creates a ConstIterator n elements after this one
+     * \param n   The number of elements by which to move
+     * \return A ConstIterator n elements after this one
+     * \note Run time: constant
+     */
+    ConstIterator operator+(difference_type n) const;
+
+    /**
+     * \brief Creates a ConstIterator n elements before this one
+     * \param n   The number of elements by which to move
+     * \return A ConstIterator n elements before this one
+     * \note Run time: constant
+     */
+    ConstIterator operator-(difference_type n) const;
+
+    /**
+     * \brief Computes the number of elements between two ConstIterators
+     * \param rhs   The ConstIterator from which to measure
+     * \return The number of increments needed to move from rhs to this
+     * \note Run time: constant
+     */
+    difference_type operator-(const ConstIterator& rhs) const;
+
+    /**
+     * \brief Returns a reference to the element n positions after this one
+     * \param n   The offset of the element from this ConstIterator
+     * \return A reference to the element n positions after this one
+     * \note Run time: constant
+     */
+    reference operator[](difference_type n) const;
+
+    /**
+     * \brief Compares the positions of two ConstIterators in the MinMaxHeap
+     * \param rhs   The ConstIterator with which to compare
+     * \return True if this ConstIterator comes before rhs
+     * \note Run time: constant
+     */
+    bool operator<(const ConstIterator& rhs) const;
+
+    /**
+     * \brief Compares the positions of two ConstIterators in the MinMaxHeap
+     * \param rhs   The ConstIterator with which to compare
+     * \return True if this ConstIterator comes after rhs
+     * \note Run time: constant
+     */
+    bool operator>(const ConstIterator& rhs) const;
+
+    /**
+     * \brief Compares the positions of two ConstIterators in the MinMaxHeap
+     * \param rhs   The ConstIterator with which to compare
+     * \return True if this ConstIterator does not come after rhs
+     * \note Run time: constant
+     */
+    bool operator<=(const ConstIterator& rhs) const;
+
+    /**
+     * \brief Compares the positions of two ConstIterators in the MinMaxHeap
+     * \param rhs   The ConstIterator with which to compare
+     * \return True if this ConstIterator does not come before rhs
+     * \note Run time: constant
+     */
+    bool operator>=(const ConstIterator& rhs) const;
+
+    friend ConstIterator operator+(difference_type n,
+                                   const ConstIterator& iter) {
+      return iter + n;
+    }
+
+   private:
+    friend class MinMaxHeap<T>;
+
+    /** \brief A pointer to a pointer to the current element */
+    T* const* pointer_;
+
+    /**
+     * \brief Creates a ConstIterator pointing to a particular element
+     * \param pointer   A ** to the element to which to point
+     * \note Run time: constant
+     */
+    explicit ConstIterator(T* const* pointer);
+  };
+};
+
+#include "minmaxheap-private.hpp"
+
+#endif  // TEMPLATES_MINMAXHEAP_HPP_
@@ -0,0 +1,111 @@
+/**
+ * \file multiqueue-private.hpp
+ * \copyright Matthew Calligaro
+ * \date January 2020
+ * \brief Provides the template implementation for the MultiQueue class
+ */
+
+// NOLINT(build/header_guard)
+
+#include <algorithm>
+#include <functional>
+#include <thread>
+
+template <typename T>
+MultiQueue<T>::MultiQueue(size_t threads, size_t perThread)
+    : shards_(std::max(size_t{1}, threads * perThread)) {
+  // Nothing else to do
+}
+
+template <typename T>
+size_t MultiQueue<T>::size() const {
+  return size_;
+}
+
+template <typename T>
+bool MultiQueue<T>::empty() const {
+  return size_ == 0;
+}
+
+template <typename T>
+size_t MultiQueue<T>::queues() const {
+  return shards_.size();
+}
+
+template <typename T>
+void MultiQueue<T>::insert(const T& val) {
+  // If another thread holds the MinHeap we picked, we pick again rather than
+  // wait for it
+  while (true) {
+    Shard& shard = shards_[randomShard()];
+    std::unique_lock<std::mutex> lock(shard.mutex, std::try_to_lock);
+    if (lock.owns_lock()) {
+      shard.heap.insert(val);
+      ++size_;
+      return;
+    }
+  }
+}
+
+template <typename T>
+bool MultiQueue<T>::deleteMin(T& min) {
+  // When only a few MinHeaps have elements left, random picks mostly find
+  // empty ones, so after a while we check every MinHeap in turn instead
+  for (size_t attempt = 0; attempt < 2 * shards_.size(); ++attempt) {
+    if (size_ == 0) {
+      return false;
+    }
+
+    // try_lock never waits, so holding two locks at once cannot deadlock.  A
+    // MinHeap we cannot lock right away is simply left out of the choice.
+    size_t first = randomShard();
+    size_t second = randomShard();
+    std::unique_lock<std::mutex> firstLock(shards_[first].mutex,
+                                           std::try_to_lock);
+    std::unique_lock<std::mutex> secondLock;
+    if (second != first) {
+      secondLock = std::unique_lock(shards_[second].mutex, std::try_to_lock);
+    }
+
+    MinHeap<T>* best = nullptr;
+    if (firstLock.owns_lock() && !shards_[first].heap.empty()) {
+      best = &shards_[first].heap;
+    }
+    if (secondLock.owns_lock() && !shards_[second].heap.empty() &&
+        (best == nullptr || shards_[second].heap.peakMin() < best->peakMin())) {
+      best = &shards_[second].heap;
+    }
+    if (best != nullptr) {
+      min = best->peakMin();
+      best->deleteMin();
+      --size_;
+      return true;
+    }
+  }
+  return deleteFromAny(min);
+}
+
+template <typename T>
+size_t MultiQueue<T>::randomShard() const {
+  // Seeding from the thread's id gives each thread a different sequence
+  thread_local std::minstd_rand engine(
+      std::hash<std::thread::id>()(std::this_thread::get_id()));
+  return engine() % shards_.size();
+}
+
+template <typename T>
+bool MultiQueue<T>::deleteFromAny(T& min) {
+  // Start at a random MinHeap so that threads spread out
+  size_t start = randomShard();
+  for (size_t i = 0; i < shards_.size(); ++i) {
+    Shard& shard = shards_[(start + i) % shards_.size()];
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    if (!shard.heap.empty()) {
+      min = shard.heap.peakMin();
+      shard.heap.deleteMin();
+      --size_;
+      return true;
+    }
+  }
+  return false;
+}
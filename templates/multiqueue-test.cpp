@@ -0,0 +1,101 @@
+/**
+ * \file multiqueue-test.cpp
+ * \copyright Matthew Calligaro
+ * \date January 2020
+ * \brief An assortment of ad hoc tests for the MultiQueue class
+ * \note These tests are not comprehensive and are NOT a good example of unit
+ * testing
+ */
+
+#include <algorithm>
+#include <cassert>
+#include <iostream>
+#include <thread>
+#include <vector>
+#include "multiqueue.hpp"
+
+/**
+ * \brief Checks that a MultiQueue with a single MinHeap is an exact priority
+ * queue, and that a larger one returns every element exactly once
+ */
+void sequentialTest() {
+  MultiQueue<int> exact(1, 1);
+  assert(exact.queues() == 1 && exact.empty());
+  for (int value : {5, 3, 8, 1, 9, 2}) {
+    exact.insert(value);
+  }
+  assert(exact.size() == 6);
+  int min = 0;
+  for (int expected : {1, 2, 3, 5, 8, 9}) {
+    assert(exact.deleteMin(min) && min == expected);
+  }
+  assert(!exact.deleteMin(min) && exact.empty());
+
+  const int COUNT = 10000;
+  MultiQueue<int> relaxed(4);
+  assert(relaxed.queues() == 8);
+  for (int i = 0; i < COUNT; ++i) {
+    relaxed.insert(i);
+  }
+  std::vector<int> removed;
+  while (relaxed.deleteMin(min)) {
+    removed.push_back(min);
+  }
+  assert(removed.size() == COUNT && relaxed.empty());
+
+  // The order is only roughly sorted, so we sort it to compare
+  std::sort(removed.begin(), removed.end());
+  for (int i = 0; i < COUNT; ++i) {
+    assert(removed[i] == i);
+  }
+}
+
+/**
+ * \brief Has several threads insert and remove at once, and checks that
+ * every element comes out exactly once
+ */
+void concurrentTest() {
+  const int THREADS = 4;
+  const int PER_THREAD = 20000;
+  MultiQueue<int> queue(THREADS);
+  std::vector<std::vector<int>> removed(THREADS);
+
+  std::vector<std::thread> threads;
+  for (int t = 0; t < THREADS; ++t) {
+    threads.emplace_back([&queue, &removed, t] {
+      // Each thread inserts its own range, removing as it goes
+      for (int i = 0; i < PER_THREAD; ++i) {
+        queue.insert(t * PER_THREAD + i);
+        int min = 0;
+        if (i % 2 == 1 && queue.deleteMin(min)) {
+          removed[t].push_back(min);
+        }
+      }
+    });
+  }
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+
+  std::vector<int> all;
+  for (const std::vector<int>& part : removed) {
+    all.insert(all.end(), part.begin(), part.end());
+  }
+  int min = 0;
+  while (queue.deleteMin(min)) {
+    all.push_back(min);
+  }
+  std::sort(all.begin(), all.end());
+  assert(all.size() == THREADS * PER_THREAD);
+  for (int i = 0; i < THREADS * PER_THREAD; ++i) {
+    assert(all[i] == i);
+  }
+}
+
+int main() {
+  sequentialTest();
+  concurrentTest();
+
+  std::cout << "All tests passed" << std::endl;
+  return 0;
+}
@@ -0,0 +1,139 @@
+/**
+ * \file multiqueue.hpp
+ * \copyright Matthew Calligaro
+ * \date January 2020
+ * \brief Declares the MultiQueue class
+ */
+
+#ifndef TEMPLATES_MULTIQUEUE_HPP_
+#define TEMPLATES_MULTIQUEUE_HPP_
+
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+#include <random>
+#include <vector>
+
+#include "minheap.hpp"
+
+/**
+ * \class MultiQueue
+ * \brief A relaxed priority queue which many threads can use at once
+ * \details A single MinHeap behind a single lock lets only one thread in at a
+ * time, however many cores there are.  A MultiQueue instead keeps several
+ * MinHeaps, each with a lock of its own.  insert adds to a randomly chosen
+ * MinHeap, and deleteMin looks at the tops of two randomly chosen MinHeaps and
+ * removes the smaller.  Threads rarely want the same MinHeap at the same
+ * time, and when they do, they pick other MinHeaps rather than wait.
+ *
+ * The price is that deleteMin is only approximately a deleteMin: it returns
+ * one of the smallest elements rather than always the smallest.  Since the
+ * elements are spread at random, each MinHeap holds a random sample of them,
+ * and taking the better of two tops keeps the rank of the removed element
+ * (the number of smaller elements left behind) small on average.  With a
+ * single MinHeap, a MultiQueue is an ordinary locked priority queue.
+ * \note The template type T must support the copy constructor, copy
+ * assignment, operator<, and operator==
+ */
+template <typename T>
+class MultiQueue {
+ public:
+  // STL container type definitions
+  using value_type = T;
+  using size_type = size_t;
+  using const_reference = const value_type&;
+
+  /**
+   * \brief Creates an empty MultiQueue
+   * \param threads   The number of threads expected to use the MultiQueue
+   * \param perThread The number of MinHeaps to create for each thread
+   * \note Run time: linear in threads * perThread
+   * \note More MinHeaps per thread mean fewer collisions but a larger rank
+   * error.  The default of 2 is the usual choice.
+   */
+  explicit MultiQueue(size_t threads, size_t perThread = 2);
+
+  // The locks cannot be copied, so neither can a MultiQueue
+  MultiQueue(const MultiQueue&) = delete;
+  MultiQueue& operator=(const MultiQueue&) = delete;
+
+  /**
+   * \brief Returns the number of elements in the MultiQueue
+   * \return The number of elements, which may already be out of date if
+   * other threads are using the MultiQueue
+   * \note Run time: constant
+   */
+  size_type size() const;
+
+  /**
+   * \brief Returns whether the MultiQueue is empty
+   * \return True if the size of the MultiQueue is 0
+   * \note Run time: constant
+   */
+  bool empty() const;
+
+  /**
+   * \brief Returns the number of MinHeaps in the MultiQueue
+   * \return The number of MinHeaps
+   * \note Run time: constant
+   */
+  size_type queues() const;
+
+  /**
+   * \brief Adds a new value to a randomly chosen MinHeap
+   * \param val   The value to insert
+   * \note Run time: amortized logarithmic in the size of the MultiQueue
+   * \note Safe to call from several threads at once
+   */
+  void insert(const_reference val);
+
+  /**
+   * \brief Removes one of the smallest values in the MultiQueue
+   * \param min   Set to the removed value, if there was one
+   * \return True if a value was removed, false if the MultiQueue was empty
+   * \note Run time: logarithmic in the size of the MultiQueue, unless nearly
+   * every MinHeap is empty, in which case it may be linear in queues()
+   * \note Safe to call from several threads at once
+   */
+  bool deleteMin(T& min);
+
+ private:
+  /**
+   * \struct Shard
+   * \brief One MinHeap and its lock
+   * \details Each Shard gets a cache line of its own, so that threads using
+   * neighboring Shards do not slow each other down (false sharing)
+   */
+  struct alignas(64) Shard {
+    std::mutex mutex;
+    MinHeap<T> heap;
+  };
+
+  /** \brief The MinHeaps */
+  std::vector<Shard> shards_;
+
+  /** \brief The total number of elements in all of the MinHeaps */
+  std::atomic<size_t> size_{0};
+
+  /**
+   * \brief Returns a random index into shards_
+   * \return An index chosen uniformly at random
+   * \note Run time: constant
+   * \note Each thread has its own random number generator, so threads never
+   * share its state
+   */
+  size_t randomShard() const;
+
+  /**
+   * \brief Removes the smallest value of the first non-empty MinHeap, waiting
+   * for each lock, for when random choices keep finding empty MinHeaps
+   * \param min   Set to the removed value, if there was one
+   * \return True if a value was removed
+   * \note Run time: linear in queues()
+   */
+  bool deleteFromAny(T& min);
+};
+
+#include "multiqueue-private.hpp"
+
+#endif  // TEMPLATES_MULTIQUEUE_HPP_
@@ -0,0 +1,245 @@
+/**
+ * \file pagedminheap-private.hpp
+ * \copyright Matthew Calligaro
+ * \date January 2020
+ * \brief Provides the template implementation for the PagedMinHeap class
+ */
+
+// NOLINT(build/header_guard)
+
+#include <memory>
+#include <new>
+#include <utility>
+
+/*******************************************************************************
+ * ImplicitLayout implementation
+ ******************************************************************************/
+
+constexpr size_t ImplicitLayout::position(size_t rank) {
+  return rank + 1;
+}
+
+constexpr size_t ImplicitLayout::parent(size_t pos) {
+  return pos / 2;
+}
+
+constexpr size_t ImplicitLayout::leftChild(size_t pos) {
+  return 2 * pos;
+}
+
+constexpr size_t ImplicitLayout::rightChild(size_t pos) {
+  return 2 * pos + 1;
+}
+
+/*******************************************************************************
+ * BlockLayout implementation
+ ******************************************************************************/
+
+// A position is split into the number of its block and its local index
+// within the block.  Local indices 2 and up use the usual 1-indexed layout,
+// and indices BLOCK_SLOTS / 2 and up are the leaves of the block.  Block 0
+// also uses local index 1, for the root of the whole heap.  Every other block
+// holds a pair of sibling subtrees, rooted at local indices 2 and 3, whose
+// parent is a leaf of another block.  Keeping siblings together matters,
+// since deleteMin always compares both children of a position.
+
+template <size_t LEVELS>
+constexpr size_t BlockLayout<LEVELS>::position(size_t rank) {
+  // Block 0 holds BLOCK_SLOTS - 1 elements and every other block holds
+  // BLOCK_SLOTS - 2, and blocks are filled in order
+  if (rank < BLOCK_SLOTS - 1) {
+    return rank + 1;
+  }
+  rank -= BLOCK_SLOTS - 1;
+  size_t block = 1 + rank / (BLOCK_SLOTS - 2);
+  return block * BLOCK_SLOTS + 2 + rank % (BLOCK_SLOTS - 2);
+}
+
+template <size_t LEVELS>
+constexpr size_t BlockLayout<LEVELS>::parent(size_t pos) {
+  size_t block = pos / BLOCK_SLOTS;
+  size_t local = pos % BLOCK_SLOTS;
+  if (block == 0 || local >= 4) {
+    return block * BLOCK_SLOTS + local / 2;
+  }
+
+  // The roots of a block are the children of a leaf of another block.  The
+  // blocks form a tree in which each block has one child block per leaf, so
+  // we find the parent block just as we would find the parent in a heap
+  // with BLOCK_SLOTS / 2 children per element.
+  size_t parentBlock = (block - 1) / (BLOCK_SLOTS / 2);
+  size_t leaf = (block - 1) % (BLOCK_SLOTS / 2);
+  return parentBlock * BLOCK_SLOTS + BLOCK_SLOTS / 2 + leaf;
+}
+
+template <size_t LEVELS>
+constexpr size_t BlockLayout<LEVELS>::leftChild(size_t pos) {
+  size_t block = pos / BLOCK_SLOTS;
+  size_t local = pos % BLOCK_SLOTS;
+  if (local < BLOCK_SLOTS / 2) {
+    return block * BLOCK_SLOTS + 2 * local;
+  }
+
+  // The children of a leaf are the two roots of its child block
+  size_t leaf = local - BLOCK_SLOTS / 2;
+  size_t childBlock = block * (BLOCK_SLOTS / 2) + 1 + leaf;
+  return childBlock * BLOCK_SLOTS + 2;
+}
+
+template <size_t LEVELS>
+constexpr size_t BlockLayout<LEVELS>::rightChild(size_t pos) {
+  // In either case, the two children are next to each other
+  return leftChild(pos) + 1;
+}
+
+/*******************************************************************************
+ * PagedMinHeap implementation
+ ******************************************************************************/
+
+template <typename T, typename Layout>
+PagedMinHeap<T, Layout>::PagedMinHeap()
+    : arraySize_{2}, size_{0}, array_{allocate(arraySize_)} {}
+
+template <typename T, typename Layout>
+PagedMinHeap<T, Layout>::PagedMinHeap(const PagedMinHeap& other)
+    : arraySize_{other.arraySize_},
+      size_{other.size_},
+      array_{allocate(arraySize_)} {
+  // The empty slots of other were never assigned, so we copy only the
+  // elements themselves
+  for (size_t rank = 0; rank < size_; ++rank) {
+    array_[Layout::position(rank)] = other.array_[Layout::position(rank)];
+  }
+}
+
+template <typename T, typename Layout>
+PagedMinHeap<T, Layout>& PagedMinHeap<T, Layout>::operator=(
+    const PagedMinHeap& other) {
+  PagedMinHeap copy = other;
+  swap(copy);
+  return *this;
+}
+
+template <typename T, typename Layout>
+PagedMinHeap<T, Layout>::~PagedMinHeap() {
+  deallocate(array_, arraySize_);
+}
+
+template <typename T, typename Layout>
+void PagedMinHeap<T, Layout>::swap(PagedMinHeap& other) {
+  std::swap(arraySize_, other.arraySize_);
+  std::swap(size_, other.size_);
+  std::swap(array_, other.array_);
+}
+
+template <typename T, typename Layout>
+size_t PagedMinHeap<T, Layout>::size() const {
+  return size_;
+}
+
+template <typename T, typename Layout>
+bool PagedMinHeap<T, Layout>::empty() const {
+  return size_ == 0;
+}
+
+template <typename T, typename Layout>
+const T& PagedMinHeap<T, Layout>::peakMin() const {
+  return array_[Layout::ROOT];
+}
+
+template <typename T, typename Layout>
+void PagedMinHeap<T, Layout>::insert(const T& val) {
+  // If the next position is past the end of array_, double its size
+  while (Layout::position(size_) >= arraySize_) {
+    resize(true);
+  }
+
+  // Rather than swapping val up one level at a time, we move each larger
+  // parent down into the hole and only write val once we find its place
+  size_t pos = Layout::position(size_);
+  ++size_;
+  while (pos != Layout::ROOT && val < array_[Layout::parent(pos)]) {
+    size_t parent = Layout::parent(pos);
+    array_[pos] = std::move(array_[parent]);
+    pos = parent;
+  }
+  array_[pos] = val;
+}
+
+template <typename T, typename Layout>
+void PagedMinHeap<T, Layout>::deleteMin() {
+  // Take the last element out of the array, and move the smaller child of the
+  // hole up until the last element fits in it
+  --size_;
+  size_t end = Layout::position(size_);
+  T last = std::move(array_[end]);
+  size_t pos = Layout::ROOT;
+  while (true) {
+    // Since the array is filled in increasing order of position, a child
+    // exists exactly when its position comes before end
+    size_t child = Layout::leftChild(pos);
+    if (child >= end) {
+      break;
+    }
+    size_t right = Layout::rightChild(pos);
+    if (right < end && array_[right] < array_[child]) {
+      child = right;
+    }
+    if (!(array_[child] < last)) {
+      break;
+    }
+    array_[pos] = std::move(array_[child]);
+    pos = child;
+  }
+  if (size_ > 0) {
+    array_[pos] = std::move(last);
+  }
+
+  // If array_ is 1/4 full or less, cut the size in half
+  if (size_ > 0 && end <= arraySize_ / 4) {
+    resize(false);
+  }
+}
+
+template <typename T, typename Layout>
+void PagedMinHeap<T, Layout>::resize(bool upsize) {
+  T* oldArray = array_;
+  size_t oldArraySize = arraySize_;
+
+  // Create a new array_ with the updated size
+  if (upsize) {
+    arraySize_ *= 2;
+  } else {
+    arraySize_ /= 2;
+  }
+  array_ = allocate(arraySize_);
+
+  // Copy over the elements, skipping the empty slots
+  for (size_t rank = 0; rank < size_; ++rank) {
+    size_t pos = Layout::position(rank);
+    array_[pos] = std::move(oldArray[pos]);
+  }
+
+  deallocate(oldArray, oldArraySize);
+}
+
+template <typename T, typename Layout>
+T* PagedMinHeap<T, Layout>::allocate(size_t slots) {
+  // new T[] only guarantees the alignment of T, so we ask for raw memory
+  // with the alignment we want and construct the slots in it ourselves
+  T* array = static_cast<T*>(
+      ::operator new[](slots * sizeof(T), std::align_val_t{ALIGNMENT}));
+  std::uninitialized_default_construct_n(array, slots);
+  return array;
+}
+
+template <typename T, typename Layout>
+void PagedMinHeap<T, Layout>::deallocate(T* array, size_t slots) {
+  std::destroy_n(array, slots);
+  ::operator delete[](array, std::align_val_t{ALIGNMENT});
+}
+
+template <typename T, typename Layout>
+void swap(PagedMinHeap<T, Layout>& lhs, PagedMinHeap<T, Layout>& rhs) {
+  lhs.swap(rhs);
+}
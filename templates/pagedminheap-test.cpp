@@ -0,0 +1,115 @@
+/**
+ * \file pagedminheap-test.cpp
+ * \copyright Matthew Calligaro
+ * \date January 2020
+ * \brief An assortment of ad hoc tests for the PagedMinHeap class
+ * \note These tests are not comprehensive and are NOT a good example of unit
+ * testing
+ */
+
+#include <cassert>
+#include <iostream>
+#include <queue>
+#include <random>
+#include <string>
+#include <vector>
+#include "pagedminheap.hpp"
+
+/**
+ * \brief Checks that a Layout is consistent for the first few thousand ranks
+ * \details Positions must increase with rank, every child must lead back to
+ * its parent, and the parent of each element must have been stored earlier.
+ */
+template <typename Layout>
+void layoutTest() {
+  const size_t RANKS = 5000;
+  assert(Layout::position(0) == Layout::ROOT);
+  for (size_t rank = 1; rank < RANKS; ++rank) {
+    size_t pos = Layout::position(rank);
+    assert(pos > Layout::position(rank - 1));
+    assert(Layout::parent(Layout::leftChild(pos)) == pos);
+    assert(Layout::parent(Layout::rightChild(pos)) == pos);
+    assert(Layout::leftChild(pos) < Layout::rightChild(pos));
+    assert(Layout::parent(pos) < pos);
+  }
+}
+
+/**
+ * \brief Compares a PagedMinHeap against std::priority_queue over random
+ * operations
+ */
+template <typename Layout>
+void randomTest() {
+  const size_t OPERATIONS = 50000;
+  std::default_random_engine engine(2020);
+  std::uniform_int_distribution<int> values(0, 1000);
+  std::uniform_int_distribution<int> choices(0, 2);
+
+  PagedMinHeap<int, Layout> heap;
+  std::priority_queue<int, std::vector<int>, std::greater<int>> expected;
+  for (size_t i = 0; i < OPERATIONS; ++i) {
+    // Grow the heap for the first half of the test and shrink it afterwards,
+    // so that array_ both doubles and halves
+    bool growing = i < OPERATIONS / 2;
+    if (expected.empty() || choices(engine) < (growing ? 2 : 1)) {
+      int value = values(engine);
+      heap.insert(value);
+      expected.push(value);
+    } else {
+      heap.deleteMin();
+      expected.pop();
+    }
+
+    assert(heap.size() == expected.size());
+    if (!expected.empty()) {
+      assert(heap.peakMin() == expected.top());
+    }
+  }
+
+  // Copies must be independent of the original
+  PagedMinHeap<int, Layout> copy = heap;
+  PagedMinHeap<int, Layout> assigned;
+  assigned = copy;
+  while (!heap.empty()) {
+    assert(copy.peakMin() == heap.peakMin());
+    heap.deleteMin();
+    copy.deleteMin();
+  }
+  assert(copy.empty() && assigned.size() == expected.size());
+}
+
+/**
+ * \brief Runs a few ad hoc tests of PagedMinHeap with a non-trivial type
+ */
+void stringTest() {
+  PagedMinHeap<std::string, BlockLayout<2>> h1;
+  assert(h1.empty());
+  for (std::string color : {"orange", "blue", "yellow", "green", "red"}) {
+    h1.insert(color);
+  }
+  assert(h1.size() == 5 && h1.peakMin() == "blue");
+
+  PagedMinHeap<std::string, BlockLayout<2>> h2;
+  swap(h1, h2);
+  assert(h1.empty() && h2.size() == 5);
+  for (std::string color : {"blue", "green", "orange", "red", "yellow"}) {
+    assert(h2.peakMin() == color);
+    h2.deleteMin();
+  }
+  assert(h2.empty());
+}
+
+int main() {
+  layoutTest<ImplicitLayout>();
+  layoutTest<BlockLayout<2>>();
+  layoutTest<BlockLayout<3>>();
+  layoutTest<BlockLayout<>>();
+  randomTest<ImplicitLayout>();
+  randomTest<BlockLayout<2>>();
+  randomTest<BlockLayout<3>>();
+  randomTest<BlockLayout<>>();
+  stringTest();
+
+  std::cout << "All tests passed" << std::endl;
+  return 0;
+}
@@ -0,0 +1,275 @@
+/**
+ * \file pagedminheap.hpp
+ * \copyright Matthew Calligaro
+ * \date January 2020
+ * \brief Declares the PagedMinHeap class and the layouts it can use
+ */
+
+#ifndef TEMPLATES_PAGEDMINHEAP_HPP_
+#define TEMPLATES_PAGEDMINHEAP_HPP_
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+
+/**
+ * \struct ImplicitLayout
+ * \brief The usual 1-indexed heap layout, where the children of position i
+ * are 2i and 2i + 1
+ * \details Each level of the tree is twice as far along the array as the one
+ * above it, so once the heap is larger than a few pages, every step of a
+ * root-to-leaf path lands on a different page of memory.
+ */
+struct ImplicitLayout {
+  /** \brief The number of slots kept together, which is one pair of siblings */
+  static constexpr size_t BLOCK_SLOTS = 2;
+
+  /** \brief The position of the root */
+  static constexpr size_t ROOT = 1;
+
+  /**
+   * \brief Returns the position of the element with a given rank
+   * \param rank    The number of elements stored before this one
+   * \return The position in the array of the element
+   * \note Run time: constant
+   */
+  static constexpr size_t position(size_t rank);
+
+  /**
+   * \brief Returns the position of the parent of a position
+   * \param pos   A position other than ROOT
+   * \return The position of the parent of pos
+   * \note Run time: constant
+   */
+  static constexpr size_t parent(size_t pos);
+
+  /**
+   * \brief Returns the position of the left child of a position
+   * \param pos   A position in the heap
+   * \return The position of the left child of pos
+   * \note Run time: constant
+   */
+  static constexpr size_t leftChild(size_t pos);
+
+  /**
+   * \brief Returns the position of the right child of a position
+   * \param pos   A position in the heap
+   * \return The position of the right child of pos
+   * \note Run time: constant
+   */
+  static constexpr size_t rightChild(size_t pos);
+};
+
+/**
+ * \struct BlockLayout
+ * \brief A B-heap layout, which stores the tree in blocks of 2^LEVELS slots
+ * so that a root-to-leaf path rarely changes blocks
+ * \details The first block holds the top LEVELS levels of the tree.  Every
+ * other block holds a pair of sibling subtrees of LEVELS - 1 levels, whose
+ * parent is a leaf of an earlier block, and leaves its first two slots empty.
+ * Within a block, the subtrees use the usual 1-indexed layout, and blocks are
+ * filled one after another.  A root-to-leaf path therefore only moves to a
+ * new block once every LEVELS - 1 levels, rather than touching new memory on
+ * nearly every level.  Choosing LEVELS so that a block is one cache line or
+ * one page of memory means deleteMin touches far fewer cache lines or pages.
+ * \note The default of 9 levels makes a block of 512 slots, which fills one
+ * 4 KiB page with 8-byte elements
+ */
+template <size_t LEVELS = 9>
+struct BlockLayout {
+  static_assert(LEVELS >= 2, "A block must hold at least two levels");
+
+  /** \brief The number of slots (including the empty slots) in a block */
+  static constexpr size_t BLOCK_SLOTS = size_t{1} << LEVELS;
+
+  /** \brief The position of the root */
+  static constexpr size_t ROOT = 1;
+
+  /**
+   * \brief Returns the position of the element with a given rank
+   * \param rank    The number of elements stored before this one
+   * \return The position in the array of the element
+   * \note Run time: constant
+   */
+  static constexpr size_t position(size_t rank);
+
+  /**
+   * \brief Returns the position of the parent of a position
+   * \param pos   A position other than ROOT
+   * \return The position of the parent of pos
+   * \note Run time: constant
+   */
+  static constexpr size_t parent(size_t pos);
+
+  /**
+   * \brief Returns the position of the left child of a position
+   * \param pos   A position in the heap
+   * \return The position of the left child of pos
+   * \note Run time: constant
+   */
+  static constexpr size_t leftChild(size_t pos);
+
+  /**
+   * \brief Returns the position of the right child of a position
+   * \param pos   A position in the heap
+   * \return The position of the right child of pos
+   * \note Run time: constant
+   */
+  static constexpr size_t rightChild(size_t pos);
+};
+
+/**
+ * \class PagedMinHeap
+ * \brief A templated binary min heap which stores its elements by value, in
+ * the order given by a Layout
+ * \details MinHeap stores a pointer to each element, so every comparison
+ * follows a pointer to wherever that element was allocated.  For very large
+ * heaps, PagedMinHeap stores the elements themselves in the array, and lets
+ * the Layout decide where each element of the tree goes.  A Layout must fill
+ * the array in increasing order of position, so the element with the
+ * largest position is always the last element, and a position is in use
+ * exactly when it is less than position(size()).  The default
+ * ImplicitLayout matches MinHeap, and BlockLayout is an optional B-heap
+ * layout for heaps much larger than the cache.
+ * \note The template type T must support the default constructor, copy
+ * assignment, and operator<
+ * \note PagedMinHeap does not provide iterators, since the array may contain
+ * empty slots between the elements
+ */
+template <typename T, typename Layout = ImplicitLayout>
+class PagedMinHeap {
+ public:
+  // STL container type definitions
+  using value_type = T;
+  using size_type = size_t;
+  using reference = value_type&;
+  using const_reference = const value_type&;
+
+  /**
+   * \brief Creates an empty PagedMinHeap
+   * \note Run time: constant
+   */
+  PagedMinHeap();
+
+  /**
+   * \brief Creates a PagedMinHeap containing a copy of the contents of other
+   * \param other   The PagedMinHeap to be copied
+   * \note Run time: linear in the size of other
+   */
+  PagedMinHeap(const PagedMinHeap& other);
+
+  /**
+   * \brief Replaces current contents with a copy of the contents of other
+   * \param other   The PagedMinHeap to be copied
+   * \note Run time: linear in the size of other
+   */
+  PagedMinHeap& operator=(const PagedMinHeap& other);
+
+  /**
+   * \brief Frees all memory associated with the PagedMinHeap
+   * \note Run time: linear in the size of the PagedMinHeap
+   */
+  ~PagedMinHeap();
+
+  /**
+   * \brief Exchanges the contents of the PagedMinHeap with other
+   * \param other   The PagedMinHeap with which to exchange contents
+   * \note Run time: constant
+   */
+  void swap(PagedMinHeap& other);
+
+  /**
+   * \brief Returns the number of elements in the PagedMinHeap
+   * \return The number of elements in the PagedMinHeap
+   * \note Run time: constant
+   */
+  size_type size() const;
+
+  /**
+   * \brief Returns whether the PagedMinHeap is empty
+   * \return True if the size of the PagedMinHeap is 0
+   * \note Run time: constant
+   */
+  bool empty() const;
+
+  /**
+   * \brief Returns a reference to the smallest element of the PagedMinHeap
+   * \return A reference to the smallest element of the PagedMinHeap
+   * \note Run time: constant
+   * \warning Behavior is undefined if the PagedMinHeap is empty
+   */
+  const_reference peakMin() const;
+
+  /**
+   * \brief Adds a new value to the PagedMinHeap
+   * \param val   The value to insert into the PagedMinHeap
+   * \note Run time: amortized logarithmic in the size of the PagedMinHeap
+   */
+  void insert(const_reference val);
+
+  /**
+   * \brief Removes the smallest value from the PagedMinHeap
+   * \note Run time: amortized logarithmic in the size of the PagedMinHeap
+   * \warning Behavior is undefined if the PagedMinHeap is empty
+   */
+  void deleteMin();
+
+ private:
+  /** \brief The number of slots in array_ */
+  size_t arraySize_;
+
+  /** \brief The number of elements in the PagedMinHeap */
+  size_t size_;
+
+  /** \brief The elements, at the positions given by Layout */
+  T* array_;
+
+  /** \brief The number of bytes in one block of the Layout */
+  static constexpr size_t BLOCK_BYTES = Layout::BLOCK_SLOTS * sizeof(T);
+
+  /**
+   * \brief The alignment of array_
+   * \details A block only fits in one cache line or page if it also starts at
+   * the beginning of one, so we align array_ to the size of a block, up to
+   * the size of a page
+   */
+  static constexpr size_t ALIGNMENT =
+      std::max(alignof(T), std::min(size_t{4096}, std::bit_floor(BLOCK_BYTES)));
+
+  /**
+   * \brief Allocates an array aligned to ALIGNMENT and default-constructs its
+   * slots
+   * \param slots   The number of slots in the array
+   * \return A pointer to the first slot of the array
+   * \note Run time: linear in slots
+   */
+  static T* allocate(size_t slots);
+
+  /**
+   * \brief Destroys and frees an array created by allocate
+   * \param array   The array to free
+   * \param slots   The number of slots in the array
+   * \note Run time: linear in slots
+   */
+  static void deallocate(T* array, size_t slots);
+
+  /**
+   * \brief Either double or halve the size of array_
+   * \param upsize  If true, double array_, if false, halve array_
+   * \note Run time: linear in the size of the PagedMinHeap
+   */
+  void resize(bool upsize);
+};
+
+/**
+ * \brief Exchanges the contents of two PagedMinHeaps
+ * \param lhs   The first PagedMinHeap
+ * \param rhs   The second PagedMinHeap
+ * \note Run time: constant
+ */
+template <typename T, typename Layout>
+void swap(PagedMinHeap<T, Layout>& lhs, PagedMinHeap<T, Layout>& rhs);
+
+#include "pagedminheap-private.hpp"
+
+#endif  // TEMPLATES_PAGEDMINHEAP_HPP_
@@ -0,0 +1,162 @@
+/**
+ * \file persistentheap-private.hpp
+ * \copyright Matthew Calligaro
+ * \date January 2020
+ * \brief Provides the template implementation for the PersistentHeap class
+ */
+
+// NOLINT(build/header_guard)
+
+#include <atomic>
+#include <utility>
+
+template <typename T>
+PersistentHeap<T>::PersistentHeap() : root_{nullptr}, size_{0} {
+  // Nothing else to do
+}
+
+template <typename T>
+PersistentHeap<T>::PersistentHeap(const PersistentHeap& other)
+    : root_{retain(other.root_)}, size_{other.size_} {
+  // Nothing else to do
+}
+
+template <typename T>
+PersistentHeap<T>& PersistentHeap<T>::operator=(const PersistentHeap& other) {
+  // Retaining before releasing makes self-assignment safe
+  Node* old = root_;
+  root_ = retain(other.root_);
+  size_ = other.size_;
+  release(old);
+  return *this;
+}
+
+template <typename T>
+PersistentHeap<T>::~PersistentHeap() {
+  release(root_);
+}
+
+template <typename T>
+void PersistentHeap<T>::swap(PersistentHeap& other) {
+  std::swap(root_, other.root_);
+  std::swap(size_, other.size_);
+}
+
+template <typename T>
+size_t PersistentHeap<T>::size() const {
+  return size_;
+}
+
+template <typename T>
+bool PersistentHeap<T>::empty() const {
+  return size_ == 0;
+}
+
+template <typename T>
+const T& PersistentHeap<T>::peakMin() const {
+  return root_->value;
+}
+
+template <typename T>
+void PersistentHeap<T>::insert(const T& val) {
+  // A new element is a tree of one node, melded with the rest
+  Node* single = new Node(val, 1, nullptr, nullptr);
+  Node* melded = meld(root_, single);
+  release(single);
+  release(root_);
+  root_ = melded;
+  ++size_;
+}
+
+template <typename T>
+void PersistentHeap<T>::deleteMin() {
+  // The old root is only freed if no copy still uses it
+  Node* melded = meld(root_->left, root_->right);
+  release(root_);
+  root_ = melded;
+  --size_;
+}
+
+template <typename T>
+void PersistentHeap<T>::merge(const PersistentHeap& other) {
+  Node* melded = meld(root_, other.root_);
+  release(root_);
+  root_ = melded;
+  size_ += other.size_;
+}
+
+template <typename T>
+size_t PersistentHeap<T>::rankOf(const Node* node) {
+  return node == nullptr ? 0 : node->rank;
+}
+
+template <typename T>
+typename PersistentHeap<T>::Node* PersistentHeap<T>::retain(Node* node) {
+  // A new reference is always copied from an existing one, which keeps the
+  // node alive, so there is nothing to order here
+  if (node != nullptr) {
+    node->references.fetch_add(1, std::memory_order_relaxed);
+  }
+  return node;
+}
+
+template <typename T>
+void PersistentHeap<T>::release(Node* node) {
+  // The thread which removes the last reference frees the node, and acq_rel
+  // makes sure every other thread has finished reading it by then.
+  //
+  // Freeing a node releases its children.  Recursing on both would nest one
+  // call per node down the left-hand side, which can be as long as the whole
+  // heap, so we loop down the left and only recurse on the right.  No path
+  // has more than log(n + 1) right-hand steps, so neither does the recursion.
+  while (node != nullptr &&
+         node->references.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+    release(node->right);
+    Node* left = node->left;
+    delete node;
+    node = left;
+  }
+}
+
+template <typename T>
+typename PersistentHeap<T>::Node* PersistentHeap<T>::meld(Node* lhs,
+                                                          Node* rhs) {
+  if (lhs == nullptr) {
+    return retain(rhs);
+  }
+  if (rhs == nullptr) {
+    return retain(lhs);
+  }
+
+  // The smaller root becomes the new root, and the other tree is melded
+  // into its right-hand side.  Each step goes down a right-hand path, so
+  // there are only logarithmically many.
+  if (rhs->value < lhs->value) {
+    std::swap(lhs, rhs);
+  }
+  Node* left = retain(lhs->left);
+  Node* right = meld(lhs->right, rhs);
+
+  // Keep the shorter right-hand path on the right
+  if (rankOf(left) < rankOf(right)) {
+    std::swap(left, right);
+  }
+  try {
+    return new Node(lhs->value, rankOf(right) + 1, left, right);
+  } catch (...) {
+    release(left);
+    release(right);
+    throw;
+  }
+}
+
+template <typename T>
+PersistentHeap<T>::Node::Node(const T& val, size_t rank, Node* lhs, Node* rhs)
+    : value{val}, rank{rank}, left{lhs}, right{rhs}, references{1} {
+  // Nothing else to do
+}
+
+template <typename T>
+void swap(PersistentHeap<T>& lhs, PersistentHeap<T>& rhs) {
+  lhs.swap(rhs);
+}
@@ -0,0 +1,128 @@
+/**
+ * \file persistentheap-test.cpp
+ * \copyright Matthew Calligaro
+ * \date January 2020
+ * \brief An assortment of ad hoc tests for the PersistentHeap class
+ * \note These tests are not comprehensive and are NOT a good example of unit
+ * testing
+ */
+
+#include <algorithm>
+#include <cassert>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <thread>
+#include <vector>
+#include "persistentheap.hpp"
+
+/**
+ * \brief Removes every element of a PersistentHeap, in order
+ * \param heap  The PersistentHeap, which is copied so that it is unchanged
+ * \return The elements, smallest first
+ */
+std::vector<int> drain(PersistentHeap<int> heap) {
+  std::vector<int> values;
+  while (!heap.empty()) {
+    values.push_back(heap.peakMin());
+    heap.deleteMin();
+  }
+  return values;
+}
+
+/**
+ * \brief Checks that elements come out in order
+ */
+void orderTest() {
+  std::vector<int> values(1000);
+  std::iota(values.begin(), values.end(), 0);
+  std::shuffle(values.begin(), values.end(), std::mt19937(43));
+
+  PersistentHeap<int> heap;
+  assert(heap.empty());
+  for (int value : values) {
+    heap.insert(value);
+  }
+  assert(heap.size() == values.size() && heap.peakMin() == 0);
+  std::sort(values.begin(), values.end());
+  assert(drain(heap) == values);
+}
+
+/**
+ * \brief Checks that snapshots keep their contents while the original
+ * changes, and that merge leaves its argument alone
+ */
+void snapshotTest() {
+  PersistentHeap<int> heap;
+  for (int value : {5, 1, 4}) {
+    heap.insert(value);
+  }
+  PersistentHeap<int> before = heap;
+  heap.deleteMin();
+  heap.insert(0);
+  heap.insert(9);
+  assert((drain(before) == std::vector<int>{1, 4, 5}));
+  assert((drain(heap) == std::vector<int>{0, 4, 5, 9}));
+
+  PersistentHeap<int> other;
+  other.insert(3);
+  other.insert(2);
+  heap.merge(other);
+  assert((drain(heap) == std::vector<int>{0, 2, 3, 4, 5, 9}));
+  assert((drain(other) == std::vector<int>{2, 3}));
+
+  using std::swap;
+  swap(heap, other);
+  assert(heap.size() == 2 && other.size() == 6);
+}
+
+/**
+ * \brief Checks that a very long left-hand path is freed without
+ * overflowing the stack
+ */
+void deepTreeTest() {
+  // Inserting in decreasing order puts each new element at the root, with
+  // the old tree as its left child
+  PersistentHeap<int> heap;
+  for (int value = 1000000; value > 0; --value) {
+    heap.insert(value);
+  }
+  assert(heap.size() == 1000000 && heap.peakMin() == 1);
+}
+
+/**
+ * \brief Has other threads read snapshots while the original keeps changing
+ */
+void threadTest() {
+  PersistentHeap<int> heap;
+  for (int value = 0; value < 1000; ++value) {
+    heap.insert(value);
+  }
+
+  std::vector<std::thread> readers;
+  for (int round = 0; round < 8; ++round) {
+    readers.emplace_back([snapshot = heap] {
+      std::vector<int> values = drain(snapshot);
+      assert(values.size() == 1000);
+      assert(std::is_sorted(values.begin(), values.end()));
+    });
+    for (int i = 0; i < 100; ++i) {
+      int min = heap.peakMin();
+      heap.deleteMin();
+      heap.insert(min + 1000);
+    }
+  }
+  for (std::thread& reader : readers) {
+    reader.join();
+  }
+}
+
+int main() {
+  orderTest();
+  snapshotTest();
+  deepTreeTest();
+  threadTest();
+
+  std::cout << "All tests passed" << std::endl;
+  return 0;
+}
@@ -0,0 +1,215 @@
+/**
+ * \file persistentheap.hpp
+ * \copyright Matthew Calligaro
+ * \date January 2020
+ * \brief Declares the PersistentHeap class
+ */
+
+#ifndef TEMPLATES_PERSISTENTHEAP_HPP_
+#define TEMPLATES_PERSISTENTHEAP_HPP_
+
+#include <atomic>
+#include <cstddef>
+
+/**
+ * \class PersistentHeap
+ * \brief A min heap whose copies share their elements, so that copying one
+ * takes constant time
+ * \details Copying a MinHeap copies every element, which is far too slow for
+ * taking frequent snapshots of a large queue.  A PersistentHeap is a leftist
+ * heap: a binary tree in which every node is no larger than its children,
+ * and the path down the right-hand side is never longer than the path down
+ * the left-hand side, so it has at most log(n + 1) nodes.
+ *
+ * Nodes are never changed once they are made.  Instead, insert and
+ * deleteMin build new nodes along a right-hand path, which is O(log(n)) new
+ * nodes, and point them at the untouched subtrees of the old version.  A
+ * copy of the PersistentHeap is just another pointer to the root, and it
+ * keeps seeing exactly the elements it had when it was made, however the
+ * original changes afterwards.  Each node counts the versions and parent
+ * nodes which point to it, and is freed when the last of them goes away.
+ *
+ * A leftist heap rather than a skew heap, since a skew heap is only fast on
+ * average over a sequence of operations, and repeating an expensive
+ * operation on an old version breaks that average.
+ * \note Different PersistentHeaps which share nodes may be used from
+ * different threads at once, since the nodes never change and their
+ * reference counts are atomic.  A single PersistentHeap object is no safer
+ * to share between threads than any other container.
+ * \note The template type T must support the copy constructor and operator<
+ */
+template <typename T>
+class PersistentHeap {
+ public:
+  // STL container type definitions
+  using value_type = T;
+  using size_type = size_t;
+  using const_reference = const value_type&;
+
+  /**
+   * \brief Creates an empty PersistentHeap
+   * \note Run time: constant
+   */
+  PersistentHeap();
+
+  /**
+   * \brief Creates a PersistentHeap with the same elements as other, which
+   * shares all of its nodes
+   * \param other   The PersistentHeap to copy
+   * \note Run time: constant
+   */
+  PersistentHeap(const PersistentHeap& other);
+
+  /**
+   * \brief Replaces the elements with those of other, sharing its nodes
+   * \param other   The PersistentHeap to copy
+   * \return A reference to this PersistentHeap
+   * \note Run time: constant, plus the time to free any nodes which only
+   * this PersistentHeap was using
+   */
+  PersistentHeap& operator=(const PersistentHeap& other);
+
+  /**
+   * \brief Destroys the PersistentHeap, freeing any nodes which no other
+   * version uses
+   * \note Run time: linear in the number of nodes freed
+   */
+  ~PersistentHeap();
+
+  /**
+   * \brief Exchanges the contents of the PersistentHeap with other
+   * \param other   The PersistentHeap with which to exchange contents
+   * \note Run time: constant
+   */
+  void swap(PersistentHeap& other);
+
+  /**
+   * \brief Returns the number of elements in the PersistentHeap
+   * \return The number of elements in the PersistentHeap
+   * \note Run time: constant
+   */
+  size_type size() const;
+
+  /**
+   * \brief Returns whether the PersistentHeap is empty
+   * \return True if the size of the PersistentHeap is 0
+   * \note Run time: constant
+   */
+  bool empty() const;
+
+  /**
+   * \brief Returns the smallest value in the PersistentHeap
+   * \return A reference to the smallest value, which stays valid for as long
+   * as any copy containing it exists
+   * \note Run time: constant
+   * \warning Behavior is undefined if the PersistentHeap is empty
+   */
+  const_reference peakMin() const;
+
+  /**
+   * \brief Adds a new value, without changing any copies
+   * \param val   The value to insert
+   * \note Run time: logarithmic in the size of the PersistentHeap, with that
+   * many new nodes
+   */
+  void insert(const_reference val);
+
+  /**
+   * \brief Removes the smallest value, without changing any copies
+   * \note Run time: logarithmic in the size of the PersistentHeap, with that
+   * many new nodes
+   * \warning Behavior is undefined if the PersistentHeap is empty
+   */
+  void deleteMin();
+
+  /**
+   * \brief Adds every value of another PersistentHeap, which is unchanged
+   * \param other   The PersistentHeap whose values to add
+   * \note Run time: logarithmic in the combined size of the PersistentHeaps
+   */
+  void merge(const PersistentHeap& other);
+
+ private:
+  /**
+   * \struct Node
+   * \brief One element of the tree, which never changes once it is made
+   */
+  struct Node {
+    /** \brief The element */
+    T value;
+
+    /** \brief The number of nodes on the path down the right-hand side */
+    size_t rank;
+
+    Node* left;
+    Node* right;
+
+    /** \brief The number of PersistentHeaps and Nodes pointing to this Node */
+    std::atomic<size_t> references;
+
+    /**
+     * \brief Creates a Node with one reference
+     * \param val     The element
+     * \param rank    The number of nodes on the path down the right-hand side
+     * \param lhs     The left child, or nullptr, whose reference the Node
+     * takes over
+     * \param rhs     The right child, or nullptr, whose reference the Node
+     * takes over
+     */
+    Node(const T& val, size_t rank, Node* lhs, Node* rhs);
+  };
+
+  /** \brief The root of the tree, or nullptr if the heap is empty */
+  Node* root_;
+
+  /** \brief The number of elements */
+  size_t size_;
+
+  /**
+   * \brief Returns the rank of a subtree
+   * \param node  The root of the subtree, or nullptr
+   * \return The rank of node, or 0 if node is nullptr
+   * \note Run time: constant
+   */
+  static size_t rankOf(const Node* node);
+
+  /**
+   * \brief Adds a reference to a node
+   * \param node  The node, or nullptr
+   * \return node
+   * \note Run time: constant
+   */
+  static Node* retain(Node* node);
+
+  /**
+   * \brief Removes a reference to a node, freeing it and releasing its
+   * children if it was the last one
+   * \param node  The node, or nullptr
+   * \note Run time: linear in the number of nodes freed
+   */
+  static void release(Node* node);
+
+  /**
+   * \brief Combines two trees, copying the nodes along their right-hand
+   * paths and sharing the rest
+   * \param lhs   The root of one tree, or nullptr
+   * \param rhs   The root of the other tree, or nullptr
+   * \return The root of the combined tree, with a reference which the
+   * caller must release
+   * \note Run time: logarithmic in the combined size of the trees
+   */
+  static Node* meld(Node* lhs, Node* rhs);
+};
+
+/**
+ * \brief Exchanges the contents of two PersistentHeaps
+ * \param lhs   A PersistentHeap
+ * \param rhs   Another PersistentHeap
+ * \note Run time: constant
+ */
+template <typename T>
+void swap(PersistentHeap<T>& lhs, PersistentHeap<T>& rhs);
+
+#include "persistentheap-private.hpp"
+
+#endif  // TEMPLATES_PERSISTENTHEAP_HPP_
@@ -0,0 +1,219 @@
+/**
+ * \file prioritychannel-private.hpp
+ * \copyright Matthew Calligaro
+ * \date January 2020
+ * \brief Provides the implementation for the PriorityChannel class and the
+ * coroutine executors
+ */
+
+// NOLINT(build/header_guard)
+
+#include <exception>
+#include <utility>
+
+// The executors and Task are not templates, so their definitions are marked
+// inline to let every file which includes this header have a copy
+
+inline Task Task::promise_type::get_return_object() {
+  return Task(std::coroutine_handle<promise_type>::from_promise(*this));
+}
+
+inline std::suspend_always Task::promise_type::initial_suspend() noexcept {
+  return {};
+}
+
+inline std::suspend_never Task::promise_type::final_suspend() noexcept {
+  return {};
+}
+
+inline void Task::promise_type::return_void() {}
+
+inline void Task::promise_type::unhandled_exception() { std::terminate(); }
+
+inline Task::Task(std::coroutine_handle<promise_type> handle)
+    : handle_(handle) {}
+
+inline Task::Task(Task&& other) noexcept
+    : handle_(std::exchange(other.handle_, nullptr)) {}
+
+inline Task::~Task() {
+  if (handle_) {
+    handle_.destroy();
+  }
+}
+
+inline void spawn(Executor& executor, Task task) {
+  executor.schedule(std::exchange(task.handle_, nullptr));
+}
+
+inline void SingleThreadExecutor::schedule(std::coroutine_handle<> handle) {
+  ready_.push_back(handle);
+}
+
+inline size_t SingleThreadExecutor::run() {
+  size_t resumed = 0;
+  while (!ready_.empty()) {
+    std::coroutine_handle<> handle = ready_.front();
+    ready_.pop_front();
+    handle.resume();
+    ++resumed;
+  }
+  return resumed;
+}
+
+inline ThreadPoolExecutor::ThreadPoolExecutor(size_t threads)
+    : pool_(threads) {}
+
+inline void ThreadPoolExecutor::schedule(std::coroutine_handle<> handle) {
+  // Every coroutine has the same priority, so the pool runs them in the
+  // order they were scheduled.  Nobody waits for the future.
+  pool_.submit(0, [handle] { handle.resume(); });
+}
+
+inline void ThreadPoolExecutor::shutdown() { pool_.shutdown(); }
+
+template <typename T>
+PriorityChannel<T>::SendAwaiter::SendAwaiter(PriorityChannel& channel, T item)
+    : channel_(channel), item_(std::move(item)) {}
+
+template <typename T>
+bool PriorityChannel<T>::SendAwaiter::await_ready() const noexcept {
+  // Deciding needs the lock, which await_suspend takes
+  return false;
+}
+
+template <typename T>
+bool PriorityChannel<T>::SendAwaiter::await_suspend(
+    std::coroutine_handle<> handle) {
+  std::coroutine_handle<> wake;
+  {
+    std::lock_guard<std::mutex> lock(channel_.mutex_);
+    if (channel_.closed_) {
+      result_ = false;
+      return false;
+    }
+    if (!channel_.receivers_.empty()) {
+      // A consumer only waits while the heap is empty, so this item is the
+      // smallest available and can skip the heap
+      ReceiveAwaiter* receiver = channel_.receivers_.front();
+      channel_.receivers_.pop_front();
+      receiver->result_ = std::move(item_);
+      wake = receiver->handle_;
+    } else if (channel_.heap_.size() < channel_.capacity_) {
+      channel_.heap_.insert(item_);
+      result_ = true;
+      return false;
+    } else {
+      // Once we are in senders_, a consumer may resume us on another thread
+      // as soon as we unlock, so handle_ must be set first
+      handle_ = handle;
+      channel_.senders_.push_back(this);
+      return true;
+    }
+  }
+  result_ = true;
+  channel_.executor_.schedule(wake);
+  return false;
+}
+
+template <typename T>
+bool PriorityChannel<T>::SendAwaiter::await_resume() const noexcept {
+  return result_;
+}
+
+template <typename T>
+PriorityChannel<T>::ReceiveAwaiter::ReceiveAwaiter(PriorityChannel& channel)
+    : channel_(channel) {}
+
+template <typename T>
+bool PriorityChannel<T>::ReceiveAwaiter::await_ready() const noexcept {
+  return false;
+}
+
+template <typename T>
+bool PriorityChannel<T>::ReceiveAwaiter::await_suspend(
+    std::coroutine_handle<> handle) {
+  std::coroutine_handle<> wake;
+  {
+    std::lock_guard<std::mutex> lock(channel_.mutex_);
+    if (channel_.heap_.empty()) {
+      if (channel_.closed_) {
+        return false;
+      }
+      handle_ = handle;
+      channel_.receivers_.push_back(this);
+      return true;
+    }
+    result_ = channel_.heap_.peakMin();
+    channel_.heap_.deleteMin();
+
+    // We made room, so the producer which has waited longest gets it
+    if (!channel_.senders_.empty()) {
+      SendAwaiter* sender = channel_.senders_.front();
+      channel_.senders_.pop_front();
+      channel_.heap_.insert(sender->item_);
+      sender->result_ = true;
+      wake = sender->handle_;
+    }
+  }
+  if (wake) {
+    channel_.executor_.schedule(wake);
+  }
+  return false;
+}
+
+template <typename T>
+std::optional<T> PriorityChannel<T>::ReceiveAwaiter::await_resume() {
+  return std::move(result_);
+}
+
+template <typename T>
+PriorityChannel<T>::PriorityChannel(Executor& executor, size_t capacity)
+    : executor_(executor), capacity_(capacity) {}
+
+template <typename T>
+typename PriorityChannel<T>::SendAwaiter PriorityChannel<T>::send(T item) {
+  return SendAwaiter(*this, std::move(item));
+}
+
+template <typename T>
+typename PriorityChannel<T>::ReceiveAwaiter PriorityChannel<T>::receive() {
+  return ReceiveAwaiter(*this);
+}
+
+template <typename T>
+void PriorityChannel<T>::close() {
+  // Once the first waiter resumes, its thread may finish with the channel
+  // and destroy it, so nothing below may touch a member
+  Executor& executor = executor_;
+  std::deque<SendAwaiter*> senders;
+  std::deque<ReceiveAwaiter*> receivers;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    closed_ = true;
+    senders.swap(senders_);
+    receivers.swap(receivers_);
+  }
+
+  // A waiting producer's item never made it in, and a waiting consumer
+  // means the heap was empty, so both give up.  Their results already say
+  // so: SendAwaiter::result_ is still false and ReceiveAwaiter::result_ is
+  // still empty.
+  for (SendAwaiter* sender : senders) {
+    executor.schedule(sender->handle_);
+  }
+  for (ReceiveAwaiter* receiver : receivers) {
+    executor.schedule(receiver->handle_);
+  }
+}
+
+template <typename T>
+size_t PriorityChannel<T>::size() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return heap_.size();
+}
+
+template <typename T>
+size_t PriorityChannel<T>::capacity() const {
+  return capacity_;
+}
@@ -0,0 +1,233 @@
+/**
+ * \file prioritychannel-test.cpp
+ * \copyright Matthew Calligaro
+ * \date January 2020
+ * \brief An assortment of ad hoc tests for the PriorityChannel class and the
+ * coroutine executors
+ * \note These tests are not comprehensive and are NOT a good example of unit
+ * testing
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <iostream>
+#include <latch>
+#include <mutex>
+#include <optional>
+#include <vector>
+#include "prioritychannel.hpp"
+
+/**
+ * \brief Sends values into a channel
+ * \param channel   The channel
+ * \param values    The values to send
+ * \param sent      Counts the sends which have finished
+ */
+Task produce(PriorityChannel<int>& channel, std::vector<int> values,
+             size_t& sent) {
+  for (int value : values) {
+    bool accepted = co_await channel.send(value);
+    assert(accepted);
+    ++sent;
+  }
+}
+
+/**
+ * \brief Receives values from a channel until it is closed and empty
+ * \param channel   The channel
+ * \param received  Where to put the values
+ */
+Task consume(PriorityChannel<int>& channel, std::vector<int>& received) {
+  while (std::optional<int> value = co_await channel.receive()) {
+    received.push_back(*value);
+  }
+}
+
+/**
+ * \brief Checks the order of the items and the backpressure on one thread
+ */
+void orderTest() {
+  SingleThreadExecutor executor;
+  PriorityChannel<int> channel(executor, 4);
+  assert(channel.capacity() == 4);
+
+  // The producer fills the channel and then has to wait
+  size_t sent = 0;
+  spawn(executor, produce(channel, {5, 3, 8, 1, 9, 7, 2}, sent));
+  executor.run();
+  assert(sent == 4);
+  assert(channel.size() == 4);
+
+  // The first receive lets 9 into the heap and wakes the producer, but the
+  // consumer drains the heap before the producer runs again.  Then 7 goes
+  // straight to the waiting consumer, and 2 waits in the heap for it.
+  std::vector<int> received;
+  spawn(executor, consume(channel, received));
+  executor.run();
+  assert(sent == 7);
+  assert(channel.size() == 0);
+  assert(received == std::vector<int>({1, 3, 5, 8, 9, 7, 2}));
+
+  // The consumer is waiting, so the next item goes straight to it
+  spawn(executor, produce(channel, {4}, sent));
+  executor.run();
+  assert(received.back() == 4);
+  assert(channel.size() == 0);
+
+  channel.close();
+  executor.run();
+}
+
+/**
+ * \brief Sends once into a channel
+ * \param channel   The channel
+ * \param value     The value to send
+ * \param result    Where to put what send gave
+ */
+Task sendOne(PriorityChannel<int>& channel, int value,
+             std::optional<bool>& result) {
+  result = co_await channel.send(value);
+}
+
+/**
+ * \brief Receives once from a channel
+ * \param channel   The channel
+ * \param result    Where to put what receive gave
+ * \param finished  Set once receive has finished
+ */
+Task receiveOne(PriorityChannel<int>& channel, std::optional<int>& result,
+                bool& finished) {
+  result = co_await channel.receive();
+  finished = true;
+}
+
+/**
+ * \brief Checks that closing wakes waiting coroutines and ends the stream
+ */
+void closeTest() {
+  SingleThreadExecutor executor;
+  PriorityChannel<int> channel(executor, 1);
+
+  std::optional<bool> first;
+  std::optional<bool> second;
+  spawn(executor, sendOne(channel, 1, first));
+  spawn(executor, sendOne(channel, 2, second));
+  executor.run();
+  assert(first == true);
+  assert(!second.has_value());
+
+  // The waiting sender gives up, but the item already in the channel can
+  // still be received
+  channel.close();
+  executor.run();
+  assert(second == false);
+
+  std::optional<int> value;
+  bool finished = false;
+  spawn(executor, receiveOne(channel, value, finished));
+  executor.run();
+  assert(finished && value == 1);
+  spawn(executor, receiveOne(channel, value, finished));
+  executor.run();
+  assert(!value.has_value());
+
+  std::optional<bool> late;
+  spawn(executor, sendOne(channel, 3, late));
+  executor.run();
+  assert(late == false);
+
+  // A consumer which is waiting when the channel closes gets nothing
+  PriorityChannel<int> empty(executor, 1);
+  finished = false;
+  spawn(executor, receiveOne(empty, value, finished));
+  executor.run();
+  assert(!finished);
+  empty.close();
+  executor.run();
+  assert(finished && !value.has_value());
+
+  // A Task which is never spawned is destroyed without running
+  { Task unused = sendOne(channel, 4, late); }
+}
+
+/**
+ * \brief Sends values from one of several producers on a thread pool
+ * \param channel     The channel
+ * \param first       The first value to send
+ * \param count       The number of values
+ * \param producers   Counts the producers still running; the last closes
+ * the channel
+ */
+Task producePool(PriorityChannel<int>& channel, int first, int count,
+                 std::atomic<int>& producers) {
+  for (int value = first; value < first + count; ++value) {
+    bool accepted = co_await channel.send(value);
+    assert(accepted);
+  }
+  if (--producers == 0) {
+    channel.close();
+  }
+}
+
+/**
+ * \brief Receives values as one of several consumers on a thread pool
+ * \param channel   The channel
+ * \param received  Where to put the values
+ * \param mutex     Guards received
+ * \param done      Counted down once the channel is closed and empty
+ */
+Task consumePool(PriorityChannel<int>& channel, std::vector<int>& received,
+                 std::mutex& mutex, std::latch& done) {
+  std::vector<int> mine;
+  while (std::optional<int> value = co_await channel.receive()) {
+    mine.push_back(*value);
+  }
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    received.insert(received.end(), mine.begin(), mine.end());
+  }
+  done.count_down();
+}
+
+/**
+ * \brief Runs several producers and consumers on a thread pool, and checks
+ * that every value arrives exactly once
+ */
+void threadTest() {
+  const int PRODUCERS = 4;
+  const int CONSUMERS = 3;
+  const int PER_PRODUCER = 2000;
+
+  ThreadPoolExecutor executor(4);
+  PriorityChannel<int> channel(executor, 16);
+  std::atomic<int> producers = PRODUCERS;
+  std::vector<int> received;
+  std::mutex mutex;
+  std::latch done(CONSUMERS);
+
+  for (int consumer = 0; consumer < CONSUMERS; ++consumer) {
+    spawn(executor, consumePool(channel, received, mutex, done));
+  }
+  for (int producer = 0; producer < PRODUCERS; ++producer) {
+    spawn(executor, producePool(channel, producer * PER_PRODUCER,
+                                PER_PRODUCER, producers));
+  }
+  done.wait();
+  executor.shutdown();
+
+  std::sort(received.begin(), received.end());
+  assert(received.size() == PRODUCERS * PER_PRODUCER);
+  for (int i = 0; i < PRODUCERS * PER_PRODUCER; ++i) {
+    assert(received[i] == i);
+  }
+}
+
+int main() {
+  orderTest();
+  closeTest();
+  threadTest();
+
+  std::cout << "All tests passed" << std::endl;
+  return 0;
+}
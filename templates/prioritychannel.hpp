@@ -0,0 +1,274 @@
+/**
+ * \file prioritychannel.hpp
+ * \copyright Matthew Calligaro
+ * \date January 2020
+ * \brief Declares the PriorityChannel class, and the coroutine executors
+ * which run the coroutines that use it
+ */
+
+#ifndef TEMPLATES_PRIORITYCHANNEL_HPP_
+#define TEMPLATES_PRIORITYCHANNEL_HPP_
+
+#include <coroutine>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <optional>
+
+#include "minheap.hpp"
+#include "prioritythreadpool.hpp"
+
+/**
+ * \class Executor
+ * \brief Decides where and when suspended coroutines resume
+ * \details A PriorityChannel never resumes a coroutine itself, since that
+ * would run the coroutine inside send or receive, possibly on the wrong
+ * thread and with the channel's lock held.  It hands the coroutine to an
+ * Executor instead.
+ */
+class Executor {
+ public:
+  virtual ~Executor() = default;
+
+  /**
+   * \brief Arranges for a suspended coroutine to be resumed
+   * \param handle  The coroutine
+   */
+  virtual void schedule(std::coroutine_handle<> handle) = 0;
+};
+
+/**
+ * \class Task
+ * \brief The return type of a coroutine which an Executor runs to
+ * completion, and whose result nobody waits for
+ * \details A Task starts suspended.  Passing it to spawn schedules its first
+ * run, and it frees itself once it finishes.
+ */
+class Task {
+ public:
+  /**
+   * \struct promise_type
+   * \brief Tells the compiler how a Task coroutine starts and finishes
+   */
+  struct promise_type {
+    Task get_return_object();
+    std::suspend_always initial_suspend() noexcept;
+    std::suspend_never final_suspend() noexcept;
+    void return_void();
+
+    /** \brief A Task has nobody to report an exception to, so it aborts */
+    void unhandled_exception();
+  };
+
+  Task(Task&& other) noexcept;
+  Task(const Task& other) = delete;
+  Task& operator=(const Task& other) = delete;
+
+  /**
+   * \brief Destroys the coroutine, if it was never spawned
+   */
+  ~Task();
+
+  /**
+   * \brief Schedules the first run of a Task
+   * \param executor  The Executor which runs the Task
+   * \param task      The Task
+   */
+  friend void spawn(Executor& executor, Task task);
+
+ private:
+  explicit Task(std::coroutine_handle<promise_type> handle);
+
+  /** \brief The coroutine, or nullptr once it has been spawned */
+  std::coroutine_handle<promise_type> handle_;
+};
+
+/**
+ * \class SingleThreadExecutor
+ * \brief Runs coroutines one at a time on the thread which calls run
+ * \note Not thread-safe, so every coroutine which uses it (and every
+ * PriorityChannel which wakes them) must stay on that thread
+ */
+class SingleThreadExecutor : public Executor {
+ public:
+  /**
+   * \brief Adds a coroutine to the end of the queue
+   * \param handle  The coroutine
+   * \note Run time: amortized constant
+   */
+  void schedule(std::coroutine_handle<> handle) override;
+
+  /**
+   * \brief Resumes queued coroutines, including any they schedule, until
+   * the queue is empty
+   * \return The number of coroutines resumed
+   */
+  size_t run();
+
+ private:
+  std::deque<std::coroutine_handle<>> ready_;
+};
+
+/**
+ * \class ThreadPoolExecutor
+ * \brief Resumes coroutines on the workers of a PriorityThreadPool
+ * \details A coroutine which a running coroutine schedules goes to the same
+ * worker's queue (see PriorityThreadPool), so a producer and the consumer
+ * it wakes tend to share a cache.
+ */
+class ThreadPoolExecutor : public Executor {
+ public:
+  /**
+   * \brief Starts the worker threads
+   * \param threads   The number of worker threads, which must be at least 1
+   */
+  explicit ThreadPoolExecutor(size_t threads);
+
+  /**
+   * \brief Queues a coroutine to be resumed on a worker
+   * \param handle  The coroutine
+   * \note Run time: logarithmic in the number of queued coroutines
+   */
+  void schedule(std::coroutine_handle<> handle) override;
+
+  /**
+   * \brief Runs every queued coroutine and stops the workers
+   * \warning Coroutines which are still suspended in a PriorityChannel are
+   * never resumed, so close the channels first
+   */
+  void shutdown();
+
+ private:
+  PriorityThreadPool<int> pool_;
+};
+
+/**
+ * \class PriorityChannel
+ * \brief A bounded priority queue which coroutines send items into and
+ * receive the smallest item from, waiting when the queue is full or empty
+ * \details Producers write "co_await channel.send(item)" and consumers write
+ * "co_await channel.receive()".  The items are kept in a MinHeap which holds
+ * at most capacity of them.  A producer which finds it full is suspended
+ * until a consumer makes room (backpressure), and a consumer which finds it
+ * empty is suspended until a producer sends something.
+ *
+ * Every operation takes one lock, so producers and consumers may run on
+ * different threads.  A suspended coroutine is resumed by scheduling it on
+ * the channel's Executor, never inside another coroutine's send or receive.
+ * \note receive returns the smallest item in the MinHeap.  Items of
+ * suspended producers are not in it yet, so they can be smaller.
+ * \note The template type T must support the copy constructor, operator<,
+ * and operator==
+ */
+template <typename T>
+class PriorityChannel {
+ public:
+  /**
+   * \class SendAwaiter
+   * \brief What send returns.  co_await on it gives true once the item is
+   * in the channel, or false if the channel was closed.
+   */
+  class SendAwaiter {
+   public:
+    SendAwaiter(PriorityChannel& channel, T item);
+    bool await_ready() const noexcept;
+    bool await_suspend(std::coroutine_handle<> handle);
+    bool await_resume() const noexcept;
+
+   private:
+    friend class PriorityChannel;
+    PriorityChannel& channel_;
+    T item_;
+    bool result_ = false;
+    std::coroutine_handle<> handle_;
+  };
+
+  /**
+   * \class ReceiveAwaiter
+   * \brief What receive returns.  co_await on it gives the smallest item, or
+   * std::nullopt once the channel is closed and empty.
+   */
+  class ReceiveAwaiter {
+   public:
+    explicit ReceiveAwaiter(PriorityChannel& channel);
+    bool await_ready() const noexcept;
+    bool await_suspend(std::coroutine_handle<> handle);
+    std::optional<T> await_resume();
+
+   private:
+    friend class PriorityChannel;
+    PriorityChannel& channel_;
+    std::optional<T> result_;
+    std::coroutine_handle<> handle_;
+  };
+
+  /**
+   * \brief Creates an empty PriorityChannel
+   * \param executor  The Executor on which suspended coroutines resume
+   * \param capacity  The most items the channel holds, which must be at
+   * least 1
+   * \note Run time: constant
+   */
+  PriorityChannel(Executor& executor, size_t capacity);
+
+  PriorityChannel(const PriorityChannel& other) = delete;
+  PriorityChannel& operator=(const PriorityChannel& other) = delete;
+
+  /**
+   * \brief Sends an item, waiting while the channel is full
+   * \param item  The item
+   * \return An awaitable which gives true once the item is in the channel,
+   * or false if the channel was closed first
+   * \note Run time: logarithmic in the capacity
+   */
+  SendAwaiter send(T item);
+
+  /**
+   * \brief Receives the smallest item, waiting while the channel is empty
+   * \return An awaitable which gives the item, or std::nullopt if the
+   * channel is closed and empty
+   * \note Run time: logarithmic in the capacity
+   */
+  ReceiveAwaiter receive();
+
+  /**
+   * \brief Closes the channel.  Waiting and future sends give false, and
+   * receives give std::nullopt once the items in the channel run out.
+   * \note Run time: linear in the number of waiting coroutines
+   */
+  void close();
+
+  /**
+   * \brief Returns the number of items in the channel
+   * \return The number of items, not counting those of waiting producers
+   * \note Run time: constant
+   */
+  size_t size() const;
+
+  /**
+   * \brief Returns the most items the channel holds
+   * \return The capacity
+   * \note Run time: constant
+   */
+  size_t capacity() const;
+
+ private:
+  Executor& executor_;
+  size_t capacity_;
+
+  /** \brief Guards everything below */
+  mutable std::mutex mutex_;
+
+  MinHeap<T> heap_;
+  bool closed_ = false;
+
+  /** \brief Producers waiting for room, in the order they arrived */
+  std::deque<SendAwaiter*> senders_;
+
+  /** \brief Consumers waiting for an item, in the order they arrived */
+  std::deque<ReceiveAwaiter*> receivers_;
+};
+
+#include "prioritychannel-private.hpp"
+
+#endif  // TEMPLATES_PRIORITYCHANNEL_HPP_
@@ -0,0 +1,208 @@
+/**
+ * \file prioritythreadpool-private.hpp
+ * \copyright Matthew Calligaro
+ * \date January 2020
+ * \brief Provides the template implementation for the PriorityThreadPool
+ * class
+ */
+
+// NOLINT(build/header_guard)
+
+#include <algorithm>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+
+template <typename Priority>
+thread_local PriorityThreadPool<Priority>*
+    PriorityThreadPool<Priority>::currentPool_ = nullptr;
+
+template <typename Priority>
+thread_local size_t PriorityThreadPool<Priority>::currentWorker_ = 0;
+
+template <typename Priority>
+PriorityThreadPool<Priority>::PriorityThreadPool(size_t threads)
+    : workers_(threads) {
+  for (size_t self = 0; self < threads; ++self) {
+    threads_.emplace_back([this, self] { work(self); });
+  }
+}
+
+template <typename Priority>
+PriorityThreadPool<Priority>::~PriorityThreadPool() {
+  shutdown();
+}
+
+template <typename Priority>
+template <typename F>
+std::future<std::invoke_result_t<std::decay_t<F>>>
+PriorityThreadPool<Priority>::submit(const Priority& priority, F&& fn) {
+  using Result = std::invoke_result_t<std::decay_t<F>>;
+
+  // A std::function must be copyable, but a std::packaged_task (which is
+  // what connects fn to the future) can only be moved, so the queued
+  // function shares it instead
+  auto job = std::make_shared<std::packaged_task<Result()>>(
+      std::forward<F>(fn));
+  std::future<Result> result = job->get_future();
+  push(priority, [job] { (*job)(); });
+  return result;
+}
+
+template <typename Priority>
+void PriorityThreadPool<Priority>::shutdown() {
+  stopping_ = true;
+  {
+    // Taking the lock makes sure that no worker is between checking
+    // stopping_ and starting to wait, where it would miss the notification
+    std::lock_guard<std::mutex> lock(sleepMutex_);
+  }
+  wakeUp_.notify_all();
+  for (std::thread& thread : threads_) {
+    if (thread.joinable()) {
+      thread.join();
+    }
+  }
+}
+
+template <typename Priority>
+size_t PriorityThreadPool<Priority>::threads() const {
+  return workers_.size();
+}
+
+template <typename Priority>
+void PriorityThreadPool<Priority>::push(const Priority& priority,
+                                        std::function<void()> run) {
+  // We count the task before checking stopping_.  If shutdown has not been
+  // called yet, the workers will see the count before they can decide to
+  // exit, so they stay until the task has run.  Tasks which are already
+  // running may keep submitting while the pool drains.
+  bool fromWorker = currentPool_ == this;
+  ++pending_;
+  if (stopping_ && !fromWorker) {
+    --pending_;
+    throw std::runtime_error("PriorityThreadPool has been shut down");
+  }
+
+  size_t sequence = nextSequence_++;
+  Worker& target =
+      workers_[fromWorker ? currentWorker_ : sequence % workers_.size()];
+  {
+    std::lock_guard<std::mutex> lock(target.mutex);
+    target.queue.insert(Task{priority, sequence, std::move(run)});
+  }
+
+  // A worker counts itself in sleeping_ before it checks pending_, so either
+  // it sees our task or we see it sleeping.  Busy pools skip the lock.
+  if (sleeping_ > 0) {
+    {
+      std::lock_guard<std::mutex> lock(sleepMutex_);
+    }
+    wakeUp_.notify_one();
+  }
+}
+
+template <typename Priority>
+bool PriorityThreadPool<Priority>::takeTask(size_t self, Task& task) {
+  Worker& mine = workers_[self];
+  size_t count = workers_.size();
+
+  // With tasks of our own, we only peek at one other queue.  try_lock never
+  // waits, so holding both locks at once cannot deadlock.
+  {
+    std::lock_guard<std::mutex> mineLock(mine.mutex);
+    if (!mine.queue.empty()) {
+      MinHeap<Task>* source = &mine.queue;
+      std::unique_lock<std::mutex> otherLock;
+      if (count > 1) {
+        mine.probe = (mine.probe + 1) % (count - 1);
+        Worker& other = workers_[(self + 1 + mine.probe) % count];
+        otherLock = std::unique_lock(other.mutex, std::try_to_lock);
+        if (otherLock.owns_lock() && !other.queue.empty() &&
+            other.queue.peakMin().priority < mine.queue.peakMin().priority) {
+          source = &other.queue;
+        }
+      }
+      task = source->peakMin();
+      source->deleteMin();
+      return true;
+    }
+  }
+
+  // Otherwise we steal the best task on offer.  Another worker may take it
+  // between our look and our second lock, in which case we take whatever is
+  // now at the top of that queue, or try again later.
+  size_t best = count;
+  Priority bestPriority{};
+  for (size_t i = 1; i < count; ++i) {
+    size_t victim = (self + i) % count;
+    std::lock_guard<std::mutex> lock(workers_[victim].mutex);
+    const MinHeap<Task>& queue = workers_[victim].queue;
+    if (!queue.empty() &&
+        (best == count || queue.peakMin().priority < bestPriority)) {
+      best = victim;
+      bestPriority = queue.peakMin().priority;
+    }
+  }
+  if (best == count) {
+    return false;
+  }
+  std::lock_guard<std::mutex> lock(workers_[best].mutex);
+  MinHeap<Task>& queue = workers_[best].queue;
+  if (queue.empty()) {
+    return false;
+  }
+  task = queue.peakMin();
+  queue.deleteMin();
+  return true;
+}
+
+template <typename Priority>
+void PriorityThreadPool<Priority>::work(size_t self) {
+  currentPool_ = this;
+  currentWorker_ = self;
+  Task task;
+  while (true) {
+    if (takeTask(self, task)) {
+      --pending_;
+      task.run();
+
+      // Release whatever the task holds (such as its packaged_task) now,
+      // rather than when the next task replaces it
+      task.run = nullptr;
+      continue;
+    }
+
+    // Wait until there is a task or the pool shuts down.  pending_ counts a
+    // task slightly before it reaches a queue, so we may come back here
+    // once or twice before we can take it.
+    std::unique_lock<std::mutex> lock(sleepMutex_);
+    ++sleeping_;
+    wakeUp_.wait(lock, [this] { return pending_ > 0 || stopping_; });
+    --sleeping_;
+    if (stopping_ && pending_ == 0) {
+      return;
+    }
+  }
+}
+
+/*******************************************************************************
+ * Task implementation
+ ******************************************************************************/
+
+template <typename Priority>
+bool PriorityThreadPool<Priority>::Task::operator<(const Task& rhs) const {
+  if (priority < rhs.priority) {
+    return true;
+  }
+  if (rhs.priority < priority) {
+    return false;
+  }
+  return sequence < rhs.sequence;
+}
+
+template <typename Priority>
+bool PriorityThreadPool<Priority>::Task::operator==(const Task& rhs) const {
+  // Sequence numbers are unique, so they identify a task on their own
+  return sequence == rhs.sequence;
+}
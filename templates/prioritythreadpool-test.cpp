@@ -0,0 +1,156 @@
+/**
+ * \file prioritythreadpool-test.cpp
+ * \copyright Matthew Calligaro
+ * \date January 2020
+ * \brief An assortment of ad hoc tests for the PriorityThreadPool class
+ * \note These tests are not comprehensive and are NOT a good example of unit
+ * testing
+ */
+
+#include <atomic>
+#include <cassert>
+#include <future>
+#include <iostream>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+#include "prioritythreadpool.hpp"
+
+/**
+ * \brief Checks that futures receive results and exceptions
+ */
+void futureTest() {
+  PriorityThreadPool<> pool(3);
+  assert(pool.threads() == 3);
+
+  std::future<int> answer = pool.submit(1, [] { return 6 * 7; });
+  std::future<std::string> word =
+      pool.submit(2, [] { return std::string("heap"); });
+  std::future<void> failure =
+      pool.submit(0, [] { throw std::runtime_error("oops"); });
+  assert(answer.get() == 42);
+  assert(word.get() == "heap");
+  bool caught = false;
+  try {
+    failure.get();
+  } catch (const std::runtime_error&) {
+    caught = true;
+  }
+  assert(caught);
+}
+
+/**
+ * \brief Checks that a high-priority task submitted after many low-priority
+ * ones does not wait for them, with one worker and with several
+ */
+void priorityInversionTest() {
+  for (size_t threads : {1, 4}) {
+    PriorityThreadPool<> pool(threads);
+
+    // Keep every worker busy so that the other tasks pile up in the queues
+    std::promise<void> release;
+    std::shared_future<void> released = release.get_future().share();
+    std::atomic<size_t> blocked = 0;
+    for (size_t i = 0; i < threads; ++i) {
+      pool.submit(0, [&blocked, released] {
+        ++blocked;
+        released.wait();
+      });
+    }
+    while (blocked < threads) {
+      std::this_thread::yield();
+    }
+
+    std::mutex orderMutex;
+    std::vector<int> order;
+    auto record = [&orderMutex, &order](int label) {
+      return [&orderMutex, &order, label] {
+        std::lock_guard<std::mutex> lock(orderMutex);
+        order.push_back(label);
+      };
+    };
+    for (int i = 0; i < 50; ++i) {
+      pool.submit(5, record(5));
+    }
+    pool.submit(0, record(0));
+    release.set_value();
+    pool.shutdown();
+
+    // The worker which holds the urgent task runs it first.  Every other
+    // worker peeks at a different queue each time it takes a task, so each
+    // of them runs at most threads - 1 other tasks before finding it.
+    assert(order.size() == 51);
+    size_t position = 0;
+    while (order[position] != 0) {
+      ++position;
+    }
+    assert(position < 1 + threads * (threads - 1));
+  }
+}
+
+/**
+ * \brief Checks that idle workers steal tasks which a running task queued on
+ * its own worker
+ */
+void stealingTest() {
+  PriorityThreadPool<> pool(2);
+  std::future<size_t> total = pool.submit(0, [&pool] {
+    // The subtasks go to this worker's queue, but this worker is busy
+    // waiting for them, so only the other worker can run them
+    std::thread::id parent = std::this_thread::get_id();
+    std::vector<std::future<size_t>> parts;
+    for (size_t i = 1; i <= 100; ++i) {
+      parts.push_back(pool.submit(1, [parent, i] {
+        assert(std::this_thread::get_id() != parent);
+        return i;
+      }));
+    }
+    size_t sum = 0;
+    for (std::future<size_t>& part : parts) {
+      sum += part.get();
+    }
+    return sum;
+  });
+  assert(total.get() == 5050);
+}
+
+/**
+ * \brief Checks that shutdown runs every queued task, including tasks queued
+ * while the pool drains, and that later submissions are refused
+ */
+void shutdownTest() {
+  const size_t TASKS = 1000;
+  std::atomic<size_t> count = 0;
+  PriorityThreadPool<double> pool(3);
+  for (size_t i = 0; i < TASKS; ++i) {
+    pool.submit(static_cast<double>(i % 7), [&count, &pool, i] {
+      ++count;
+      if (i == TASKS - 1) {
+        pool.submit(-1.0, [&count] { ++count; });
+      }
+    });
+  }
+  pool.shutdown();
+  assert(count == TASKS + 1);
+
+  bool refused = false;
+  try {
+    pool.submit(0.0, [] {});
+  } catch (const std::runtime_error&) {
+    refused = true;
+  }
+  assert(refused);
+  pool.shutdown();
+}
+
+int main() {
+  futureTest();
+  priorityInversionTest();
+  stealingTest();
+  shutdownTest();
+
+  std::cout << "All tests passed" << std::endl;
+  return 0;
+}
@@ -0,0 +1,181 @@
+/**
+ * \file prioritythreadpool.hpp
+ * \copyright Matthew Calligaro
+ * \date January 2020
+ * \brief Declares the PriorityThreadPool class
+ */
+
+#ifndef TEMPLATES_PRIORITYTHREADPOOL_HPP_
+#define TEMPLATES_PRIORITYTHREADPOOL_HPP_
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include "minheap.hpp"
+
+/**
+ * \class PriorityThreadPool
+ * \brief A fixed set of worker threads which run submitted tasks, smallest
+ * priority first
+ * \details A single shared queue would make every worker take the same lock
+ * for every task.  Instead, each worker owns a MinHeap of tasks with a lock
+ * of its own.  Tasks submitted from outside the pool are dealt out to the
+ * workers in turn, and tasks submitted by a running task go to the queue of
+ * the worker running it, which is where they are most likely to find their
+ * data in the cache.
+ *
+ * A worker normally runs the top of its own queue, but first peeks at one
+ * other queue (a different one each time) and runs that queue's top instead
+ * if it has a smaller priority.  A worker whose own queue is empty steals
+ * the best task on offer from any other queue.  So a high-priority task
+ * never waits long behind lower-priority tasks on another worker, while a
+ * busy worker only ever takes two locks per task.
+ *
+ * Equal priorities run in the order in which they were submitted to the
+ * same queue.
+ * \note The template type Priority must support the copy constructor, the
+ * default constructor, and operator<
+ */
+template <typename Priority = int>
+class PriorityThreadPool {
+ public:
+  /**
+   * \brief Creates a PriorityThreadPool and starts its workers
+   * \param threads   The number of worker threads, which must be at least 1
+   * \note Run time: linear in threads
+   */
+  explicit PriorityThreadPool(
+      size_t threads = std::max(1u, std::thread::hardware_concurrency()));
+
+  // A PriorityThreadPool owns running threads, which cannot be copied
+  PriorityThreadPool(const PriorityThreadPool&) = delete;
+  PriorityThreadPool& operator=(const PriorityThreadPool&) = delete;
+
+  /**
+   * \brief Shuts down the PriorityThreadPool (see shutdown)
+   */
+  ~PriorityThreadPool();
+
+  /**
+   * \brief Queues a function to be run on one of the workers
+   * \param priority  The priority of the task, where smaller runs first
+   * \param fn        The function to run, which takes no arguments
+   * \return A future which receives the result of fn, or the exception it
+   * throws
+   * \note Run time: logarithmic in the number of queued tasks
+   * \note Throws std::runtime_error if the PriorityThreadPool has been shut
+   * down, unless it is called from one of its own tasks
+   */
+  template <typename F>
+  std::future<std::invoke_result_t<std::decay_t<F>>> submit(
+      const Priority& priority, F&& fn);
+
+  /**
+   * \brief Stops accepting new tasks from outside the pool, runs every task
+   * which is still queued, and waits for the workers to finish
+   * \note Calling shutdown again has no effect
+   * \warning Must not be called from one of the pool's own tasks, since that
+   * task's worker would wait for itself
+   */
+  void shutdown();
+
+  /**
+   * \brief Returns the number of worker threads
+   * \return The number of worker threads
+   * \note Run time: constant
+   */
+  size_t threads() const;
+
+ private:
+  /**
+   * \struct Task
+   * \brief A queued function, ordered by its priority and then by the order
+   * in which it was submitted
+   */
+  struct Task {
+    Priority priority;
+    size_t sequence;
+    std::function<void()> run;
+
+    bool operator<(const Task& rhs) const;
+    bool operator==(const Task& rhs) const;
+  };
+
+  /**
+   * \struct Worker
+   * \brief The queue owned by one worker thread
+   * \details Each Worker gets a cache line of its own, so that workers taking
+   * their own locks do not slow each other down (false sharing)
+   */
+  struct alignas(64) Worker {
+    std::mutex mutex;
+    MinHeap<Task> queue;
+
+    /** \brief The next other queue to peek at, touched only by this worker */
+    size_t probe = 0;
+  };
+
+  /** \brief The queue of each worker */
+  std::vector<Worker> workers_;
+
+  /** \brief The worker threads */
+  std::vector<std::thread> threads_;
+
+  /** \brief The sequence number for the next submitted task */
+  std::atomic<size_t> nextSequence_{0};
+
+  /** \brief The number of tasks which are queued and not yet taken */
+  std::atomic<size_t> pending_{0};
+
+  /** \brief Whether shutdown has been called */
+  std::atomic<bool> stopping_{false};
+
+  /** \brief The number of workers waiting for a task */
+  std::atomic<size_t> sleeping_{0};
+
+  /** \brief The mutex and condition variable on which idle workers wait */
+  std::mutex sleepMutex_;
+  std::condition_variable wakeUp_;
+
+  /** \brief The pool which the current thread works for, if any */
+  static thread_local PriorityThreadPool* currentPool_;
+
+  /** \brief The index of the current thread in currentPool_ */
+  static thread_local size_t currentWorker_;
+
+  /**
+   * \brief Queues a task on one of the workers and wakes a worker if needed
+   * \param priority  The priority of the task
+   * \param run       The function to run
+   * \note Run time: logarithmic in the number of queued tasks
+   */
+  void push(const Priority& priority, std::function<void()> run);
+
+  /**
+   * \brief Takes the next task for a worker, from its own queue or another
+   * \param self  The index of the worker
+   * \param task  Set to the task which was taken, if any
+   * \return True if a task was taken
+   * \note Run time: logarithmic in the number of queued tasks if the worker's
+   * own queue has a task, otherwise linear in the number of workers
+   */
+  bool takeTask(size_t self, Task& task);
+
+  /**
+   * \brief The loop run by each worker thread
+   * \param self  The index of the worker
+   */
+  void work(size_t self);
+};
+
+#include "prioritythreadpool-private.hpp"
+
+#endif  // TEMPLATES_PRIORITYTHREADPOOL_HPP_
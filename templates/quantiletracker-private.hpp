@@ -0,0 +1,203 @@
+/**
+ * \file quantiletracker-private.hpp
+ * \copyright Matthew Calligaro
+ * \date January 2020
+ * \brief Provides the template implementation for the QuantileTracker and
+ * StreamingMedian classes
+ */
+
+// NOLINT(build/header_guard)
+
+#include <algorithm>
+#include <cmath>
+#include <type_traits>
+
+/*******************************************************************************
+ * QuantileTracker implementation
+ ******************************************************************************/
+
+template <typename T>
+QuantileTracker<T>::QuantileTracker(double fraction, size_t window)
+    : fraction_{std::clamp(fraction, 0.0, 1.0)}, window_{window} {
+  // Nothing else to do
+}
+
+template <typename T>
+size_t QuantileTracker<T>::size() const {
+  return lower_.live + upper_.live;
+}
+
+template <typename T>
+bool QuantileTracker<T>::empty() const {
+  return size() == 0;
+}
+
+template <typename T>
+void QuantileTracker<T>::add(const T& val) {
+  // The add and the removal together move the quantile by at most two
+  // places, so a single rebalance afterwards covers both
+  if (window_ > 0) {
+    if (history_.size() == window_) {
+      remove(history_.front());
+      history_.pop_front();
+    }
+    history_.push_back(val);
+  }
+
+  // Every value in lower_ is no larger than every value in upper_, so val
+  // goes in upper_ if it is no smaller than the smallest value there.  The
+  // removal above may have emptied lower_, so we compare with upper_.
+  if (upper_.live > 0 && !(val < upper_.top())) {
+    upper_.push(val);
+  } else {
+    lower_.push(val);
+  }
+  rebalance();
+}
+
+template <typename T>
+const T& QuantileTracker<T>::quantile() const {
+  return lower_.top();
+}
+
+template <typename T>
+void QuantileTracker<T>::remove(const T& val) {
+  // By the same reasoning as in add, a copy of val is in lower_ exactly when
+  // val is no larger than the top of lower_
+  if (lower_.live > 0 && !(lower_.top() < val)) {
+    lower_.remove(val);
+  } else {
+    upper_.remove(val);
+  }
+}
+
+template <typename T>
+void QuantileTracker<T>::rebalance() {
+  // lower_ should hold the k smallest values, where k is the rank of the
+  // quantile.  The tiny adjustment keeps rounding errors from pushing a
+  // product such as 0.07 * 100 up to the next rank.
+  size_t count = size();
+  size_t rank = 0;
+  if (count > 0) {
+    double exact = fraction_ * static_cast<double>(count) * (1.0 - 1e-12);
+    rank = std::clamp(static_cast<size_t>(std::ceil(exact)), size_t{1}, count);
+  }
+
+  while (lower_.live > rank) {
+    T moved = lower_.top();
+    lower_.pop();
+    upper_.push(moved);
+  }
+  while (lower_.live < rank) {
+    T moved = upper_.top();
+    upper_.pop();
+    lower_.push(moved);
+  }
+}
+
+/*******************************************************************************
+ * QuantileTracker::Side implementation
+ ******************************************************************************/
+
+template <typename T>
+template <typename Element>
+const T& QuantileTracker<T>::Side<Element>::top() const {
+  return valueOf(heap.peakMin());
+}
+
+template <typename T>
+template <typename Element>
+const T& QuantileTracker<T>::Side<Element>::valueOf(const Element& element) {
+  if constexpr (std::is_same_v<Element, Reversed>) {
+    return element.value;
+  } else {
+    return element;
+  }
+}
+
+template <typename T>
+template <typename Element>
+void QuantileTracker<T>::Side<Element>::push(const T& val) {
+  heap.insert(Element{val});
+  ++live;
+}
+
+template <typename T>
+template <typename Element>
+void QuantileTracker<T>::Side<Element>::pop() {
+  heap.deleteMin();
+  --live;
+  prune();
+}
+
+template <typename T>
+template <typename Element>
+void QuantileTracker<T>::Side<Element>::remove(const T& val) {
+  ++removed[val];
+  --live;
+  prune();
+}
+
+template <typename T>
+template <typename Element>
+void QuantileTracker<T>::Side<Element>::prune() {
+  // A removed value is normally dropped once it reaches the top, which is the
+  // one place a heap can remove from cheaply
+  while (!heap.empty()) {
+    auto found = removed.find(top());
+    if (found == removed.end()) {
+      break;
+    }
+    heap.deleteMin();
+    if (--found->second == 0) {
+      removed.erase(found);
+    }
+  }
+
+  // Values far from the quantile may never reach the top, so once the removed
+  // values outnumber the live ones we sweep them all out at once.  Sweeping
+  // is linear, but it happens only after a linear number of removals.
+  if (heap.size() > 2 * live + PURGE_SLACK) {
+    heap.eraseIf([this](const Element& element) {
+      auto found = removed.find(valueOf(element));
+      if (found == removed.end()) {
+        return false;
+      }
+      if (--found->second == 0) {
+        removed.erase(found);
+      }
+      return true;
+    });
+    heap.compact();
+  }
+}
+
+/*******************************************************************************
+ * QuantileTracker::Reversed implementation
+ ******************************************************************************/
+
+template <typename T>
+bool QuantileTracker<T>::Reversed::operator<(const Reversed& rhs) const {
+  return rhs.value < value;
+}
+
+template <typename T>
+bool QuantileTracker<T>::Reversed::operator==(const Reversed& rhs) const {
+  return value == rhs.value;
+}
+
+/*******************************************************************************
+ * StreamingMedian implementation
+ ******************************************************************************/
+
+template <typename T>
+StreamingMedian<T>::StreamingMedian(size_t window)
+    : QuantileTracker<T>(0.5, window) {
+  // Nothing else to do
+}
+
+template <typename T>
+typename StreamingMedian<T>::const_reference
+StreamingMedian<T>::median() const {
+  return QuantileTracker<T>::quantile();
+}
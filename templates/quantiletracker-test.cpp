@@ -0,0 +1,99 @@
+/**
+ * \file quantiletracker-test.cpp
+ * \copyright Matthew Calligaro
+ * \date January 2020
+ * \brief An assortment of ad hoc tests for the QuantileTracker and
+ * StreamingMedian classes
+ * \note These tests are not comprehensive and are NOT a good example of unit
+ * testing
+ */
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <deque>
+#include <iostream>
+#include <random>
+#include <vector>
+#include "quantiletracker.hpp"
+
+/**
+ * \brief Finds a nearest-rank quantile the slow way, by sorting
+ * \param values    The values to search
+ * \param fraction  The quantile to find
+ * \return The quantile of values
+ */
+int sortedQuantile(std::vector<int> values, double fraction) {
+  std::sort(values.begin(), values.end());
+  double exact = fraction * static_cast<double>(values.size()) * (1.0 - 1e-12);
+  size_t rank = static_cast<size_t>(std::ceil(exact));
+  rank = std::clamp(rank, size_t{1}, values.size());
+  return values[rank - 1];
+}
+
+/**
+ * \brief Checks a few small cases by hand
+ */
+void basicTest() {
+  StreamingMedian<int> median;
+  assert(median.empty());
+  median.add(5);
+  assert(median.size() == 1 && median.median() == 5);
+  median.add(1);
+  assert(median.median() == 1);
+  median.add(9);
+  assert(median.median() == 5);
+  median.add(7);
+  assert(median.median() == 5);
+  median.add(8);
+  assert(median.median() == 7);
+
+  // With a window of 3, only the last three values count
+  StreamingMedian<int> windowed(3);
+  for (int value : {1, 2, 3, 100, 101}) {
+    windowed.add(value);
+  }
+  assert(windowed.size() == 3 && windowed.median() == 100);
+
+  QuantileTracker<int> largest(1.0);
+  QuantileTracker<int> smallest(0.0);
+  for (int value : {4, -2, 11, 6}) {
+    largest.add(value);
+    smallest.add(value);
+  }
+  assert(largest.quantile() == 11 && smallest.quantile() == -2);
+}
+
+/**
+ * \brief Compares QuantileTrackers against sorting after every add, with and
+ * without windows, using many duplicate values
+ */
+void randomTest() {
+  std::mt19937 generator(70);
+  std::uniform_int_distribution<int> distribution(0, 50);
+  for (double fraction : {0.0, 0.07, 0.5, 0.9, 0.99, 1.0}) {
+    for (size_t window : {0, 1, 2, 17, 100}) {
+      QuantileTracker<int> tracker(fraction, window);
+      std::deque<int> recent;
+      for (int i = 0; i < 1000; ++i) {
+        int value = distribution(generator);
+        tracker.add(value);
+        recent.push_back(value);
+        if (window > 0 && recent.size() > window) {
+          recent.pop_front();
+        }
+        assert(tracker.size() == recent.size());
+        std::vector<int> values(recent.begin(), recent.end());
+        assert(tracker.quantile() == sortedQuantile(values, fraction));
+      }
+    }
+  }
+}
+
+int main() {
+  basicTest();
+  randomTest();
+
+  std::cout << "All tests passed" << std::endl;
+  return 0;
+}
@@ -0,0 +1,234 @@
+/**
+ * \file quantiletracker.hpp
+ * \copyright Matthew Calligaro
+ * \date January 2020
+ * \brief Declares the QuantileTracker and StreamingMedian classes
+ */
+
+#ifndef TEMPLATES_QUANTILETRACKER_HPP_
+#define TEMPLATES_QUANTILETRACKER_HPP_
+
+#include <cstddef>
+#include <deque>
+#include <map>
+
+#include "minheap.hpp"
+
+/**
+ * \class QuantileTracker
+ * \brief Keeps track of one quantile (such as the median or the 99th
+ * percentile) of a stream of values, optionally over a sliding window
+ * \details The values are split between two heaps.  A max heap holds the
+ * smallest k values, where k is the rank of the quantile, and a MinHeap holds
+ * the rest.  The quantile is then simply the top of the max heap.  Adding a
+ * value puts it on the correct side and then moves at most one value across
+ * to restore the split, so each update takes logarithmic time, rather than
+ * the O(nlog(n)) time of sorting all the values again.
+ *
+ * The quantile is the nearest-rank quantile: the k-th smallest of n values,
+ * where k is the fraction times n, rounded up, and at least 1.  For the
+ * median of an even number of values, this is the smaller middle value.
+ *
+ * With a window, the tracker only keeps the most recent values, and each add
+ * past that removes the oldest.  A heap cannot find an arbitrary value
+ * quickly, so removed values are written down and only dropped once they
+ * reach the top of their heap.
+ * \note The template type T must support the copy constructor, copy
+ * assignment, operator<, and operator==
+ */
+template <typename T>
+class QuantileTracker {
+ public:
+  // STL container type definitions
+  using value_type = T;
+  using size_type = size_t;
+  using const_reference = const value_type&;
+
+  /**
+   * \brief Creates a QuantileTracker with no values
+   * \param fraction  The quantile to track, from 0 (the smallest value) to 1
+   * (the largest value)
+   * \param window    The number of recent values to keep, or 0 to keep every
+   * value
+   * \note Run time: constant
+   */
+  explicit QuantileTracker(double fraction = 0.5, size_t window = 0);
+
+  /**
+   * \brief Returns the number of values currently tracked
+   * \return The number of values, which is at most the window if there is
+   * one
+   * \note Run time: constant
+   */
+  size_type size() const;
+
+  /**
+   * \brief Returns whether there are no values
+   * \return True if the size of the QuantileTracker is 0
+   * \note Run time: constant
+   */
+  bool empty() const;
+
+  /**
+   * \brief Adds a value, and removes the oldest value if the window is full
+   * \param val   The value to add
+   * \note Run time: amortized logarithmic in the number of values
+   */
+  void add(const_reference val);
+
+  /**
+   * \brief Returns the tracked quantile of the current values
+   * \return A reference to the value at the quantile
+   * \note Run time: constant
+   * \warning Behavior is undefined if the QuantileTracker is empty
+   */
+  const_reference quantile() const;
+
+ private:
+  /**
+   * \struct Reversed
+   * \brief A value whose operator< is reversed, so a MinHeap of Reversed
+   * acts as a max heap
+   */
+  struct Reversed {
+    T value;
+    bool operator<(const Reversed& rhs) const;
+    bool operator==(const Reversed& rhs) const;
+  };
+
+  /**
+   * \struct Side
+   * \brief One of the two heaps, along with the values removed from it which
+   * it still holds
+   */
+  template <typename Element>
+  struct Side {
+    MinHeap<Element> heap;
+
+    /** \brief How many copies of each removed value are still in heap */
+    std::map<T, size_t> removed;
+
+    /** \brief The number of values in heap which have not been removed */
+    size_t live = 0;
+
+    /**
+     * \brief Returns the top value of heap
+     * \return The top value of heap, which has not been removed
+     */
+    const T& top() const;
+
+    /**
+     * \brief Adds a value to heap
+     * \param val   The value to add
+     */
+    void push(const T& val);
+
+    /**
+     * \brief Takes out the top value of heap
+     */
+    void pop();
+
+    /**
+     * \brief Marks one copy of a value in heap as removed
+     * \param val   The value to remove
+     */
+    void remove(const T& val);
+
+    /**
+     * \brief Drops values from the top of heap until the top has not been
+     * removed, so that top always returns a current value, and sweeps out
+     * every removed value if they have piled up
+     */
+    void prune();
+
+    /**
+     * \brief Returns the value which an element of heap holds
+     * \param element   An element of heap
+     * \return The value inside element
+     */
+    static const T& valueOf(const Element& element);
+  };
+
+  /**
+   * \brief How many removed values a Side may hold beyond its live values
+   * before it sweeps them out, so that small Sides do not sweep constantly
+   */
+  static constexpr size_t PURGE_SLACK = 64;
+
+  /** \brief The quantile to track, between 0 and 1 */
+  double fraction_;
+
+  /** \brief The number of values to keep, or 0 to keep every value */
+  size_t window_;
+
+  /** \brief The values in the window, oldest first, if there is a window */
+  std::deque<T> history_;
+
+  /** \brief The smallest values, up to and including the quantile */
+  Side<Reversed> lower_;
+
+  /** \brief The values larger than the quantile */
+  Side<T> upper_;
+
+  /**
+   * \brief Removes one copy of a value which is being tracked
+   * \param val   The value to remove
+   * \note Run time: amortized logarithmic in the number of values
+   * \warning Leaves lower_ unbalanced, so call rebalance afterwards
+   */
+  void remove(const_reference val);
+
+  /**
+   * \brief Moves values between lower_ and upper_ until lower_ holds exactly
+   * the values up to the quantile
+   * \note Run time: logarithmic in the number of values, since an add and a
+   * removal change the rank of the quantile by at most 2
+   */
+  void rebalance();
+};
+
+/**
+ * \class StreamingMedian
+ * \brief Keeps track of the median of a stream of values, optionally over a
+ * sliding window
+ * \details StreamingMedian is a QuantileTracker for the fraction 0.5.
+ * \note StreamingMedian privately inherits from QuantileTracker<T>, in the
+ * same way as FixedMinHeap inherits from MinHeap, so that it can fix the
+ * fraction and call the quantile the median.
+ * \note The template type T must support the copy constructor, copy
+ * assignment, operator<, and operator==
+ */
+template <typename T>
+class StreamingMedian : private QuantileTracker<T> {
+ public:
+  // STL container type definitions
+  using typename QuantileTracker<T>::value_type;
+  using typename QuantileTracker<T>::size_type;
+  using typename QuantileTracker<T>::const_reference;
+
+  // These methods behave exactly as they do in QuantileTracker
+  using QuantileTracker<T>::size;
+  using QuantileTracker<T>::empty;
+  using QuantileTracker<T>::add;
+
+  /**
+   * \brief Creates a StreamingMedian with no values
+   * \param window  The number of recent values to keep, or 0 to keep every
+   * value
+   * \note Run time: constant
+   */
+  explicit StreamingMedian(size_t window = 0);
+
+  /**
+   * \brief Returns the median of the current values
+   * \return A reference to the median, or the smaller of the two middle
+   * values if there is an even number of values
+   * \note Run time: constant
+   * \warning Behavior is undefined if the StreamingMedian is empty
+   */
+  const_reference median() const;
+};
+
+#include "quantiletracker-private.hpp"
+
+#endif  // TEMPLATES_QUANTILETRACKER_HPP_
@@ -0,0 +1,316 @@
+/**
+ * \file sharedminheap-private.hpp
+ * \copyright Matthew Calligaro
+ * \date January 2020
+ * \brief Provides the template implementation for the SharedMinHeap class
+ */
+
+// NOLINT(build/header_guard)
+
+#include <fcntl.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <thread>
+
+/*******************************************************************************
+ * SharedMinHeap implementation
+ ******************************************************************************/
+
+template <typename T>
+SharedMinHeap<T>::SharedMinHeap(const std::string& name, size_t capacity)
+    : descriptor_{-1},
+      mapping_{nullptr},
+      mappingSize_{slotsOffset() + capacity * sizeof(T)},
+      header_{nullptr},
+      slots_{nullptr} {
+  // O_EXCL makes exactly one process the creator, even if several start at
+  // once.  The others wait for it to finish filling in the header.
+  descriptor_ = shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+  bool created = descriptor_ != -1;
+  if (!created) {
+    if (errno != EEXIST) {
+      throw std::system_error(errno, std::generic_category(), "shm_open");
+    }
+    descriptor_ = shm_open(name.c_str(), O_RDWR, 0600);
+    if (descriptor_ == -1) {
+      throw std::system_error(errno, std::generic_category(), "shm_open");
+    }
+  }
+
+  // Gives up on the segment, removing it if we created it
+  auto fail = [&](int error, const char* what) {
+    if (mapping_ != nullptr) {
+      munmap(mapping_, mappingSize_);
+    }
+    close(descriptor_);
+    if (created) {
+      shm_unlink(name.c_str());
+    }
+    throw std::system_error(error, std::generic_category(), what);
+  };
+
+  const auto DEADLINE =
+      std::chrono::steady_clock::now() + std::chrono::seconds(5);
+  if (created) {
+    // ftruncate fills the segment with zeros
+    if (ftruncate(descriptor_, mappingSize_) != 0) {
+      fail(errno, "ftruncate");
+    }
+  } else {
+    struct stat status;
+    do {
+      if (fstat(descriptor_, &status) != 0) {
+        fail(errno, "fstat");
+      }
+      if (std::chrono::steady_clock::now() > DEADLINE) {
+        fail(ETIMEDOUT, "waiting for the segment to be created");
+      }
+      std::this_thread::yield();
+    } while (status.st_size == 0);
+    if (static_cast<size_t>(status.st_size) != mappingSize_) {
+      close(descriptor_);
+      throw std::runtime_error("The segment holds a heap of another size");
+    }
+  }
+
+  mapping_ = mmap(nullptr, mappingSize_, PROT_READ | PROT_WRITE, MAP_SHARED,
+                  descriptor_, 0);
+  if (mapping_ == MAP_FAILED) {
+    mapping_ = nullptr;
+    fail(errno, "mmap");
+  }
+  header_ = static_cast<Header*>(mapping_);
+  slots_ = reinterpret_cast<T*>(static_cast<char*>(mapping_) + slotsOffset());
+
+  if (created) {
+    // Every field of Header is zero when empty except these, so the zeroed
+    // pages already hold the rest
+    header_->capacity = capacity;
+    header_->elementSize = sizeof(T);
+    header_->hole = NO_HOLE;
+
+    pthread_mutexattr_t attributes;
+    pthread_mutexattr_init(&attributes);
+    pthread_mutexattr_setpshared(&attributes, PTHREAD_PROCESS_SHARED);
+    pthread_mutexattr_setrobust(&attributes, PTHREAD_MUTEX_ROBUST);
+    int result = pthread_mutex_init(&header_->mutex, &attributes);
+    pthread_mutexattr_destroy(&attributes);
+    if (result != 0) {
+      fail(result, "pthread_mutex_init");
+    }
+    header_->ready.store(MAGIC, std::memory_order_release);
+  } else {
+    while (header_->ready.load(std::memory_order_acquire) != MAGIC) {
+      if (std::chrono::steady_clock::now() > DEADLINE) {
+        fail(ETIMEDOUT, "waiting for the segment to be created");
+      }
+      std::this_thread::yield();
+    }
+    if (header_->capacity != capacity || header_->elementSize != sizeof(T)) {
+      munmap(mapping_, mappingSize_);
+      close(descriptor_);
+      throw std::runtime_error("The segment holds a heap of another type");
+    }
+  }
+}
+
+template <typename T>
+SharedMinHeap<T>::~SharedMinHeap() {
+  munmap(mapping_, mappingSize_);
+  close(descriptor_);
+}
+
+template <typename T>
+bool SharedMinHeap<T>::unlink(const std::string& name) {
+  return shm_unlink(name.c_str()) == 0;
+}
+
+template <typename T>
+size_t SharedMinHeap<T>::capacity() const {
+  return header_->capacity;
+}
+
+template <typename T>
+size_t SharedMinHeap<T>::size() const {
+  Lock lock(*this);
+  return header_->size;
+}
+
+template <typename T>
+bool SharedMinHeap<T>::empty() const {
+  return size() == 0;
+}
+
+template <typename T>
+size_t SharedMinHeap<T>::recoveries() const {
+  Lock lock(*this);
+  return header_->recoveries;
+}
+
+template <typename T>
+T SharedMinHeap<T>::peakMin() const {
+  Lock lock(*this);
+  return slots_[0];
+}
+
+template <typename T>
+bool SharedMinHeap<T>::insert(const T& val) {
+  Lock lock(*this);
+  size_t size = header_->size;
+  if (size == header_->capacity) {
+    return false;
+  }
+
+  // The new slot at the end is the hole, and val belongs in it
+  beginOperation(size, val, size + 1);
+  header_->size = size + 1;
+  barrier();
+
+  // Bubble the hole up until val is no smaller than its parent
+  while (header_->hole > 0) {
+    size_t parent = (header_->hole - 1) / 2;
+    if (!(header_->moving < slots_[parent])) {
+      break;
+    }
+    moveHoleTo(parent);
+  }
+  fillHole();
+  return true;
+}
+
+template <typename T>
+void SharedMinHeap<T>::deleteMin() {
+  removeMin(nullptr);
+}
+
+template <typename T>
+bool SharedMinHeap<T>::popMin(T& out) {
+  return removeMin(&out);
+}
+
+template <typename T>
+bool SharedMinHeap<T>::removeMin(T* out) {
+  Lock lock(*this);
+  size_t size = header_->size;
+  if (size == 0) {
+    return false;
+  }
+  if (out != nullptr) {
+    *out = slots_[0];
+  }
+
+  // The smallest element leaves a hole at the top, and the last element
+  // belongs in it (the same approach as MinHeap::deleteMin)
+  beginOperation(0, slots_[size - 1], size - 1);
+  header_->size = --size;
+  barrier();
+
+  // Bubble the hole down until the last element is no larger than either of
+  // its children
+  while (true) {
+    size_t child = 2 * header_->hole + 1;
+    if (child >= size) {
+      break;
+    }
+    if (child + 1 < size && slots_[child + 1] < slots_[child]) {
+      ++child;
+    }
+    if (!(slots_[child] < header_->moving)) {
+      break;
+    }
+    moveHoleTo(child);
+  }
+  fillHole();
+  return true;
+}
+
+template <typename T>
+constexpr size_t SharedMinHeap<T>::slotsOffset() {
+  return (sizeof(Header) + alignof(T) - 1) / alignof(T) * alignof(T);
+}
+
+template <typename T>
+void SharedMinHeap<T>::barrier() {
+  std::atomic_signal_fence(std::memory_order_seq_cst);
+}
+
+template <typename T>
+void SharedMinHeap<T>::beginOperation(size_t hole, const T& moving,
+                                      size_t pendingSize) {
+  // moving and pendingSize are only read once hole is set, so they must be
+  // in place first
+  header_->moving = moving;
+  header_->pendingSize = pendingSize;
+  barrier();
+  header_->hole = hole;
+  barrier();
+}
+
+template <typename T>
+void SharedMinHeap<T>::moveHoleTo(size_t from) {
+  // Between these two stores, the element at from is in both slots, and
+  // filling the old hole during recovery just overwrites the extra copy
+  slots_[header_->hole] = slots_[from];
+  barrier();
+  header_->hole = from;
+  barrier();
+}
+
+template <typename T>
+void SharedMinHeap<T>::fillHole() {
+  slots_[header_->hole] = header_->moving;
+  barrier();
+  header_->hole = NO_HOLE;
+  barrier();
+}
+
+template <typename T>
+void SharedMinHeap<T>::recover() {
+  ++header_->recoveries;
+  if (header_->hole == NO_HOLE) {
+    // The process died outside of an operation, or before one took effect
+    return;
+  }
+
+  // Every element is now in the heap once, but the interrupted bubbling may
+  // have left some out of order, so we rebuild the heap from scratch
+  header_->size = header_->pendingSize;
+  fillHole();
+  std::make_heap(slots_, slots_ + header_->size,
+                 [](const T& lhs, const T& rhs) { return rhs < lhs; });
+}
+
+/*******************************************************************************
+ * Lock implementation
+ ******************************************************************************/
+
+template <typename T>
+SharedMinHeap<T>::Lock::Lock(const SharedMinHeap& heap) : heap_{heap} {
+  pthread_mutex_t* mutex = &heap_.header_->mutex;
+  int result = pthread_mutex_lock(mutex);
+  if (result == EOWNERDEAD) {
+    // We hold the mutex, but its last holder died partway through, so we
+    // repair the heap and tell the mutex it is safe to use again
+    const_cast<SharedMinHeap&>(heap_).recover();
+    result = pthread_mutex_consistent(mutex);
+  }
+  if (result != 0) {
+    throw std::system_error(result, std::generic_category(),
+                            "pthread_mutex_lock");
+  }
+}
+
+template <typename T>
+SharedMinHeap<T>::Lock::~Lock() {
+  pthread_mutex_unlock(&heap_.header_->mutex);
+}
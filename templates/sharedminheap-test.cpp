@@ -0,0 +1,209 @@
+/**
+ * \file sharedminheap-test.cpp
+ * \copyright Matthew Calligaro
+ * \date January 2020
+ * \brief An assortment of ad hoc tests for the SharedMinHeap class
+ * \note These tests are not comprehensive and are NOT a good example of unit
+ * testing
+ */
+
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+#include "sharedminheap.hpp"
+
+/**
+ * \brief Returns a segment name which no other run of the tests is using
+ * \param suffix  Tells apart the segments of one run
+ * \return The name of the segment
+ */
+std::string segmentName(const std::string& suffix) {
+  return "/cs70-sharedminheap-test-" + std::to_string(getpid()) + "-" +
+         suffix;
+}
+
+/**
+ * \brief Removes every element of a heap
+ * \param heap  The heap to empty
+ * \return The elements, in the order they were removed
+ */
+template <typename T>
+std::vector<T> drain(SharedMinHeap<T>& heap) {
+  std::vector<T> values;
+  T value;
+  while (heap.popMin(value)) {
+    values.push_back(value);
+  }
+  return values;
+}
+
+/**
+ * \brief Checks the heap operations within one process
+ */
+void orderTest() {
+  std::string name = segmentName("order");
+  SharedMinHeap<int> heap(name, 100);
+  assert(heap.empty());
+  assert(heap.capacity() == 100);
+
+  std::vector<int> numbers(100);
+  for (int i = 0; i < 100; ++i) {
+    numbers[i] = i / 3;
+  }
+  std::shuffle(numbers.begin(), numbers.end(), std::default_random_engine(45));
+  for (int number : numbers) {
+    assert(heap.insert(number));
+  }
+  assert(!heap.insert(-1));
+  assert(heap.size() == 100);
+  assert(heap.peakMin() == 0);
+
+  // A second SharedMinHeap with the same name sees the same elements
+  SharedMinHeap<int> other(name, 100);
+  other.deleteMin();
+  assert(heap.size() == 99);
+
+  std::vector<int> values = drain(heap);
+  std::sort(numbers.begin(), numbers.end());
+  assert(std::equal(values.begin(), values.end(), numbers.begin() + 1));
+  heap.deleteMin();
+  assert(other.empty());
+
+  bool caught = false;
+  try {
+    SharedMinHeap<int> wrong(name, 50);
+  } catch (const std::runtime_error&) {
+    caught = true;
+  }
+  assert(caught);
+  assert(SharedMinHeap<int>::unlink(name));
+  assert(!SharedMinHeap<int>::unlink(name));
+}
+
+/**
+ * \brief Has several processes insert into one heap at once
+ */
+void processTest() {
+  const int PROCESSES = 4;
+  const int PER_PROCESS = 2000;
+  std::string name = segmentName("process");
+  SharedMinHeap<int> heap(name, PROCESSES * PER_PROCESS);
+
+  std::vector<pid_t> children;
+  for (int process = 0; process < PROCESSES; ++process) {
+    pid_t child = fork();
+    assert(child != -1);
+    if (child == 0) {
+      // Each child opens the segment for itself, as an unrelated process
+      // would, and inserts every PROCESSES-th number
+      SharedMinHeap<int> mine(name, PROCESSES * PER_PROCESS);
+      for (int i = 0; i < PER_PROCESS; ++i) {
+        mine.insert((PER_PROCESS - i) * PROCESSES + process);
+      }
+      _exit(0);
+    }
+    children.push_back(child);
+  }
+  for (pid_t child : children) {
+    int status;
+    waitpid(child, &status, 0);
+    assert(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+  }
+
+  std::vector<int> values = drain(heap);
+  assert(values.size() == PROCESSES * PER_PROCESS);
+  for (int i = 0; i < PROCESSES * PER_PROCESS; ++i) {
+    assert(values[i] == PROCESSES + i);
+  }
+  SharedMinHeap<int>::unlink(name);
+}
+
+/**
+ * \brief Kills a process while it is using the heap, again and again, and
+ * checks that nothing is lost or duplicated
+ * \details The child inserts distinct numbers and removes every other one.
+ * It records which step it is on in shared memory before each step, so we
+ * know how many elements the heap should hold, give or take the step in
+ * progress.
+ */
+void crashTest() {
+  const size_t KILLS = 100;
+  const size_t CAPACITY = 1 << 16;
+  std::string name = segmentName("crash");
+  SharedMinHeap<uint64_t> heap(name, CAPACITY);
+
+  auto* step = static_cast<std::atomic<uint64_t>*>(
+      mmap(nullptr, sizeof(std::atomic<uint64_t>), PROT_READ | PROT_WRITE,
+           MAP_SHARED | MAP_ANONYMOUS, -1, 0));
+  assert(step != MAP_FAILED);
+
+  // Multiplying by an odd number scrambles the order without repeats
+  auto valueOf = [](uint64_t i) { return i * 0x9E3779B97F4A7C15; };
+
+  std::default_random_engine engine(46);
+  std::uniform_int_distribution<int> delay(100, 3000);
+  for (size_t kill = 0; kill < KILLS; ++kill) {
+    step->store(0);
+    pid_t child = fork();
+    assert(child != -1);
+    if (child == 0) {
+      for (uint64_t i = 0;; ++i) {
+        step->store(i);
+        heap.insert(valueOf(i));
+        if (i % 2 == 1) {
+          heap.deleteMin();
+        }
+      }
+    }
+    std::this_thread::sleep_for(std::chrono::microseconds(delay(engine)));
+    ::kill(child, SIGKILL);
+    waitpid(child, nullptr, 0);
+
+    // Steps 0 through current - 1 are done, and each odd one removed an
+    // element.  The current step may have inserted, and may have removed.
+    uint64_t current = step->load();
+    uint64_t done = current - current / 2;
+    std::vector<uint64_t> values = drain(heap);
+    assert(values.size() + (current % 2) >= done);
+    assert(values.size() <= done + 1);
+    assert(std::is_sorted(values.begin(), values.end()));
+    assert(std::adjacent_find(values.begin(), values.end()) == values.end());
+
+    std::vector<uint64_t> expected;
+    for (uint64_t i = 0; i <= current; ++i) {
+      expected.push_back(valueOf(i));
+    }
+    std::sort(expected.begin(), expected.end());
+    assert(std::includes(expected.begin(), expected.end(), values.begin(),
+                         values.end()));
+  }
+
+  // Most of the kills land while the child holds the lock
+  assert(heap.recoveries() > 0);
+  assert(heap.insert(7));
+  assert(heap.peakMin() == 7);
+  munmap(step, sizeof(std::atomic<uint64_t>));
+  SharedMinHeap<uint64_t>::unlink(name);
+}
+
+int main() {
+  orderTest();
+  processTest();
+  crashTest();
+
+  std::cout << "All tests passed" << std::endl;
+  return 0;
+}
@@ -0,0 +1,274 @@
+/**
+ * \file sharedminheap.hpp
+ * \copyright Matthew Calligaro
+ * \date January 2020
+ * \brief Declares the SharedMinHeap class
+ */
+
+#ifndef TEMPLATES_SHAREDMINHEAP_HPP_
+#define TEMPLATES_SHAREDMINHEAP_HPP_
+
+#include <pthread.h>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <type_traits>
+
+/**
+ * \class SharedMinHeap
+ * \brief A binary min heap in POSIX shared memory, which several processes
+ * on one machine can use at once
+ * \details Every process which creates a SharedMinHeap with the same name
+ * maps the same shared-memory segment (see shm_open), so they all see one
+ * heap.  The segment holds a header followed by a fixed array of capacity
+ * slots, and the elements are copied into the slots directly, so T must be
+ * trivially copyable: a pointer in one process means nothing in another.
+ *
+ * Every operation holds a mutex which is stored in the segment and shared
+ * between processes.  The mutex is robust, so if a process dies while
+ * holding it, the next process to lock it is told so instead of waiting
+ * forever.  That process then repairs the heap before carrying on:
+ *
+ * An operation moves elements with a "hole", a slot whose element has been
+ * copied elsewhere.  The header records the hole, the element which belongs
+ * in it, and what the size will be once the operation is done.  Recording
+ * the hole is the moment the operation takes effect, and every later step
+ * keeps each element either in a slot of the heap or in the header.  After a
+ * crash, copying the recorded element into the hole and rebuilding the heap
+ * therefore finishes the operation without losing or duplicating anything.
+ * \note The segment stays in place after every process has closed it, so
+ * that a restarted process can carry on where the others left off.  Call
+ * unlink to remove it.
+ * \note The template type T must be trivially copyable and support operator<
+ */
+template <typename T>
+class SharedMinHeap {
+  static_assert(std::is_trivially_copyable_v<T>,
+                "Elements are copied between processes as raw bytes");
+
+ public:
+  // STL container type definitions
+  using value_type = T;
+  using size_type = size_t;
+  using const_reference = const value_type&;
+
+  /**
+   * \brief Opens the shared-memory segment called name, creating an empty
+   * heap in it if it does not exist yet
+   * \param name      The name of the segment, which starts with a '/' and
+   * contains no other '/' (see shm_open)
+   * \param capacity  The number of elements the heap can hold
+   * \note Run time: linear in capacity for the process which creates the
+   * segment (to zero it), otherwise constant
+   * \throw std::system_error if the segment cannot be created or mapped
+   * \throw std::runtime_error if the segment holds a heap of a different
+   * capacity or element size
+   */
+  SharedMinHeap(const std::string& name, size_type capacity);
+
+  SharedMinHeap(const SharedMinHeap& other) = delete;
+  SharedMinHeap& operator=(const SharedMinHeap& other) = delete;
+
+  /**
+   * \brief Unmaps the segment, which stays in place for other processes
+   * \note Run time: constant
+   */
+  ~SharedMinHeap();
+
+  /**
+   * \brief Removes a shared-memory segment, so that the next SharedMinHeap
+   * with its name starts out empty
+   * \param name  The name of the segment
+   * \return True if the segment existed
+   * \note Processes which have already mapped the segment keep using it
+   */
+  static bool unlink(const std::string& name);
+
+  /**
+   * \brief Returns the number of elements the heap can hold
+   * \return The capacity the segment was created with
+   * \note Run time: constant
+   */
+  size_type capacity() const;
+
+  /**
+   * \brief Returns the number of elements in the heap
+   * \return The number of elements in the heap, which other processes may
+   * change as soon as this returns
+   * \note Run time: constant
+   */
+  size_type size() const;
+
+  /**
+   * \brief Returns whether the heap is empty
+   * \return True if the size of the heap is 0
+   * \note Run time: constant
+   */
+  bool empty() const;
+
+  /**
+   * \brief Returns the number of times a process found that another one had
+   * died while holding the lock, and repaired the heap
+   * \return The number of repairs since the segment was created
+   * \note Run time: constant
+   */
+  size_t recoveries() const;
+
+  /**
+   * \brief Returns a copy of the smallest element of the heap
+   * \return The smallest element.  Unlike MinHeap::peakMin, this is a copy,
+   * since the slot may change as soon as the lock is released.
+   * \note Run time: constant
+   * \warning Behavior is undefined if the heap is empty
+   */
+  value_type peakMin() const;
+
+  /**
+   * \brief Adds a new value to the heap if there is room for it
+   * \param val   The value to insert
+   * \return True if val was inserted, false if the heap was full
+   * \note Run time: logarithmic in the size of the heap
+   */
+  bool insert(const_reference val);
+
+  /**
+   * \brief Removes the smallest value from the heap, if there is one
+   * \note Run time: logarithmic in the size of the heap
+   * \note Another process may empty the heap between a call to empty and a
+   * call to deleteMin, so deleteMin does nothing on an empty heap
+   */
+  void deleteMin();
+
+  /**
+   * \brief Removes the smallest value from the heap and copies it out, as
+   * a single operation which no other process can interrupt
+   * \param out   Set to the smallest value, if there is one
+   * \return True if a value was removed, false if the heap was empty
+   * \note Run time: logarithmic in the size of the heap
+   */
+  bool popMin(value_type& out);
+
+ private:
+  /** \brief The value of Header::hole when no operation is in progress */
+  static constexpr uint64_t NO_HOLE = UINT64_MAX;
+
+  /** \brief Marks a segment whose header has been filled in */
+  static constexpr uint64_t MAGIC = 0x4353373048656170;
+
+  /**
+   * \struct Header
+   * \brief The start of the segment
+   */
+  struct Header {
+    /** \brief MAGIC, once the process which created the segment is done */
+    std::atomic<uint64_t> ready;
+
+    uint64_t capacity;
+    uint64_t elementSize;
+
+    /** \brief The robust, process-shared mutex which guards the rest */
+    pthread_mutex_t mutex;
+
+    uint64_t size;
+
+    /** \brief The slot which holds no element, or NO_HOLE */
+    uint64_t hole;
+
+    /** \brief What size will be once the operation in progress is done */
+    uint64_t pendingSize;
+
+    /** \brief The element which belongs in hole */
+    T moving;
+
+    uint64_t recoveries;
+  };
+
+  /**
+   * \class Lock
+   * \brief Holds the mutex for as long as it exists, repairing the heap
+   * first if its last holder died
+   */
+  class Lock {
+   public:
+    /**
+     * \brief Locks the mutex of a SharedMinHeap
+     * \param heap  The SharedMinHeap to lock
+     * \throw std::system_error if the mutex cannot be locked
+     */
+    explicit Lock(const SharedMinHeap& heap);
+
+    ~Lock();
+
+   private:
+    const SharedMinHeap& heap_;
+  };
+
+  /** \brief The file descriptor of the segment */
+  int descriptor_;
+
+  /** \brief The start of the mapping */
+  void* mapping_;
+
+  /** \brief The number of bytes mapped */
+  size_t mappingSize_;
+
+  Header* header_;
+
+  /** \brief The array of capacity slots, which follows the header */
+  T* slots_;
+
+  /**
+   * \brief Returns where the slots start in the segment
+   * \return The offset of the first slot, in bytes
+   */
+  static constexpr size_t slotsOffset();
+
+  /**
+   * \brief Keeps the compiler from moving stores to the segment across this
+   * point.  A process which is killed stops between two instructions, and
+   * the stores it has already made are in the shared pages, so this is all
+   * it takes for a crash to leave the header and slots in program order.
+   */
+  static void barrier();
+
+  /**
+   * \brief Makes an operation take effect by recording its hole
+   * \param hole        The slot which the operation empties first
+   * \param moving      The element which belongs in the hole
+   * \param pendingSize The size of the heap after the operation
+   */
+  void beginOperation(size_t hole, const_reference moving,
+                      size_t pendingSize);
+
+  /**
+   * \brief Copies the element from one slot into the hole, making that slot
+   * the hole instead
+   * \param from  The slot to move from
+   */
+  void moveHoleTo(size_t from);
+
+  /**
+   * \brief Puts the recorded element into the hole, finishing the operation
+   */
+  void fillHole();
+
+  /**
+   * \brief Removes the smallest value from the heap, if there is one
+   * \param out   Where to copy the smallest value, or nullptr
+   * \return True if a value was removed, false if the heap was empty
+   * \note Run time: logarithmic in the size of the heap
+   */
+  bool removeMin(value_type* out);
+
+  /**
+   * \brief Finishes an operation interrupted by the death of a process
+   * \note Run time: linear in the size of the heap
+   */
+  void recover();
+};
+
+#include "sharedminheap-private.hpp"
+
+#endif  // TEMPLATES_SHAREDMINHEAP_HPP_
@@ -0,0 +1,221 @@
+/**
+ * \file shortestpath-private.hpp
+ * \copyright Matthew Calligaro
+ * \date January 2020
+ * \brief Provides the template implementation for the graph searches and
+ * their priority queues
+ */
+
+// NOLINT(build/header_guard)
+
+#include <vector>
+
+/*******************************************************************************
+ * PathEntry implementation
+ ******************************************************************************/
+
+template <typename Weight>
+bool PathEntry<Weight>::operator<(const PathEntry& rhs) const {
+  return priority < rhs.priority;
+}
+
+template <typename Weight>
+bool PathEntry<Weight>::operator==(const PathEntry& rhs) const {
+  return priority == rhs.priority && node == rhs.node;
+}
+
+/*******************************************************************************
+ * StdPriorityQueue implementation
+ ******************************************************************************/
+
+template <typename T>
+bool StdPriorityQueue<T>::empty() const {
+  return queue_.empty();
+}
+
+template <typename T>
+const T& StdPriorityQueue<T>::peakMin() const {
+  return queue_.top();
+}
+
+template <typename T>
+void StdPriorityQueue<T>::insert(const T& val) {
+  queue_.push(val);
+}
+
+template <typename T>
+void StdPriorityQueue<T>::deleteMin() {
+  queue_.pop();
+}
+
+template <typename T>
+bool StdPriorityQueue<T>::Greater::operator()(const T& lhs,
+                                              const T& rhs) const {
+  return rhs < lhs;
+}
+
+/*******************************************************************************
+ * DecreaseKeyHeap implementation
+ ******************************************************************************/
+
+template <typename Weight>
+DecreaseKeyHeap<Weight>::DecreaseKeyHeap(size_t nodes)
+    : heap_(1), positions_(nodes, 0) {
+  // Nothing else to do
+}
+
+template <typename Weight>
+size_t DecreaseKeyHeap<Weight>::size() const {
+  return heap_.size() - 1;
+}
+
+template <typename Weight>
+bool DecreaseKeyHeap<Weight>::empty() const {
+  return heap_.size() == 1;
+}
+
+template <typename Weight>
+const PathEntry<Weight>& DecreaseKeyHeap<Weight>::peakMin() const {
+  return heap_[1];
+}
+
+template <typename Weight>
+void DecreaseKeyHeap<Weight>::update(size_t node, Weight priority) {
+  // A new node starts in a new hole at the end, and a node already present
+  // starts from where it is.  Either way, a lower priority can only move up.
+  size_t index = positions_[node];
+  if (index == 0) {
+    index = heap_.size();
+    heap_.emplace_back();
+  }
+
+  PathEntry<Weight> entry{priority, node};
+  while (index > 1 && entry < heap_[index / 2]) {
+    place(index, heap_[index / 2]);
+    index /= 2;
+  }
+  place(index, entry);
+}
+
+template <typename Weight>
+void DecreaseKeyHeap<Weight>::deleteMin() {
+  positions_[heap_[1].node] = 0;
+  PathEntry<Weight> last = heap_.back();
+  heap_.pop_back();
+  size_t end = heap_.size();
+  if (end == 1) {
+    return;
+  }
+
+  // As in KeyedMinHeap, we move the smaller child of the hole up until the
+  // last entry fits in it
+  size_t index = 1;
+  while (2 * index < end) {
+    size_t child = 2 * index;
+    if (child + 1 < end && heap_[child + 1] < heap_[child]) {
+      ++child;
+    }
+    if (!(heap_[child] < last)) {
+      break;
+    }
+    place(index, heap_[child]);
+    index = child;
+  }
+  place(index, last);
+}
+
+template <typename Weight>
+void DecreaseKeyHeap<Weight>::place(size_t index,
+                                    const PathEntry<Weight>& entry) {
+  heap_[index] = entry;
+  positions_[entry.node] = index;
+}
+
+/*******************************************************************************
+ * Graph search implementation
+ ******************************************************************************/
+
+template <typename Weight, typename Queue>
+std::vector<Weight> dijkstra(const CsrGraph<Weight>& graph, size_t source) {
+  std::vector<Weight> distances(graph.nodes(), UNREACHABLE<Weight>);
+  distances[source] = 0;
+  Queue queue;
+  queue.insert({0, source});
+  while (!queue.empty()) {
+    // Copy the entry, since deleteMin destroys it
+    PathEntry<Weight> next = queue.peakMin();
+    queue.deleteMin();
+    if (distances[next.node] < next.priority) {
+      // A shorter path to this node already came out of the queue
+      continue;
+    }
+
+    for (size_t edge = graph.firstEdge(next.node);
+         edge < graph.lastEdge(next.node); ++edge) {
+      size_t target = graph.target(edge);
+      Weight distance = next.priority + graph.weight(edge);
+      if (distance < distances[target]) {
+        distances[target] = distance;
+        queue.insert({distance, target});
+      }
+    }
+  }
+  return distances;
+}
+
+template <typename Weight>
+std::vector<Weight> dijkstraDecreaseKey(const CsrGraph<Weight>& graph,
+                                        size_t source) {
+  std::vector<Weight> distances(graph.nodes(), UNREACHABLE<Weight>);
+  distances[source] = 0;
+  DecreaseKeyHeap<Weight> queue(graph.nodes());
+  queue.update(source, 0);
+  while (!queue.empty()) {
+    // Each node is in the queue at most once, so nothing is ever stale
+    PathEntry<Weight> next = queue.peakMin();
+    queue.deleteMin();
+    for (size_t edge = graph.firstEdge(next.node);
+         edge < graph.lastEdge(next.node); ++edge) {
+      size_t target = graph.target(edge);
+      Weight distance = next.priority + graph.weight(edge);
+      if (distance < distances[target]) {
+        distances[target] = distance;
+        queue.update(target, distance);
+      }
+    }
+  }
+  return distances;
+}
+
+template <typename Weight, typename Queue, typename Heuristic>
+Weight aStar(const CsrGraph<Weight>& graph, size_t source, size_t target,
+             Heuristic heuristic) {
+  std::vector<Weight> distances(graph.nodes(), UNREACHABLE<Weight>);
+  distances[source] = 0;
+  Queue queue;
+  queue.insert({heuristic(source), source});
+  while (!queue.empty()) {
+    PathEntry<Weight> next = queue.peakMin();
+    queue.deleteMin();
+    Weight distance = distances[next.node];
+    if (next.node == target) {
+      // With a consistent heuristic, the first time a node comes out of the
+      // queue, its distance is final
+      return distance;
+    }
+    if (distance + heuristic(next.node) < next.priority) {
+      continue;
+    }
+
+    for (size_t edge = graph.firstEdge(next.node);
+         edge < graph.lastEdge(next.node); ++edge) {
+      size_t neighbor = graph.target(edge);
+      Weight through = distance + graph.weight(edge);
+      if (through < distances[neighbor]) {
+        distances[neighbor] = through;
+        queue.insert({through + heuristic(neighbor), neighbor});
+      }
+    }
+  }
+  return UNREACHABLE<Weight>;
+}
@@ -0,0 +1,115 @@
+/**
+ * \file shortestpath-test.cpp
+ * \copyright Matthew Calligaro
+ * \date January 2020
+ * \brief An assortment of ad hoc tests for the CsrGraph class and the graph
+ * searches
+ * \note These tests are not comprehensive and are NOT a good example of unit
+ * testing
+ */
+
+#include <cassert>
+#include <cstdint>
+#include <iostream>
+#include <vector>
+#include "shortestpath.hpp"
+
+/**
+ * \brief Finds the distance to every node the slow way, with the
+ * Bellman-Ford algorithm
+ * \param graph   The graph
+ * \param source  The node to start from
+ * \return The distance to each node
+ */
+std::vector<uint64_t> bellmanFord(const CsrGraph<uint64_t>& graph,
+                                  size_t source) {
+  std::vector<uint64_t> distances(graph.nodes(), UNREACHABLE<uint64_t>);
+  distances[source] = 0;
+  for (size_t round = 1; round < graph.nodes(); ++round) {
+    for (size_t node = 0; node < graph.nodes(); ++node) {
+      if (distances[node] == UNREACHABLE<uint64_t>) {
+        continue;
+      }
+      for (size_t edge = graph.firstEdge(node); edge < graph.lastEdge(node);
+           ++edge) {
+        uint64_t distance = distances[node] + graph.weight(edge);
+        if (distance < distances[graph.target(edge)]) {
+          distances[graph.target(edge)] = distance;
+        }
+      }
+    }
+  }
+  return distances;
+}
+
+/**
+ * \brief Checks a small graph built from a list of edges
+ */
+void csrTest() {
+  using Graph = CsrGraph<uint64_t>;
+  Graph graph(5, {{3, 4, 1}, {0, 1, 4}, {0, 2, 1}, {2, 1, 2}, {1, 3, 5}});
+  assert(graph.nodes() == 5 && graph.edges() == 5);
+  assert(graph.lastEdge(0) - graph.firstEdge(0) == 2);
+  assert(graph.firstEdge(4) == graph.lastEdge(4));
+
+  std::vector<uint64_t> expected = {0, 3, 1, 8, 9};
+  assert(dijkstra(graph, 0) == expected);
+  assert(dijkstraDecreaseKey(graph, 0) == expected);
+  assert((dijkstra<uint64_t, StdPriorityQueue<PathEntry<uint64_t>>>(
+              graph, 0) == expected));
+
+  // Node 0 cannot be reached from anywhere else
+  std::vector<uint64_t> fromTwo = dijkstra(graph, 2);
+  assert(fromTwo[0] == UNREACHABLE<uint64_t> && fromTwo[4] == 8);
+  assert(aStar(graph, 4, 0, [](size_t) { return uint64_t{0}; }) ==
+         UNREACHABLE<uint64_t>);
+
+  Graph grid = Graph::grid(3, 2, 1, 0);
+  assert(grid.nodes() == 6 && grid.edges() == 14);
+}
+
+/**
+ * \brief Compares every search with Bellman-Ford on random and grid graphs
+ */
+void randomTest() {
+  for (uint32_t seed = 0; seed < 10; ++seed) {
+    CsrGraph<uint64_t> graph = CsrGraph<uint64_t>::random(200, 3, 100, seed);
+    std::vector<uint64_t> expected = bellmanFord(graph, 0);
+    assert(dijkstra(graph, 0) == expected);
+    assert(dijkstraDecreaseKey(graph, 0) == expected);
+    assert((dijkstra<uint64_t, StdPriorityQueue<PathEntry<uint64_t>>>(
+                graph, 0) == expected));
+    for (size_t target = 0; target < graph.nodes(); target += 17) {
+      assert(aStar(graph, 0, target, [](size_t) { return uint64_t{0}; }) ==
+             expected[target]);
+    }
+  }
+
+  // On a grid with weights of at least 1, the Manhattan distance is a
+  // consistent heuristic
+  const size_t WIDTH = 30;
+  const size_t HEIGHT = 20;
+  CsrGraph<uint64_t> grid = CsrGraph<uint64_t>::grid(WIDTH, HEIGHT, 9, 41);
+  std::vector<uint64_t> expected = bellmanFord(grid, 0);
+  assert(dijkstra(grid, 0) == expected);
+  assert(dijkstraDecreaseKey(grid, 0) == expected);
+  for (size_t target = 0; target < grid.nodes(); target += 7) {
+    auto manhattan = [target](size_t node) {
+      size_t x = node % WIDTH;
+      size_t y = node / WIDTH;
+      size_t targetX = target % WIDTH;
+      size_t targetY = target / WIDTH;
+      return static_cast<uint64_t>((x > targetX ? x - targetX : targetX - x) +
+                                   (y > targetY ? y - targetY : targetY - y));
+    };
+    assert(aStar(grid, 0, target, manhattan) == expected[target]);
+  }
+}
+
+int main() {
+  csrTest();
+  randomTest();
+
+  std::cout << "All tests passed" << std::endl;
+  return 0;
+}
@@ -0,0 +1,240 @@
+/**
+ * \file shortestpath.hpp
+ * \copyright Matthew Calligaro
+ * \date January 2020
+ * \brief Declares Dijkstra's algorithm and A* search over a CsrGraph, along
+ * with the priority queues they can use
+ */
+
+#ifndef TEMPLATES_SHORTESTPATH_HPP_
+#define TEMPLATES_SHORTESTPATH_HPP_
+
+#include <cstddef>
+#include <limits>
+#include <queue>
+#include <vector>
+#include "csrgraph.hpp"
+#include "minheap.hpp"
+
+/**
+ * \struct PathEntry
+ * \brief A node waiting in the priority queue of a graph search, ordered by
+ * its priority
+ */
+template <typename Weight>
+struct PathEntry {
+  /** \brief The distance to the node, plus the heuristic for A* */
+  Weight priority;
+
+  /** \brief The node */
+  size_t node;
+
+  bool operator<(const PathEntry& rhs) const;
+  bool operator==(const PathEntry& rhs) const;
+};
+
+/**
+ * \brief The distance reported for a node which cannot be reached
+ */
+template <typename Weight>
+constexpr Weight UNREACHABLE = std::numeric_limits<Weight>::max();
+
+/**
+ * \class StdPriorityQueue
+ * \brief Gives std::priority_queue the same interface as MinHeap, so that it
+ * can be passed to the graph searches for comparison
+ * \note The template type T must support the copy constructor, copy
+ * assignment, and operator<
+ */
+template <typename T>
+class StdPriorityQueue {
+ public:
+  // STL container type definitions
+  using value_type = T;
+  using size_type = size_t;
+  using const_reference = const value_type&;
+
+  /**
+   * \brief Returns whether the StdPriorityQueue is empty
+   * \return True if there are no values
+   * \note Run time: constant
+   */
+  bool empty() const;
+
+  /**
+   * \brief Returns the smallest value
+   * \return A reference to the smallest value
+   * \note Run time: constant
+   * \warning Behavior is undefined if the StdPriorityQueue is empty
+   */
+  const_reference peakMin() const;
+
+  /**
+   * \brief Adds a value
+   * \param val   The value to insert
+   * \note Run time: amortized logarithmic in the size of the StdPriorityQueue
+   */
+  void insert(const_reference val);
+
+  /**
+   * \brief Removes the smallest value
+   * \note Run time: logarithmic in the size of the StdPriorityQueue
+   * \warning Behavior is undefined if the StdPriorityQueue is empty
+   */
+  void deleteMin();
+
+ private:
+  /**
+   * \struct Greater
+   * \brief Reverses operator<, since std::priority_queue puts the largest
+   * value on top
+   */
+  struct Greater {
+    bool operator()(const T& lhs, const T& rhs) const;
+  };
+
+  /** \brief The values */
+  std::priority_queue<T, std::vector<T>, Greater> queue_;
+};
+
+/**
+ * \class DecreaseKeyHeap
+ * \brief A binary min heap holding at most one entry per node, whose
+ * priorities can be lowered in place
+ * \details This is the priority queue from the textbook version of
+ * Dijkstra's algorithm.  Alongside the heap, it keeps the position of every
+ * node in the heap, so that when a shorter path to a node turns up, update
+ * can find its entry, lower the priority, and bubble it up.  The heap never
+ * holds more entries than there are nodes, but every move has to update the
+ * positions as well.
+ * \note The template type Weight must be an arithmetic type
+ */
+template <typename Weight>
+class DecreaseKeyHeap {
+ public:
+  // STL container type definitions
+  using value_type = PathEntry<Weight>;
+  using size_type = size_t;
+  using const_reference = const value_type&;
+
+  /**
+   * \brief Creates an empty DecreaseKeyHeap
+   * \param nodes   The number of nodes, which are numbered 0 to nodes - 1
+   * \note Run time: linear in nodes
+   */
+  explicit DecreaseKeyHeap(size_t nodes);
+
+  /**
+   * \brief Returns the number of entries
+   * \return The number of entries
+   * \note Run time: constant
+   */
+  size_type size() const;
+
+  /**
+   * \brief Returns whether the DecreaseKeyHeap is empty
+   * \return True if there are no entries
+   * \note Run time: constant
+   */
+  bool empty() const;
+
+  /**
+   * \brief Returns the entry with the smallest priority
+   * \return A reference to the entry with the smallest priority
+   * \note Run time: constant
+   * \warning Behavior is undefined if the DecreaseKeyHeap is empty
+   */
+  const_reference peakMin() const;
+
+  /**
+   * \brief Adds a node, or lowers its priority if it is already present
+   * \param node      The node
+   * \param priority  The new priority, which must be no larger than the
+   * node's current priority if it is present
+   * \note Run time: logarithmic in the size of the DecreaseKeyHeap
+   */
+  void update(size_t node, Weight priority);
+
+  /**
+   * \brief Removes the entry with the smallest priority
+   * \note Run time: logarithmic in the size of the DecreaseKeyHeap
+   * \warning Behavior is undefined if the DecreaseKeyHeap is empty
+   */
+  void deleteMin();
+
+ private:
+  /** \brief The entries, starting at index 1 as in MinHeap */
+  std::vector<PathEntry<Weight>> heap_;
+
+  /** \brief The index of each node in heap_, or 0 if it is not there */
+  std::vector<size_t> positions_;
+
+  /**
+   * \brief Writes an entry at an index and records its position
+   * \param index   The index in heap_
+   * \param entry   The entry to write
+   * \note Run time: constant
+   */
+  void place(size_t index, const PathEntry<Weight>& entry);
+};
+
+/**
+ * \brief Finds the distance from one node to every node, using Dijkstra's
+ * algorithm with lazy re-insertion
+ * \details Rather than lower a node's priority in place, which a MinHeap
+ * cannot do, each shorter path found to a node inserts the node again.  The
+ * older entries are simply skipped when they come out of the queue, since by
+ * then the node's distance is already smaller than theirs.
+ * \param graph   The graph, which must not have negative weights
+ * \param source  The node to start from
+ * \return The distance to each node, or UNREACHABLE<Weight> for nodes which
+ * cannot be reached
+ * \note Run time: O(E log(E)), where E is the number of edges
+ * \note The template type Queue is the priority queue to use, which must
+ * hold PathEntry<Weight> and provide insert, peakMin, deleteMin, and empty
+ * like a MinHeap
+ */
+template <typename Weight, typename Queue = MinHeap<PathEntry<Weight>>>
+std::vector<Weight> dijkstra(const CsrGraph<Weight>& graph, size_t source);
+
+/**
+ * \brief Finds the distance from one node to every node, using Dijkstra's
+ * algorithm with a DecreaseKeyHeap
+ * \param graph   The graph, which must not have negative weights
+ * \param source  The node to start from
+ * \return The distance to each node, or UNREACHABLE<Weight> for nodes which
+ * cannot be reached
+ * \note Run time: O(E log(V)), where E is the number of edges and V is the
+ * number of nodes
+ */
+template <typename Weight>
+std::vector<Weight> dijkstraDecreaseKey(const CsrGraph<Weight>& graph,
+                                        size_t source);
+
+/**
+ * \brief Finds the distance from one node to another, using A* search with
+ * lazy re-insertion
+ * \details A* is Dijkstra's algorithm with each priority raised by a guess of
+ * the distance left to the target, so that nodes heading towards the target
+ * come out of the queue first.  The search stops as soon as the target comes
+ * out, which usually happens long before the whole graph has been visited.
+ * \param graph       The graph, which must not have negative weights
+ * \param source      The node to start from
+ * \param target      The node to find the distance to
+ * \param heuristic   A function which takes a node and returns a lower bound
+ * on its distance to target.  It must also be consistent: for every edge
+ * from a to b, heuristic(a) is at most the weight plus heuristic(b).
+ * \return The distance to target, or UNREACHABLE<Weight> if it cannot be
+ * reached
+ * \note Run time: O(E log(E)) in the worst case, where E is the number of
+ * edges
+ * \note The template type Queue is as for dijkstra
+ */
+template <typename Weight, typename Queue = MinHeap<PathEntry<Weight>>,
+          typename Heuristic>
+Weight aStar(const CsrGraph<Weight>& graph, size_t source, size_t target,
+             Heuristic heuristic);
+
+#include "shortestpath-private.hpp"
+
+#endif  // TEMPLATES_SHORTESTPATH_HPP_
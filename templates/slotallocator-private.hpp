@@ -0,0 +1,106 @@
+/**
+ * \file slotallocator-private.hpp
+ * \copyright Matthew Calligaro
+ * \date January 2020
+ * \brief Provides the template implementation for the SlotAllocator class
+ */
+
+// NOLINT(build/header_guard)
+
+#include <algorithm>
+#include <new>
+#include <type_traits>
+
+#ifdef __linux__
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+template <typename Slot>
+constexpr Slot* SlotAllocator<Slot>::allocate(size_t count) {
+  if (std::is_constant_evaluated()) {
+    // The compiler won't let us copy a slot which was never assigned, so
+    // arrays made during constant evaluation start out zeroed
+    return new Slot[count]();
+  }
+
+#ifdef __linux__
+  if (isLarge(count)) {
+    // A new mapping is always page-aligned, and its pages are only given
+    // memory once they are first written
+    void* memory = mmap(nullptr, mappedBytes(count), PROT_READ | PROT_WRITE,
+                        MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (memory == MAP_FAILED) {
+      throw std::bad_alloc();
+    }
+#ifdef MINHEAP_HUGE_PAGES
+    madvise(memory, mappedBytes(count), MADV_HUGEPAGE);
+#endif
+    return static_cast<Slot*>(memory);
+  }
+#endif
+
+  // The aligned form of operator new only provides raw memory, which is fine
+  // since the slots are trivially copyable and are always assigned before
+  // they are read
+  return static_cast<Slot*>(
+      ::operator new[](count * sizeof(Slot), std::align_val_t{ALIGNMENT}));
+}
+
+template <typename Slot>
+constexpr Slot* SlotAllocator<Slot>::reallocate(Slot* array, size_t count,
+                                                size_t newCount, size_t used) {
+#ifdef __linux__
+  if (!std::is_constant_evaluated() && isLarge(count) && isLarge(newCount)) {
+    // mremap moves the pages to a new address (if it must) by editing the
+    // page tables, so none of the slots are copied
+    void* memory = mremap(array, mappedBytes(count), mappedBytes(newCount),
+                          MREMAP_MAYMOVE);
+    if (memory == MAP_FAILED) {
+      throw std::bad_alloc();
+    }
+#ifdef MINHEAP_HUGE_PAGES
+    madvise(memory, mappedBytes(newCount), MADV_HUGEPAGE);
+#endif
+    return static_cast<Slot*>(memory);
+  }
+#endif
+
+  // Otherwise we copy the slots we need into a new array.  Since the slots
+  // are trivially copyable, std::copy can move them all at once with memmove
+  // rather than one at a time.
+  Slot* newArray = allocate(newCount);
+  std::copy(array, array + std::min(used, newCount), newArray);
+  deallocate(array, count);
+  return newArray;
+}
+
+template <typename Slot>
+constexpr void SlotAllocator<Slot>::deallocate(Slot* array, size_t count) {
+  if (std::is_constant_evaluated()) {
+    delete[] array;
+    return;
+  }
+
+#ifdef __linux__
+  if (isLarge(count)) {
+    munmap(array, mappedBytes(count));
+    return;
+  }
+#endif
+
+  ::operator delete[](array, std::align_val_t{ALIGNMENT});
+}
+
+template <typename Slot>
+constexpr bool SlotAllocator<Slot>::isLarge(size_t count) {
+  return count * sizeof(Slot) >= LARGE_ARRAY_BYTES;
+}
+
+#ifdef __linux__
+template <typename Slot>
+size_t SlotAllocator<Slot>::mappedBytes(size_t count) {
+  size_t page = sysconf(_SC_PAGESIZE);
+  return (count * sizeof(Slot) + page - 1) / page * page;
+}
+#endif
@@ -0,0 +1,94 @@
+/**
+ * \file slotallocator.hpp
+ * \copyright Matthew Calligaro
+ * \date January 2020
+ * \brief Declares the SlotAllocator class
+ */
+
+#ifndef TEMPLATES_SLOTALLOCATOR_HPP_
+#define TEMPLATES_SLOTALLOCATOR_HPP_
+
+#include <cstddef>
+#include <type_traits>
+
+/**
+ * \class SlotAllocator
+ * \brief Allocates, resizes, and frees the slot arrays used by MinHeap
+ * \details Every array starts on a cache line, so with 8-byte slots, the
+ * four grandchildren of slot i (4i to 4i + 3) always share one cache line.
+ * On Linux, arrays of at least LARGE_ARRAY_BYTES are mapped directly from the
+ * operating system with mmap.  Such an array grows or shrinks with mremap,
+ * which moves the array by changing the page tables rather than copying it,
+ * so a resize takes time proportional to the number of pages rather than the
+ * number of slots, and the pages which are new are only touched once they
+ * are used.  If MINHEAP_HUGE_PAGES is defined, large arrays also ask for
+ * transparent huge pages, which cover 2 MiB each rather than 4 KiB and so
+ * need far fewer TLB entries.  During constant evaluation, every array is
+ * an ordinary new[] array, which is all the compiler allows.
+ * \note The template type Slot must be trivially copyable
+ */
+template <typename Slot>
+class SlotAllocator {
+  static_assert(std::is_trivially_copyable_v<Slot>,
+                "Slots are copied as raw memory");
+
+ public:
+  /** \brief The alignment of every array, which is the size of a cache line */
+  static constexpr size_t ALIGNMENT = 64;
+
+  /** \brief The size from which arrays are mapped with mmap */
+  static constexpr size_t LARGE_ARRAY_BYTES = size_t{2} << 20;
+
+  /**
+   * \brief Allocates an array of slots
+   * \param count   The number of slots in the array
+   * \return A pointer to the first slot, which is not initialized
+   * \note Run time: constant
+   * \note Throws std::bad_alloc if the memory cannot be allocated
+   */
+  static constexpr Slot* allocate(size_t count);
+
+  /**
+   * \brief Changes the size of an array of slots, keeping its first slots
+   * \param array     An array returned by allocate or reallocate
+   * \param count     The number of slots in array
+   * \param newCount  The number of slots in the new array
+   * \param used      The number of slots at the start of array to keep
+   * \return A pointer to the first slot of the new array, which may be
+   * array itself
+   * \note Run time: linear in the number of pages of the larger array for
+   * large arrays, otherwise linear in used
+   * \warning array must not be used after this call, unless it is returned
+   */
+  static constexpr Slot* reallocate(Slot* array, size_t count,
+                                    size_t newCount, size_t used);
+
+  /**
+   * \brief Frees an array of slots
+   * \param array   An array returned by allocate or reallocate
+   * \param count   The number of slots in array
+   * \note Run time: constant
+   */
+  static constexpr void deallocate(Slot* array, size_t count);
+
+ private:
+  /**
+   * \brief Determines whether an array is mapped with mmap
+   * \param count   The number of slots in the array
+   * \return True if the array is large enough to be mapped with mmap
+   * \note Run time: constant
+   */
+  static constexpr bool isLarge(size_t count);
+
+  /**
+   * \brief Rounds a number of slots up to a whole number of pages
+   * \param count   The number of slots
+   * \return The size of the mapping for count slots, in bytes
+   * \note Run time: constant
+   */
+  static size_t mappedBytes(size_t count);
+};
+
+#include "slotallocator-private.hpp"
+
+#endif  // TEMPLATES_SLOTALLOCATOR_HPP_
@@ -0,0 +1,299 @@
+/**
+ * \file timerqueue-private.hpp
+ * \copyright Matthew Calligaro
+ * \date January 2020
+ * \brief Provides the template implementation for the TimerQueue class
+ */
+
+// NOLINT(build/header_guard)
+
+#include <algorithm>
+#include <bit>
+#include <utility>
+#include <vector>
+
+/*******************************************************************************
+ * TimerQueue::HeapEntry implementation
+ ******************************************************************************/
+
+template <typename Callback>
+bool TimerQueue<Callback>::HeapEntry::operator<(const HeapEntry& rhs) const {
+  // Break ties by index so that the order of heap_ does not depend on the
+  // order of insertion
+  return deadline < rhs.deadline ||
+         (deadline == rhs.deadline && timer < rhs.timer);
+}
+
+template <typename Callback>
+bool TimerQueue<Callback>::HeapEntry::operator==(const HeapEntry& rhs) const {
+  return deadline == rhs.deadline && timer == rhs.timer &&
+         generation == rhs.generation;
+}
+
+/*******************************************************************************
+ * TimerQueue implementation
+ ******************************************************************************/
+
+template <typename Callback>
+TimerQueue<Callback>::TimerQueue() : TimerQueue(0) {}
+
+template <typename Callback>
+TimerQueue<Callback>::TimerQueue(Tick start)
+    : now_{start}, size_{0}, occupied_{}, staleEntries_{0} {
+  heads_.fill(NONE);
+}
+
+template <typename Callback>
+typename TimerQueue<Callback>::Tick TimerQueue<Callback>::now() const {
+  return now_;
+}
+
+template <typename Callback>
+size_t TimerQueue<Callback>::size() const {
+  return size_;
+}
+
+template <typename Callback>
+bool TimerQueue<Callback>::empty() const {
+  return size_ == 0;
+}
+
+template <typename Callback>
+typename TimerQueue<Callback>::Handle TimerQueue<Callback>::schedule(
+    Tick deadline, Callback callback) {
+  // Reuse a free timer slot if there is one
+  size_t timer = timers_.size();
+  if (freeTimers_.empty()) {
+    timers_.emplace_back();
+  } else {
+    timer = freeTimers_.back();
+    freeTimers_.pop_back();
+  }
+
+  Timer& slot = timers_[timer];
+  slot.deadline = deadline;
+  slot.callback = std::move(callback);
+  place(timer);
+  ++size_;
+  return Handle{timer, slot.generation};
+}
+
+template <typename Callback>
+bool TimerQueue<Callback>::cancel(Handle handle) {
+  // Releasing a timer slot increases its generation, so a Handle to a timer
+  // which already fired or was cancelled no longer matches
+  if (handle.timer >= timers_.size() ||
+      timers_[handle.timer].generation != handle.generation) {
+    return false;
+  }
+
+  if (timers_[handle.timer].list == IN_HEAP) {
+    // The entry stays in heap_ until it reaches the top or heap_ is rebuilt
+    ++staleEntries_;
+  } else {
+    unlink(handle.timer);
+  }
+  release(handle.timer);
+  --size_;
+
+  // Once most of heap_ is stale, rebuilding it costs no more than the
+  // cancellations which made it stale
+  if (staleEntries_ >= MIN_COMPACTION && staleEntries_ > heap_.size() / 2) {
+    compactHeap();
+  }
+  return true;
+}
+
+template <typename Callback>
+size_t TimerQueue<Callback>::advanceTo(Tick time) {
+  std::vector<size_t> batch = takeList(DUE_LIST);
+
+  while (now_ < time) {
+    // Jump straight to the next time at which something happens, rather than
+    // visiting every tick in between
+    now_ = nextEvent(time);
+
+    // Timers in heap_ move into the wheels once time reaches the turn of the
+    // top wheel which contains their deadline
+    while (!heap_.empty() &&
+           (heap_.peakMin().deadline ^ now_) >> WHEEL_BITS == 0) {
+      size_t timer = heap_.peakMin().timer;
+      heap_.deleteMin();
+      place(timer);
+      discardStaleEntries();
+    }
+
+    // Starting from the top, spread the timers in the current slot of each
+    // wheel over the wheels below it
+    for (size_t level = LEVELS - 1; level > 0; --level) {
+      size_t list = level * SLOTS + slotOf(now_, level);
+      if (heads_[list] != NONE) {
+        for (size_t timer : takeList(list)) {
+          place(timer);
+        }
+      }
+    }
+
+    // Every timer in the current slot of level 0 is due now
+    for (size_t list : {slotOf(now_, 0), DUE_LIST}) {
+      if (heads_[list] != NONE) {
+        std::vector<size_t> due = takeList(list);
+        batch.insert(batch.end(), due.begin(), due.end());
+      }
+    }
+  }
+
+  // Take every callback out of its timer before running any of them, so that
+  // the callbacks see a consistent TimerQueue
+  std::vector<Callback> callbacks;
+  callbacks.reserve(batch.size());
+  for (size_t timer : batch) {
+    callbacks.push_back(std::move(timers_[timer].callback));
+    release(timer);
+  }
+  size_ -= batch.size();
+
+  for (Callback& callback : callbacks) {
+    callback();
+  }
+  return callbacks.size();
+}
+
+template <typename Callback>
+void TimerQueue<Callback>::place(size_t timer) {
+  Timer& slot = timers_[timer];
+  if (slot.deadline <= now_) {
+    link(timer, DUE_LIST);
+    return;
+  }
+
+  // The level is the highest group of SLOT_BITS bits in which the deadline
+  // differs from now_.  The deadline then falls in a later slot of the
+  // current turn of that wheel.
+  size_t level = (std::bit_width(slot.deadline ^ now_) - 1) / SLOT_BITS;
+  if (level >= LEVELS) {
+    slot.list = IN_HEAP;
+    heap_.insert(HeapEntry{slot.deadline, timer, slot.generation});
+  } else {
+    link(timer, level * SLOTS + slotOf(slot.deadline, level));
+  }
+}
+
+template <typename Callback>
+void TimerQueue<Callback>::link(size_t timer, size_t list) {
+  Timer& slot = timers_[timer];
+  slot.list = list;
+  slot.prev = NONE;
+  slot.next = heads_[list];
+  if (slot.next != NONE) {
+    timers_[slot.next].prev = timer;
+  }
+  heads_[list] = timer;
+
+  if (list < DUE_LIST) {
+    occupied_[list / SLOTS] |= uint64_t{1} << (list % SLOTS);
+  }
+}
+
+template <typename Callback>
+void TimerQueue<Callback>::unlink(size_t timer) {
+  Timer& slot = timers_[timer];
+  if (slot.prev != NONE) {
+    timers_[slot.prev].next = slot.next;
+  } else {
+    heads_[slot.list] = slot.next;
+  }
+  if (slot.next != NONE) {
+    timers_[slot.next].prev = slot.prev;
+  }
+
+  if (slot.list < DUE_LIST && heads_[slot.list] == NONE) {
+    occupied_[slot.list / SLOTS] &= ~(uint64_t{1} << (slot.list % SLOTS));
+  }
+  slot.list = NONE;
+}
+
+template <typename Callback>
+std::vector<size_t> TimerQueue<Callback>::takeList(size_t list) {
+  std::vector<size_t> timers;
+  for (size_t timer = heads_[list]; timer != NONE;
+       timer = timers_[timer].next) {
+    timers_[timer].list = NONE;
+    timers.push_back(timer);
+  }
+  heads_[list] = NONE;
+
+  if (list < DUE_LIST) {
+    occupied_[list / SLOTS] &= ~(uint64_t{1} << (list % SLOTS));
+  }
+  return timers;
+}
+
+template <typename Callback>
+void TimerQueue<Callback>::release(size_t timer) {
+  Timer& slot = timers_[timer];
+  slot.callback = Callback();
+  ++slot.generation;
+  slot.list = FREE;
+  freeTimers_.push_back(timer);
+}
+
+template <typename Callback>
+void TimerQueue<Callback>::discardStaleEntries() {
+  while (!heap_.empty() &&
+         timers_[heap_.peakMin().timer].generation !=
+             heap_.peakMin().generation) {
+    heap_.deleteMin();
+    --staleEntries_;
+  }
+}
+
+template <typename Callback>
+void TimerQueue<Callback>::compactHeap() {
+  std::vector<HeapEntry> live;
+  for (const HeapEntry& entry : heap_) {
+    if (timers_[entry.timer].generation == entry.generation) {
+      live.push_back(entry);
+    }
+  }
+
+  // The bulk constructor rebuilds the heap in linear time
+  MinHeap<HeapEntry> rebuilt(live.begin(), live.end());
+  heap_.swap(rebuilt);
+  staleEntries_ = 0;
+}
+
+template <typename Callback>
+typename TimerQueue<Callback>::Tick TimerQueue<Callback>::nextEvent(
+    Tick limit) {
+  Tick next = limit;
+
+  // Find the next occupied slot in the current turn of each wheel.  Slots
+  // before the current one are always empty, since each timer is placed in a
+  // later slot and we empty a slot as soon as time reaches it.
+  for (size_t level = 0; level < LEVELS; ++level) {
+    size_t current = slotOf(now_, level);
+    uint64_t later =
+        current + 1 < SLOTS ? occupied_[level] >> (current + 1) : 0;
+    if (later != 0) {
+      size_t slot = current + 1 + std::countr_zero(later);
+      size_t turnBits = (level + 1) * SLOT_BITS;
+      Tick turnStart = now_ >> turnBits << turnBits;
+      next = std::min(next, turnStart + (Tick{slot} << (level * SLOT_BITS)));
+    }
+  }
+
+  // The next timer in heap_ matters once time reaches its turn of the top
+  // wheel
+  discardStaleEntries();
+  if (!heap_.empty()) {
+    Tick turnStart = heap_.peakMin().deadline >> WHEEL_BITS << WHEEL_BITS;
+    next = std::min(next, turnStart);
+  }
+  return next;
+}
+
+template <typename Callback>
+size_t TimerQueue<Callback>::slotOf(Tick time, size_t level) {
+  return (time >> (level * SLOT_BITS)) % SLOTS;
+}
@@ -0,0 +1,152 @@
+/**
+ * \file timerqueue-test.cpp
+ * \copyright Matthew Calligaro
+ * \date January 2020
+ * \brief An assortment of ad hoc tests for the TimerQueue class
+ * \note These tests are not comprehensive and are NOT a good example of unit
+ * testing
+ */
+
+#include <cassert>
+#include <cstdint>
+#include <iostream>
+#include <map>
+#include <random>
+#include <vector>
+#include "timerqueue.hpp"
+
+/**
+ * \brief Runs several ad hoc tests of TimerQueue methods
+ */
+void coreTest() {
+  TimerQueue<> timers;
+  std::vector<int> fired;
+  assert(timers.empty() && timers.now() == 0);
+
+  timers.schedule(30, [&] { fired.push_back(30); });
+  timers.schedule(10, [&] { fired.push_back(10); });
+  TimerQueue<>::Handle h20 = timers.schedule(20, [&] { fired.push_back(20); });
+  timers.schedule(5000, [&] { fired.push_back(5000); });
+  assert(timers.size() == 4);
+
+  // Nothing is due yet
+  assert(timers.advanceTo(9) == 0 && fired.empty());
+
+  // Cancelling works once, and a cancelled timer never fires
+  assert(timers.cancel(h20) && !timers.cancel(h20));
+  assert(timers.size() == 3);
+  assert(timers.advanceTo(30) == 2);
+  assert((fired == std::vector<int>{10, 30}));
+
+  // A fired timer cannot be cancelled, and its Handle stays stale even once
+  // its slot is reused
+  TimerQueue<>::Handle h40 = timers.schedule(40, [&] { fired.push_back(40); });
+  assert(timers.advanceTo(40) == 1 && !timers.cancel(h40));
+  timers.schedule(50, [&] { fired.push_back(50); });
+  assert(!timers.cancel(h40) && timers.size() == 2);
+
+  // A deadline in the past fires on the next advanceTo, even without moving
+  // time forward
+  timers.schedule(1, [&] { fired.push_back(1); });
+  assert(timers.advanceTo(timers.now()) == 1 && fired.back() == 1);
+
+  // A callback can schedule more timers, but time has already moved on, so
+  // a timer which is already due waits for the next advanceTo
+  timers.schedule(60, [&] {
+    fired.push_back(60);
+    timers.schedule(70, [&] { fired.push_back(70); });
+  });
+  assert(timers.advanceTo(100) == 2 && timers.size() == 2);
+  assert((fired == std::vector<int>{10, 30, 40, 1, 50, 60}));
+  assert(timers.advanceTo(5000) == 2 && timers.empty());
+  assert(fired[6] == 70 && fired[7] == 5000);
+
+  // A default Handle never matches a timer
+  assert(!timers.cancel(TimerQueue<>::Handle()));
+}
+
+/**
+ * \brief Checks timers far beyond the wheels, which wait in the MinHeap
+ */
+void farTest() {
+  const uint64_t FAR = uint64_t{1} << 40;
+  TimerQueue<> timers(1000);
+  int fired = 0;
+  timers.schedule(FAR + 7, [&] { ++fired; });
+  TimerQueue<>::Handle cancelled = timers.schedule(FAR, [&] { fired += 100; });
+  timers.schedule(FAR * 3, [&] { ++fired; });
+
+  assert(timers.cancel(cancelled));
+  assert(timers.advanceTo(FAR + 6) == 0 && fired == 0);
+  assert(timers.advanceTo(FAR + 7) == 1 && fired == 1);
+  assert(timers.advanceTo(FAR * 3 - 1) == 0);
+  assert(timers.advanceTo(UINT64_MAX) == 1 && fired == 2 && timers.empty());
+}
+
+/**
+ * \brief Compares a TimerQueue against a std::multimap over random operations
+ * \details Deadlines are spread over every level of the wheels and the
+ * MinHeap, and time moves forward in steps of very different sizes.
+ */
+void randomTest() {
+  const size_t OPERATIONS = 200000;
+  std::default_random_engine engine(2020);
+  std::uniform_int_distribution<int> choices(0, 9);
+  std::uniform_int_distribution<int> bits(0, 30);
+
+  TimerQueue<> timers;
+  std::multimap<uint64_t, size_t> expected;
+  std::vector<TimerQueue<>::Handle> handles;
+  std::vector<uint64_t> deadlines;
+  std::vector<size_t> fired;
+
+  for (size_t i = 0; i < OPERATIONS; ++i) {
+    int choice = choices(engine);
+    uint64_t distance = engine() % (uint64_t{1} << bits(engine));
+    if (choice < 6) {
+      size_t id = deadlines.size();
+      uint64_t deadline = timers.now() + distance;
+      deadlines.push_back(deadline);
+      handles.push_back(
+          timers.schedule(deadline, [&fired, id] { fired.push_back(id); }));
+      expected.insert({deadline, id});
+    } else if (choice < 9 && !handles.empty()) {
+      size_t id = engine() % handles.size();
+      bool pending = false;
+      auto range = expected.equal_range(deadlines[id]);
+      for (auto it = range.first; it != range.second; ++it) {
+        if (it->second == id) {
+          pending = true;
+          expected.erase(it);
+          break;
+        }
+      }
+      assert(timers.cancel(handles[id]) == pending);
+    } else {
+      // Every timer due by the new time fires, in order of deadline
+      uint64_t time = timers.now() + distance / 64;
+      fired.clear();
+      size_t count = timers.advanceTo(time);
+      assert(count == fired.size());
+      for (size_t j = 0; j < fired.size(); ++j) {
+        assert(deadlines[fired[j]] <= time);
+        assert(j == 0 || deadlines[fired[j - 1]] <= deadlines[fired[j]]);
+      }
+      while (!expected.empty() && expected.begin()->first <= time) {
+        expected.erase(expected.begin());
+        --count;
+      }
+      assert(count == 0);
+    }
+    assert(timers.size() == expected.size());
+  }
+}
+
+int main() {
+  coreTest();
+  farTest();
+  randomTest();
+
+  std::cout << "All tests passed" << std::endl;
+  return 0;
+}
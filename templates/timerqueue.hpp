@@ -0,0 +1,289 @@
+/**
+ * \file timerqueue.hpp
+ * \copyright Matthew Calligaro
+ * \date January 2020
+ * \brief Declares the TimerQueue class
+ */
+
+#ifndef TEMPLATES_TIMERQUEUE_HPP_
+#define TEMPLATES_TIMERQUEUE_HPP_
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+#include "minheap.hpp"
+
+/**
+ * \class TimerQueue
+ * \brief A queue of callbacks, each of which fires once the time reaches its
+ * deadline
+ * \details Time is measured in integer ticks and only moves forward when
+ * advanceTo is called.  Timers which are due soon are kept in a hierarchical
+ * timing wheel: LEVELS wheels of SLOTS slots each, where a slot of level 0
+ * holds the timers for a single tick and a slot of each higher level covers
+ * a whole turn of the level below it.  As time reaches a slot of a higher
+ * level, its timers are moved down into the lower levels, so scheduling and
+ * firing a near-term timer take constant time.  Timers which are further
+ * away than a turn of the top wheel wait in a MinHeap until time catches up
+ * with them.
+ *
+ * Every timer sits in a doubly-linked list (one per slot), so cancelling a
+ * timer in the wheel just unlinks it.  A timer in the MinHeap cannot be
+ * removed cheaply, so instead it is cancelled lazily: each timer slot has a
+ * generation, which increases whenever the slot is reused, and a MinHeap
+ * entry whose generation is out of date is skipped.
+ * \note The template type Callback must support the default constructor,
+ * the move constructor, move assignment, and operator() with no arguments
+ */
+template <typename Callback = std::function<void()>>
+class TimerQueue {
+ public:
+  /** \brief The type used to measure time */
+  using Tick = uint64_t;
+
+  /**
+   * \struct Handle
+   * \brief Identifies a scheduled timer, so that it can be cancelled
+   * \details A Handle stays valid after its timer fires or is cancelled, at
+   * which point cancel simply returns false.
+   */
+  struct Handle {
+    /** \brief The index of the timer in timers_ */
+    size_t timer = NONE;
+
+    /** \brief The generation of the timer when it was scheduled */
+    uint64_t generation = 0;
+  };
+
+  /**
+   * \brief Creates an empty TimerQueue whose time is 0
+   * \note Run time: constant
+   */
+  TimerQueue();
+
+  /**
+   * \brief Creates an empty TimerQueue
+   * \param start   The current time
+   * \note Run time: constant
+   */
+  explicit TimerQueue(Tick start);
+
+  // A Handle refers to a timer by its index, which would be ambiguous for a
+  // copy, so we disable copying
+  TimerQueue(const TimerQueue& other) = delete;
+  TimerQueue& operator=(const TimerQueue& other) = delete;
+
+  /**
+   * \brief Returns the current time
+   * \return The time passed to the last call to advanceTo
+   * \note Run time: constant
+   */
+  Tick now() const;
+
+  /**
+   * \brief Returns the number of timers which have not fired or been
+   * cancelled
+   * \return The number of pending timers
+   * \note Run time: constant
+   */
+  size_t size() const;
+
+  /**
+   * \brief Returns whether the TimerQueue has no pending timers
+   * \return True if size() is 0
+   * \note Run time: constant
+   */
+  bool empty() const;
+
+  /**
+   * \brief Schedules a callback to fire once the time reaches a deadline
+   * \param deadline  The time at which to fire the callback
+   * \param callback  The callback to fire
+   * \return A Handle with which to cancel the timer
+   * \note Run time: constant if deadline is within one turn of the top
+   * wheel, otherwise amortized logarithmic in the number of timers
+   * \note A deadline which has already passed fires on the next call to
+   * advanceTo
+   */
+  Handle schedule(Tick deadline, Callback callback);
+
+  /**
+   * \brief Cancels a timer, so that its callback never fires
+   * \param handle  The Handle returned when the timer was scheduled
+   * \return True if the timer was pending, false if it had already fired or
+   * been cancelled
+   * \note Run time: amortized constant
+   */
+  bool cancel(Handle handle);
+
+  /**
+   * \brief Moves the time forward, firing every timer which is now due
+   * \param time  The new time, which is ignored if it is in the past
+   * \return The number of callbacks fired
+   * \note Run time: linear in the number of timers fired and moved between
+   * levels, plus logarithmic in the number of timers for each one that
+   * leaves the MinHeap
+   * \note Every due timer is removed before any callback runs, and then the
+   * callbacks run in order of deadline.  A callback may schedule or cancel
+   * timers, but cancelling a timer from the same batch has no effect.
+   */
+  size_t advanceTo(Tick time);
+
+ private:
+  /** \brief Stands for "no timer" in the linked lists and Handles */
+  static constexpr size_t NONE = SIZE_MAX;
+
+  /** \brief The number of bits of a deadline covered by one wheel */
+  static constexpr size_t SLOT_BITS = 6;
+
+  /** \brief The number of slots in each wheel */
+  static constexpr size_t SLOTS = size_t{1} << SLOT_BITS;
+
+  /** \brief The number of wheels */
+  static constexpr size_t LEVELS = 4;
+
+  /** \brief The number of bits of a deadline covered by all of the wheels */
+  static constexpr size_t WHEEL_BITS = LEVELS * SLOT_BITS;
+
+  /** \brief The list for timers whose deadline has already passed */
+  static constexpr size_t DUE_LIST = LEVELS * SLOTS;
+
+  /** \brief The list value of a timer which is waiting in heap_ */
+  static constexpr size_t IN_HEAP = DUE_LIST + 1;
+
+  /** \brief The list value of a timer slot which is not in use */
+  static constexpr size_t FREE = DUE_LIST + 2;
+
+  /** \brief The fewest stale entries in heap_ for which we rebuild it */
+  static constexpr size_t MIN_COMPACTION = 64;
+
+  /**
+   * \struct Timer
+   * \brief A timer slot, which is reused once its timer fires or is cancelled
+   */
+  struct Timer {
+    Tick deadline = 0;
+    Callback callback;
+    uint64_t generation = 0;
+
+    /** \brief The list this timer is in, or IN_HEAP, FREE, or NONE */
+    size_t list = FREE;
+
+    /** \brief The neighbors of this timer in its list */
+    size_t prev = NONE;
+    size_t next = NONE;
+  };
+
+  /**
+   * \struct HeapEntry
+   * \brief A timer waiting in heap_, which is stale if the generation of its
+   * timer has moved on
+   */
+  struct HeapEntry {
+    Tick deadline;
+    size_t timer;
+    uint64_t generation;
+
+    bool operator<(const HeapEntry& rhs) const;
+    bool operator==(const HeapEntry& rhs) const;
+  };
+
+  /** \brief The current time */
+  Tick now_;
+
+  /** \brief The number of pending timers */
+  size_t size_;
+
+  /** \brief Every timer slot, in use or not */
+  std::vector<Timer> timers_;
+
+  /** \brief The indices of the timer slots which are not in use */
+  std::vector<size_t> freeTimers_;
+
+  /** \brief The first timer in each slot of each wheel, then in DUE_LIST */
+  std::array<size_t, DUE_LIST + 1> heads_;
+
+  /** \brief One bit per slot of each wheel, set if the slot has timers */
+  std::array<uint64_t, LEVELS> occupied_;
+
+  /** \brief The timers too far in the future for the wheels */
+  MinHeap<HeapEntry> heap_;
+
+  /** \brief The number of entries in heap_ whose timers were cancelled */
+  size_t staleEntries_;
+
+  /**
+   * \brief Puts a timer in the due list, a wheel, or heap_, according to how
+   * far its deadline is from now_
+   * \param timer   The index of the timer
+   * \note Run time: constant, or amortized logarithmic if the timer goes
+   * into heap_
+   */
+  void place(size_t timer);
+
+  /**
+   * \brief Adds a timer to the front of a list
+   * \param timer   The index of the timer
+   * \param list    The list to which to add it
+   * \note Run time: constant
+   */
+  void link(size_t timer, size_t list);
+
+  /**
+   * \brief Removes a timer from its list
+   * \param timer   The index of the timer
+   * \note Run time: constant
+   */
+  void unlink(size_t timer);
+
+  /**
+   * \brief Removes every timer from a list
+   * \param list    The list to empty
+   * \return The indices of the timers which were in the list
+   * \note Run time: linear in the length of the list
+   */
+  std::vector<size_t> takeList(size_t list);
+
+  /**
+   * \brief Frees a timer slot for reuse, which makes its Handles stale
+   * \param timer   The index of the timer
+   * \note Run time: constant
+   */
+  void release(size_t timer);
+
+  /**
+   * \brief Removes stale entries from the top of heap_
+   * \note Run time: logarithmic in the size of heap_ per entry removed
+   */
+  void discardStaleEntries();
+
+  /**
+   * \brief Rebuilds heap_ without its stale entries
+   * \note Run time: linear in the size of heap_
+   */
+  void compactHeap();
+
+  /**
+   * \brief Finds the next time at which a slot of a wheel, or the top of
+   * heap_, needs attention
+   * \param limit   The latest time to return
+   * \return The earliest such time after now_, or limit if it is sooner
+   * \note Run time: constant, plus discarding stale entries from heap_
+   */
+  Tick nextEvent(Tick limit);
+
+  /**
+   * \brief Returns which slot of a wheel a time falls in
+   * \param time    The time
+   * \param level   The level of the wheel
+   * \return The index of the slot
+   * \note Run time: constant
+   */
+  static size_t slotOf(Tick time, size_t level);
+};
+
+#include "timerqueue-private.hpp"
+
+#endif  // TEMPLATES_TIMERQUEUE_HPP_